@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include "buffer.h"
+
+/*
+* Programa de medida del rendimiento de la implementación sin regiones
+* críticas. Utiliza el mismo Buffer y la misma espera activa que 'main.c', pero
+* sin tiempos de producción ni mensajes por pantalla, y recorre
+* todas las combinaciones de productores, consumidores y tamaños de buffer
+* indicadas. Para cada una se imprime una línea CSV con las operaciones por
+* segundo y los percentiles 50, 99 y 99.9 de la latencia de entrega, medida
+* desde que el productor intenta acceder a la región crítica hasta que un
+* consumidor saca el elemento.
+*/
+
+// Nombre de la implementación que aparece en el CSV
+#define IMPLEMENTACION "0RegionesCriticas"
+
+// Número de operaciones por configuración por defecto
+#define OPERACIONES 200000
+
+// Número máximo de valores en cada lista de la línea de comandos
+#define MAX_LISTA 16
+
+// Número de intentos fallidos consecutivos sobre el buffer a partir de los
+// cuales el hilo deja de ceder la CPU y pasa a dormir brevemente
+#define INTENTOS_ESPERA 64
+
+// Tiempo (en microsegundos) que duerme un hilo una vez superados los
+// INTENTOS_ESPERA
+#define TIEMPO_ESPERA 100
+
+// Estructura con la información de cada hilo de la medida
+typedef struct ST_HILOBENCH{
+  // TID del hilo
+  pthread_t tid;
+
+  // Primer item que produce el hilo (solo productores)
+  int primero;
+
+  // Número de items que produce el hilo (solo productores)
+  int numItems;
+} HiloBench;
+
+// Buffer compartido por productores y consumidores, igual al de 'main.c'
+Buffer buffer;
+
+// Instante (en nanosegundos) en el que se produjo cada item y latencia con la
+// que fue consumido. Cada item es su propio índice en estos arrays
+uint64_t* marcas;
+uint64_t* latencias;
+
+/*
+* Función que devuelve el instante actual en nanosegundos, según el reloj
+* monótono del sistema
+*/
+static inline uint64_t ahora();
+
+/*
+* Funciones asociadas a los hilos productores y consumidores
+*/
+void productor(HiloBench* hilo);
+void consumidor(HiloBench* hilo);
+
+/*
+* Función de espera para los hilos que han encontrado el buffer lleno o vacío,
+* igual a la de 'main.c'
+*/
+void esperar(unsigned int* intentos);
+
+/*
+* Función que realiza una medida con la configuración indicada e imprime su
+* línea CSV
+*/
+void medir(int numProductores, int numConsumidores, int tam, int operaciones);
+
+/*
+* Función que lee una lista de enteros positivos separados por comas. Devuelve
+* el número de valores leídos, o 0 si la lista no es válida
+*/
+int leerLista(char* texto, int* valores);
+
+/*
+* Función de comparación para ordenar las latencias con qsort
+*/
+int compararLatencias(const void* a, const void* b);
+
+int main(int argc, char *argv[]){
+  int productores[MAX_LISTA] = {1, 2, 4, 8};
+  int consumidores[MAX_LISTA] = {1, 2, 4, 8};
+  int tamanos[MAX_LISTA] = {16, 1024};
+  int numProductores = 4, numConsumidores = 4, numTamanos = 2;
+  int operaciones = OPERACIONES;
+  int opcion;
+  int p, c, t;
+
+  while((opcion = getopt(argc, argv, "hn:p:c:t:")) != -1){
+    switch(opcion){
+      case 'h':
+      printf("Modo de uso: %s [-n operaciones] [-p productores] "
+             "[-c consumidores] [-t tamaños]\n"
+             "\t-> operaciones: items transferidos en cada medida (por "
+                  "defecto %d)\n"
+             "\t-> productores, consumidores y tamaños: listas separadas por "
+                  "comas (por defecto 1,2,4,8 / 1,2,4,8 / 16,1024)\n",
+                  argv[0], OPERACIONES);
+      exit(EXIT_SUCCESS);
+      break;
+
+      case 'n':
+      operaciones = atoi(optarg);
+      if(operaciones < 1){
+        fprintf(stderr, "[!] El número de operaciones debe ser positivo\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      case 'p':
+      numProductores = leerLista(optarg, productores);
+      break;
+
+      case 'c':
+      numConsumidores = leerLista(optarg, consumidores);
+      break;
+
+      case 't':
+      numTamanos = leerLista(optarg, tamanos);
+      break;
+
+      default:
+      fprintf(stderr, "Utiliza %s -h para ver el modo de uso\n", argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if(numProductores == 0 || numConsumidores == 0 || numTamanos == 0){
+    fprintf(stderr, "[!] Las listas deben contener enteros positivos separados"
+                    " por comas\n");
+    exit(EXIT_FAILURE);
+  }
+
+  marcas = (uint64_t*) malloc(sizeof(uint64_t) * operaciones);
+  latencias = (uint64_t*) malloc(sizeof(uint64_t) * operaciones);
+
+  printf("implementacion,productores,consumidores,tam,lote,operaciones,"
+         "segundos,ops_seg,p50_ns,p99_ns,p999_ns\n");
+
+  for(t = 0; t < numTamanos; t++){
+    for(p = 0; p < numProductores; p++){
+      for(c = 0; c < numConsumidores; c++){
+        medir(productores[p], consumidores[c], tamanos[t], operaciones);
+      }
+    }
+  }
+
+  free(marcas);
+  free(latencias);
+
+  exit(EXIT_SUCCESS);
+}
+
+void medir(int numProductores, int numConsumidores, int tam, int operaciones){
+  HiloBench* productores;
+  HiloBench* consumidores;
+  uint64_t inicio, fin;
+  double segundos;
+  int i, primero;
+
+  productores = (HiloBench*) malloc(sizeof(HiloBench) * numProductores);
+  consumidores = (HiloBench*) malloc(sizeof(HiloBench) * numConsumidores);
+
+  buffer = crearBuffer(tam);
+
+  // Las operaciones se reparten entre los productores, que se registran en el
+  // buffer igual que en 'main.c'
+  registrarProductores(&buffer, numProductores);
+
+  inicio = ahora();
+
+  primero = 0;
+  for(i = 0; i < numProductores; i++){
+    productores[i].primero = primero;
+    productores[i].numItems = operaciones / numProductores +
+                              (i < operaciones % numProductores);
+    primero += productores[i].numItems;
+    pthread_create(&(productores[i].tid), NULL, (void*)productor,
+                   productores+i);
+  }
+
+  for(i = 0; i < numConsumidores; i++){
+    pthread_create(&(consumidores[i].tid), NULL, (void*)consumidor,
+                   consumidores+i);
+  }
+
+  for(i = 0; i < numProductores; i++){
+    pthread_join(productores[i].tid, NULL);
+  }
+  for(i = 0; i < numConsumidores; i++){
+    pthread_join(consumidores[i].tid, NULL);
+  }
+
+  fin = ahora();
+  segundos = (fin - inicio) / 1e9;
+
+  qsort(latencias, operaciones, sizeof(uint64_t), compararLatencias);
+
+  printf("%s,%d,%d,%d,%d,%d,%.6f,%.0f,%lu,%lu,%lu\n",
+         IMPLEMENTACION, numProductores, numConsumidores, tam, 1, operaciones, segundos, operaciones / segundos,
+         (unsigned long)latencias[(operaciones - 1) * 50 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 99 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 999 / 1000]);
+  fflush(stdout);
+
+  destruirBuffer(&buffer);
+  free(productores);
+  free(consumidores);
+}
+
+void productor(HiloBench* hilo){
+  int i, item;
+  unsigned int intentos;
+
+  for(i = 0; i < hilo->numItems; i++){
+    item = hilo->primero + i;
+    marcas[item] = ahora();
+
+    intentos = 0;
+    while(!insertarBuffer(&buffer, item)){
+      esperar(&intentos);
+    }
+  }
+  terminarProductor(&buffer);
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidor(HiloBench* hilo){
+  int item, obtenido;
+  unsigned int intentos;
+
+  while(1){
+    intentos = 0;
+    while(!(obtenido = sacarBuffer(&buffer, &item)) &&
+          !bufferAgotado(&buffer)){
+      esperar(&intentos);
+    }
+
+    if(!obtenido){
+      break;
+    }
+
+    latencias[item] = ahora() - marcas[item];
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void esperar(unsigned int* intentos){
+  if(*intentos < INTENTOS_ESPERA){
+    sched_yield();
+    (*intentos)++;
+  } else {
+    usleep(TIEMPO_ESPERA);
+  }
+}
+
+static inline uint64_t ahora(){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+int leerLista(char* texto, int* valores){
+  char* elemento;
+  int n = 0;
+
+  for(elemento = strtok(texto, ","); elemento != NULL;
+      elemento = strtok(NULL, ",")){
+    if(n == MAX_LISTA || atoi(elemento) < 1){
+      return 0;
+    }
+    valores[n++] = atoi(elemento);
+  }
+
+  return n;
+}
+
+int compararLatencias(const void* a, const void* b){
+  uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
@@ -0,0 +1,173 @@
+#include "buffer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+Buffer crearBuffer(unsigned int tam){
+	// Buffer a devolver al usuario
+	Buffer buf;
+	unsigned int i;
+
+	// Se asigna al buffer el tamaño correspondiente
+	buf.tam = tam;
+
+	// Se reserva memoria para las celdas del buffer
+	buf.celdas = (Celda*) malloc(sizeof(Celda) * tam);
+
+	// Cada celda empieza con su propia posición como número de secuencia, lo que
+	// indica que está libre para el productor que reclame esa posición
+	for(i = 0; i < tam; i++){
+		atomic_init(&buf.celdas[i].secuencia, i);
+		buf.celdas[i].valor = -1;
+	}
+
+	// Los contadores empiezan en 0 y nunca se reinician
+	atomic_init(&buf.final, 0);
+	atomic_init(&buf.inicio, 0);
+
+	// El buffer empieza abierto y sin productores registrados
+	atomic_init(&buf.productoresActivos, 0);
+	atomic_init(&buf.cerrado, 0);
+
+	// Se retorna el buffer al usuario
+	return buf;
+}
+
+void destruirBuffer(Buffer* buf){
+	if(buf != NULL && buf->celdas != NULL){
+		free(buf->celdas);
+		buf->celdas = NULL;
+		buf->tam = 0;
+	}
+}
+
+int insertarBuffer(Buffer* buffer, int valor){
+	Celda* celda;
+	unsigned long posicion, secuencia;
+	long diferencia;
+
+	posicion = atomic_load_explicit(&buffer->final, memory_order_relaxed);
+
+	while(1){
+		celda = &buffer->celdas[posicion % buffer->tam];
+		secuencia = atomic_load_explicit(&celda->secuencia, memory_order_acquire);
+		diferencia = (long)secuencia - (long)posicion;
+
+		if(diferencia == 0){
+			// La celda está libre para esta posición: se intenta reclamarla. Si otro
+			// productor se adelanta, 'posicion' se actualiza con el valor actual y se
+			// vuelve a intentar
+			if(atomic_compare_exchange_weak_explicit(&buffer->final, &posicion,
+					posicion + 1, memory_order_relaxed, memory_order_relaxed)){
+				break;
+			}
+		} else if(diferencia < 0){
+			// La celda todavía contiene un valor de la vuelta anterior que no ha sido
+			// consumido, por lo que el buffer está lleno
+			return 0;
+		} else {
+			// Otro productor ya ha reclamado esta posición
+			posicion = atomic_load_explicit(&buffer->final, memory_order_relaxed);
+		}
+	}
+
+	// Se escribe el valor y se publica para el consumidor de esta posición
+	celda->valor = valor;
+	atomic_store_explicit(&celda->secuencia, posicion + 1, memory_order_release);
+
+	return 1;
+}
+
+int sacarBuffer(Buffer* buffer, int* valor){
+	Celda* celda;
+	unsigned long posicion, secuencia;
+	long diferencia;
+
+	posicion = atomic_load_explicit(&buffer->inicio, memory_order_relaxed);
+
+	while(1){
+		celda = &buffer->celdas[posicion % buffer->tam];
+		secuencia = atomic_load_explicit(&celda->secuencia, memory_order_acquire);
+		diferencia = (long)secuencia - (long)(posicion + 1);
+
+		if(diferencia == 0){
+			// La celda contiene el valor de esta posición: se intenta reclamarla
+			if(atomic_compare_exchange_weak_explicit(&buffer->inicio, &posicion,
+					posicion + 1, memory_order_relaxed, memory_order_relaxed)){
+				break;
+			}
+		} else if(diferencia < 0){
+			// El productor de esta posición todavía no ha publicado el valor, por lo
+			// que el buffer está vacío
+			return 0;
+		} else {
+			// Otro consumidor ya ha reclamado esta posición
+			posicion = atomic_load_explicit(&buffer->inicio, memory_order_relaxed);
+		}
+	}
+
+	// Se lee el valor y se deja la celda libre para el productor de la siguiente
+	// vuelta, cuya posición será 'tam' posiciones más adelante
+	*valor = celda->valor;
+	atomic_store_explicit(&celda->secuencia, posicion + buffer->tam,
+			memory_order_release);
+
+	return 1;
+}
+
+int tamano(Buffer* buffer){
+	return buffer->tam;
+}
+
+void registrarProductores(Buffer* buffer, int numProductores){
+	// Los productores se registran antes de empezar, por lo que el incremento
+	// no necesita ordenar ningún otro acceso
+	atomic_fetch_add_explicit(&buffer->productoresActivos, numProductores,
+			memory_order_relaxed);
+}
+
+int terminarProductor(Buffer* buffer){
+	// El decremento libera las inserciones del productor y adquiere las de los
+	// que terminaron antes, de forma que el cierre las publica todas
+	if(atomic_fetch_sub_explicit(&buffer->productoresActivos, 1,
+			memory_order_acq_rel) != 1){
+		return 0;
+	}
+
+	cerrarBuffer(buffer);
+	return 1;
+}
+
+void cerrarBuffer(Buffer* buffer){
+	atomic_store_explicit(&buffer->cerrado, 1, memory_order_release);
+}
+
+int bufferCerrado(Buffer* buffer){
+	return atomic_load_explicit(&buffer->cerrado, memory_order_acquire);
+}
+
+int bufferAgotado(Buffer* buffer){
+	// El cierre se consulta antes que los contadores. Todos los productores han
+	// publicado las posiciones que reclamaron antes de terminar, por lo que si
+	// los consumidores ya han reclamado todas no queda ningún valor
+	return bufferCerrado(buffer) && numElementos(buffer) == 0;
+}
+
+int numElementos(Buffer* buffer){
+	unsigned long inicio, final;
+	long elementos;
+
+	inicio = atomic_load(&buffer->inicio);
+	final = atomic_load(&buffer->final);
+
+	// Los contadores se leen en momentos distintos, por lo que el resultado se
+	// limita al rango válido
+	elementos = (long)(final - inicio);
+	if(elementos < 0){
+		elementos = 0;
+	} else if(elementos > buffer->tam){
+		elementos = buffer->tam;
+	}
+
+	return (int)elementos;
+}
@@ -0,0 +1,221 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#include <stdatomic.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Buffer tiene a su disposición tantos elementos de tipo 'int' como se
+* indiquen en su constructor. Se devolverá una variable de tipo Buffer que
+* cuando deje de ser necesaria, esta deberá de ser destruida con la función
+* 'destruirBuffer'
+*
+* A diferencia de las implementaciones con regiones críticas, este buffer puede
+* ser utilizado simultáneamente por varios productores y varios consumidores
+* sin necesidad de mutexes: cada posición tiene un número de secuencia que
+* indica si está libre para el siguiente productor o lista para el siguiente
+* consumidor, y los hilos se reparten las posiciones mediante operaciones
+* atómicas 'compare and swap'.
+*/
+
+// Tamaño de una línea de caché. Los contadores de productores y consumidores
+// se separan en líneas distintas para que no se invaliden mutuamente
+#define TAM_LINEA_CACHE 64
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato auxiliar: una estructura tipo ST_CELDA
+* Campos:
+*		- secuencia: número de secuencia de la posición. Si coincide con el
+*								 contador de un productor, la posición está libre para él; si
+*								 coincide con el contador de un consumidor más uno, la
+*								 posición contiene el valor que le corresponde
+*		- valor: valor almacenado en la posición
+*/
+typedef struct ST_CELDA{
+	atomic_ulong secuencia;
+	int valor;
+} Celda;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_BUFFER
+* Campos:
+*		- celdas: variable que apunta a la primera posición del Buffer
+*		- tam: número de elementos que puede almacenar el buffer
+*		- final: número de inserciones reclamadas por los productores desde la
+*						 creación del buffer
+*		- inicio: número de extracciones reclamadas por los consumidores desde la
+*							creación del buffer
+*		- productoresActivos: número de productores registrados que aún no han
+*													terminado
+*		- cerrado: 1 si el buffer se ha cerrado y ya no se van a insertar más
+*							 elementos
+*
+* 'productoresActivos' y 'cerrado' están en la línea de los productores, que
+* son quienes los modifican, una única vez cada uno. Los consumidores solo
+* consultan 'cerrado' cuando no consiguen sacar ningún valor, por lo que sacar
+* un valor no modifica ningún contador compartido aparte de 'inicio'.
+*/
+typedef struct ST_BUFFER{
+	Celda* celdas;
+	unsigned int tam;
+	_Alignas(TAM_LINEA_CACHE) atomic_ulong final;
+	atomic_int productoresActivos;
+	atomic_int cerrado;
+	_Alignas(TAM_LINEA_CACHE) atomic_ulong inicio;
+} Buffer;
+
+/*
+* ---------------------------MODIFICACIÓN DE VARIABLES--------------------------
+*	- Variable  inicio: se incrementa atómicamente en la función 'sacarBuffer'
+*
+*	- Variable   final: se incrementa atómicamente en la función 'insertarBuffer'
+*
+*	- Array de celdas : el valor y la secuencia de una celda solo los modifica el
+*											hilo que ha reclamado la posición con éxito.
+*
+*	- Productores     : se registran con 'registrarProductores' y cada uno lo
+*											decrementa atómicamente en 'terminarProductor'.
+*
+*	- Cerrado         : lo activa el último productor en terminar, o
+*											'cerrarBuffer'.
+*/
+
+
+/*
+* Nombre: crearBuffer
+* Tipo: constructor
+* Constructor del buffer a partir del tamaño de este.
+*
+* Precondición : el tamaño indicado debe ser mayor a 0
+* Postcondición: el usuario recibe una variable tipo Buffer del tamaño indicado
+*								 cuyos valores están vacíos.
+*/
+Buffer crearBuffer(unsigned int tam);
+
+/*
+* Nombre: destruirBuffer
+* Tipo: destructor
+* Destructor del buffer, liberando los recursos correspondientes
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+*								 y ningún hilo debe estar usándolo.
+* Postcondición: la memoria reservada para las celdas del Buffer es liberada y
+*								 la variable 'celdas' se pone a NULL.
+*/
+void destruirBuffer(Buffer* buf);
+
+/*
+* Nombre: insertarBuffer
+* Tipo: modificador
+* Función que inserta el valor indicado por parámetro en la primera posición
+* libre del buffer, en caso de que el buffer esté lleno se descarta la inserción
+*
+* Puede ser llamada por varios productores a la vez sin exclusión mutua.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
+*	Postcondición: se devuelve un 1 si el valor ha sido insertado y un 0 en caso
+*								 de que el buffer estuviese lleno.
+*/
+int insertarBuffer(Buffer* buffer, int valor);
+
+/*
+* Nombre: sacarBuffer
+* Tipo: modificador
+*	Función que permite sacar del buffer el primer elemento insertado,
+* almacenándolo en la variable apuntada por 'valor'.
+*
+* Puede ser llamada por varios consumidores a la vez sin exclusión mutua.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
+* Postcondición: se devuelve un 1 si se ha sacado un valor y un 0 en caso de
+*								 que el buffer estuviese vacío, sin modificar 'valor'.
+*/
+int sacarBuffer(Buffer* buffer, int* valor);
+
+/*
+* Nombre: tamano
+* Tipo: consulta
+* Función que devuelve el tamaño del buffer pasado por parámetro.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+* Postcondición: le es devuelto al usuario el tamaño del buffer.
+*/
+int tamano(Buffer* buffer);
+
+/*
+* Nombre: registrarProductores
+* Tipo: modificador
+* Función que añade el número indicado de productores a los que el buffer debe
+* esperar antes de cerrarse. Cada productor registrado debe llamar una vez a
+* 'terminarProductor' cuando haya insertado todos sus elementos.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+*								 y ninguno de los productores registrados puede haber empezado
+*								 a insertar
+* Postcondición: el número de productores activos se ve incrementado en
+*								 'numProductores'
+*/
+void registrarProductores(Buffer* buffer, int numProductores);
+
+/*
+* Nombre: terminarProductor
+* Tipo: modificador
+* Función que indica que uno de los productores registrados ya ha insertado
+* todos sus elementos. El último productor en terminar cierra el buffer.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+*								 y el productor debe estar registrado
+* Postcondición: se devuelve 1 si era el último productor activo y el buffer ha
+*								 quedado cerrado, y 0 en caso contrario
+*/
+int terminarProductor(Buffer* buffer);
+
+/*
+* Nombre: cerrarBuffer
+* Tipo: modificador
+* Función que cierra el buffer sin esperar a los productores, por ejemplo para
+* detener el programa. Los elementos ya insertados se pueden seguir sacando.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+* Postcondición: el buffer queda cerrado
+*/
+void cerrarBuffer(Buffer* buffer);
+
+/*
+* Nombre: bufferCerrado
+* Tipo: consulta
+* Función que devuelve un 1 si el buffer está cerrado y un 0 en caso contrario.
+*
+* Todas las inserciones anteriores al cierre son visibles para el hilo que ve
+* el buffer cerrado, por lo que si después lo ve vacío ya no quedan elementos.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+* Postcondición: el valor devuelto es un 1 si el buffer está cerrado
+*/
+int bufferCerrado(Buffer* buffer);
+
+/*
+* Nombre: bufferAgotado
+* Tipo: consulta
+* Función que devuelve un 1 si el buffer está cerrado y vacío, es decir, si un
+* consumidor ya no va a poder sacar ningún elemento, y un 0 en caso contrario.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+* Postcondición: el valor devuelto es un 1 si el buffer está cerrado y vacío
+*/
+int bufferAgotado(Buffer* buffer);
+
+/*
+* Nombre: numElementos
+* Tipo: consulta
+* Función que devuelve el número de elementos que actualmente están en el
+* buffer. Al no existir exclusión mutua el valor es orientativo, ya que otros
+* hilos pueden estar insertando o sacando elementos a la vez.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
+* Postcondición: se devuelve el número de elementos del buffer, entre 0 y 'tam'
+*/
+int numElementos(Buffer* buffer);
+
+#endif
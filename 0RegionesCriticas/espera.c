@@ -0,0 +1,67 @@
+#include <unistd.h>
+#include "espera.h"
+
+void iniciarEsperaActiva(EsperaActiva* espera, unsigned int maximo){
+	if(sysconf(_SC_NPROCESSORS_ONLN) <= 1){
+		maximo = 0;
+	}
+
+	espera->maximo = maximo;
+	espera->presupuesto = maximo < ESPERA_MIN_PRESUPUESTO ? maximo :
+			ESPERA_MIN_PRESUPUESTO;
+	espera->exitos = 0;
+	espera->fracasos = 0;
+}
+
+int esperarActivamente(EsperaActiva* espera, CondicionEspera condicion,
+		const void* argumento){
+	unsigned int gastado = 0;
+	unsigned int pausas = 1;
+	unsigned int i;
+
+	if(espera->maximo == 0){
+		return 0;
+	}
+
+	while(gastado < espera->presupuesto){
+		if(condicion(argumento)){
+			// La espera ha merecido la pena, por lo que la siguiente puede ser más
+			// larga
+			espera->exitos++;
+			espera->presupuesto *= 2;
+			if(espera->presupuesto > espera->maximo){
+				espera->presupuesto = espera->maximo;
+			}
+			return 1;
+		}
+
+		for(i = 0; i < pausas; i++){
+			pausaCPU();
+		}
+		gastado += pausas;
+
+		if(pausas < ESPERA_MAX_PAUSAS){
+			pausas *= 2;
+		}
+	}
+
+	if(condicion(argumento)){
+		espera->exitos++;
+		return 1;
+	}
+
+	// El hilo va a dormir de todas formas, por lo que la siguiente espera se
+	// acorta
+	espera->fracasos++;
+	espera->presupuesto /= 2;
+	if(espera->presupuesto < ESPERA_MIN_PRESUPUESTO){
+		espera->presupuesto = espera->maximo < ESPERA_MIN_PRESUPUESTO ?
+				espera->maximo : ESPERA_MIN_PRESUPUESTO;
+	}
+
+	return 0;
+}
+
+int esperaActivaHabilitada(const EsperaActiva* espera){
+	return espera->maximo > 0;
+}
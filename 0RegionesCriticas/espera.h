@@ -0,0 +1,107 @@
+#ifndef ESPERA_H
+#define ESPERA_H
+
+#include <stdatomic.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD EsperaActiva permite a un hilo comprobar repetidamente una condición
+* durante un tiempo limitado antes de dormir en una variable de condición o en
+* un evento. Entre comprobaciones el hilo ejecuta instrucciones de pausa, cuyo
+* número se duplica en cada comprobación fallida (hasta ESPERA_MAX_PAUSAS) para
+* no saturar la línea de caché que se está consultando.
+*
+* El número total de pausas de cada espera (el presupuesto) se adapta a lo
+* ocurrido en las esperas anteriores del mismo hilo: se duplica cuando la
+* condición se cumple durante la espera y se reduce a la mitad cuando no, sin
+* bajar de ESPERA_MIN_PRESUPUESTO ni superar el máximo indicado. Así, con el
+* sistema cargado el hilo recibe el cambio sin dormir, y con el sistema ocioso
+* apenas consume CPU antes de dormir.
+*
+* Cada hilo debe utilizar su propia EsperaActiva, ya que no utiliza mutexes.
+*/
+
+// Presupuesto mínimo (en pausas) de una espera activa habilitada
+#define ESPERA_MIN_PRESUPUESTO 16
+
+// Número máximo de pausas entre dos comprobaciones de la condición
+#define ESPERA_MAX_PAUSAS 64
+
+// Presupuesto máximo por defecto (en pausas)
+#define ESPERA_MAX_DEFECTO 256
+
+/*
+* Función que indica a la CPU que el hilo está en una espera activa, de forma
+* que libere recursos para el otro hilo del núcleo y no especule sobre la
+* lectura que se está repitiendo
+*/
+static inline void pausaCPU(){
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#else
+	atomic_signal_fence(memory_order_seq_cst);
+#endif
+}
+
+// Tipo de las condiciones que se comprueban durante la espera activa. Deben
+// poder comprobarse sin ningún mutex
+typedef int (*CondicionEspera)(const void* argumento);
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_ESPERAACTIVA
+* Campos:
+*		- presupuesto: número máximo de pausas de la siguiente espera
+*		- maximo: límite del presupuesto. Si es 0 la espera activa está
+*							deshabilitada
+*		- exitos: número de esperas en las que se cumplió la condición
+*		- fracasos: número de esperas tras las que el hilo tuvo que dormir
+*/
+typedef struct ST_ESPERAACTIVA{
+	unsigned int presupuesto;
+	unsigned int maximo;
+	unsigned int exitos;
+	unsigned int fracasos;
+} EsperaActiva;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: iniciarEsperaActiva
+* Tipo: constructor
+* Función que inicia la espera activa con el presupuesto máximo indicado. Si el
+* sistema tiene una única CPU la espera activa se deshabilita, ya que el hilo
+* que debe cambiar la condición no puede ejecutarse mientras se espera.
+*
+* Precondición : ninguna
+* Postcondición: la espera activa puede ser utilizada
+*/
+void iniciarEsperaActiva(EsperaActiva* espera, unsigned int maximo);
+
+/*
+* Nombre: esperarActivamente
+* Tipo: modificador
+* Función que comprueba la condición indicada hasta que se cumpla o se agote el
+* presupuesto, y lo adapta según el resultado.
+*
+* Precondición : la espera debe haber sido iniciada con 'iniciarEsperaActiva'
+* Postcondición: se devuelve 1 si la condición se cumplió y 0 en caso contrario
+*/
+int esperarActivamente(EsperaActiva* espera, CondicionEspera condicion,
+		const void* argumento);
+
+/*
+* Nombre: esperaActivaHabilitada
+* Tipo: consulta
+* Función que indica si la espera activa está habilitada.
+*
+* Precondición : la espera debe haber sido iniciada con 'iniciarEsperaActiva'
+* Postcondición: se devuelve 1 si está habilitada y 0 en caso contrario
+*/
+int esperaActivaHabilitada(const EsperaActiva* espera);
+
+#endif
@@ -0,0 +1,686 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sched.h>
+#include "buffer.h"
+#include "configuracion.h"
+#include "registro.h"
+#include "espera.h"
+
+// Colores
+#define tblack "\E[30m" // Texto color negro
+#define tred "\E[31m" // Texto color rojo
+#define tgreen "\E[32m" // Texto color verde
+#define tyellow "\E[33m" // Texto color amarillo
+#define tblue "\E[34m" // Texto color azul
+#define tpurple "\E[35m" // Texto color morado
+#define tcyan "\E[36m" // Texto color cyan
+#define reset "\E[m" // Texto color blanco
+#define fpurple "\E[45m" // Fondo color morado
+
+// Tamaño que ocupa el string de la hora
+#define TAM_HORA 9
+
+// Opciones de la línea de comandos
+#define OPCIONES "b:c:hF:n:p:C:P:"
+
+// Número de intentos fallidos consecutivos sobre el buffer a partir de los
+// cuales el hilo deja de ceder la CPU y pasa a dormir brevemente
+#define INTENTOS_ESPERA 64
+
+// Tiempo (en microsegundos) que duerme un hilo una vez superados los
+// INTENTOS_ESPERA
+#define TIEMPO_ESPERA 100
+
+// Estructura utilizada para guardar la información de los Hilos Productores.
+typedef struct ST_HILOPROD{
+  // TID del hilo
+  pthread_t tid;
+
+  // Número de hilo, autoincremental
+  unsigned int id;
+
+  // Tiempo (en segundos) que el hilo va a tardar en realizar la producción
+  double tiempo;
+
+  // Tiempo (en segundos) que esperará el hilo después de insertar en el
+  // buffer. En caso de ser negativo se escogerá un aleatorio entre 0 y 4
+  double postProduccion;
+
+  // Número de producciones que va a realizar el hilo
+  unsigned int numProducciones;
+} HiloProductor;
+
+// Estructura utilizada para guardar la información de los Hilos Consumidores.
+typedef struct ST_HILOCONS{
+  // TID del hilo
+  pthread_t tid;
+
+  // Número de hilo, autoincremental
+  unsigned int id;
+
+  // Tiempo (en segundos) que el hilo va a tardar en realizar la consumición
+  double tiempo;
+
+  // Tiempo (en segundos) que esperará el hilo después de sacar del buffer. En
+  // caso de ser negativo se escogerá un aleatorio entre 0 y 4
+  double postConsumicion;
+} HiloConsumidor;
+
+// Variable Buffer que hará la labor de cola, donde los productores añadirán sus
+// producciones y donde los consumidores obtendrán sus consumiciones.
+//
+// El acceso al buffer no necesita de regiones críticas: productores y
+// consumidores se reparten las posiciones mediante operaciones atómicas
+Buffer buffer;
+
+/*
+* Función que crea los hilos productores correspondientes a partir de la
+* información pasada por parámetro.
+*
+* La variable numProductores indica el número de productores que componen el
+* array 'hilos'
+*/
+void crearProductores(HiloProductor* hilos, unsigned int numProductores);
+
+/*
+* Función que crea los hilos consumidores correspondientes a partir de la
+* información pasada por parámetro.
+*
+* La variable numConsumidores indica el número de consumidores que componen el
+* array 'hilos'
+*/
+void crearConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores);
+
+/*
+* Función que realiza la espera pthread_join de todos los hilos productores
+*
+* La variable numProductores indica el número de productores que componen el
+* array 'hilos
+*/
+void joinProductores(HiloProductor* hilos, unsigned int numProductores);
+
+/*
+* Función que realiza la espera pthread_join de todos los hilos consumidores
+*
+* La variable numConsumidores indica el número de consumidores que componen el
+* array 'hilos'
+*/
+void joinConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores);
+
+/*
+* Función asociada a los hilos de tipo productor
+*/
+void productor(HiloProductor* hilo);
+
+/*
+* Función asociada a los hilos de tipo consumidores
+*/
+void consumidor(HiloConsumidor* hilo);
+
+/*
+* Función de espera para los hilos que han encontrado el buffer lleno o vacío.
+* Durante los primeros INTENTOS_ESPERA intentos se cede la CPU, y a partir de
+* ahí se duerme TIEMPO_ESPERA microsegundos.
+*/
+void esperar(unsigned int* intentos);
+
+/*
+* Función de producción para los hilos productores. Devuelve un entero aleatorio
+* entre 0 y 9.
+*/
+int producir();
+
+/*
+* Función que muestra la pregunta indicada y asigna la respuesta del usuario al
+* parámetro de la clave indicada, validándola. Si la respuesta no es válida se
+* vuelve a preguntar, y si la entrada se termina el programa finaliza
+*/
+void preguntar(Configuracion* configuracion, const char* pregunta,
+               const char* clave);
+
+/*
+* Función que comprueba que la configuración solo modifica los parámetros que
+* esta implementación puede respetar. En caso contrario escribe el motivo por
+* la salida de error y devuelve -1
+*/
+int comprobarParametros(const Configuracion* configuracion);
+
+/*
+* Función que duerme al hilo el número de segundos indicado, que puede tener
+* decimales. Con un tiempo no positivo vuelve inmediatamente
+*/
+void dormir(double segundos);
+
+/*
+* Función que modifica la cadena de caracteres pasada por argumento añadiéndole
+* la hora actual. La cadena de caracteres tiene que tener como mínimo 'TAM_HORA'
+* caracteres.
+*/
+void calcularHora(char* hora);
+
+/*
+* Función para imprimir la cabecera del hilo productor indicado en un color
+* determinado.
+*/
+void imprimirCabeceraProduc(HiloProductor hilo, char* color);
+
+/*
+* Función para imprimir la cabecera del hilo consumidor indicado en un color
+* determinado.
+*/
+void imprimirCabeceraConsum(HiloConsumidor hilo, char* color);
+
+int main(int argc, char *argv[]){
+
+  // Array de información de hilos productores y consumidores que se usarán en
+  // el programa
+  HiloProductor* productores;
+  HiloConsumidor* consumidores;
+
+  // Parámetros de la ejecución. Se parte de los valores por defecto, que se
+  // sustituyen por los del fichero de configuración y después por los de la
+  // línea de comandos
+  Configuracion configuracion;
+
+  // Variables que indican el número de productores y consumidores que se
+  // crearán
+  int numProductores, numConsumidores;
+
+  // Opción procesada, resultado de su validación, número de argumentos
+  // posicionales y fichero de configuración indicado
+  int opcion;
+  int valido = 0;
+  int numArgumentos;
+  char* fichero = NULL;
+
+  srand(time(NULL));
+
+  iniciarConfiguracion(&configuracion);
+
+  // En una primera pasada solo se lee el fichero de configuración, de forma
+  // que el resto de opciones prevalezcan sobre él sea cual sea su orden
+  opterr = 0;
+  while((opcion = getopt(argc, argv, OPCIONES)) != -1){
+    if(opcion == 'F'){
+      fichero = optarg;
+      if(leerConfiguracion(&configuracion, fichero) != 0){
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+  opterr = 1;
+  optind = 1;
+
+  // Se procesan las opciones indicadas antes de los argumentos posicionales.
+  // Todas se validan con 'asignarConfiguracion', igual que las del fichero
+  while((opcion = getopt(argc, argv, OPCIONES)) != -1){
+    switch(opcion){
+      case 'h':
+      // Se imprime la ayuda al usuario y se sale de forma exitosa
+      printf("Modo de uso: %s [-F fichero] [-b tam] [-n producciones] "
+             "[-p segundos] [-c segundos] [-P segundos] [-C segundos] "
+             "<numProductores> <numConsumidores> <defecto>\n"
+             "\t-> defecto: se utilizan los parámetros por defecto para los"
+                  " hilos:\n"
+                  "\t\t-> Tiempo de producción: 2\n"
+                  "\t\t-> Tiempo de consumición: 1\n"
+                  "\t\t-> Tiempo de postProducción: aleatorio entre 0 y 4\n"
+                  "\t\t-> Tiempo de postConsumición: aleatorio entre 0 y 4"
+                  "\n\t\t-> Número de producciones: 10 por hilo\n"
+             "\t   Si no se indica, ni se indica ningún tiempo, el número de "
+                  "producciones o un fichero de configuración, se pregunta "
+                  "por ellos\n"
+             "\t-> F: fichero de configuración con una asignación 'clave = "
+                  "valor' por línea. Claves: productores, consumidores, "
+                  "tam_buffer, producciones, tiempo_produccion, "
+                  "tiempo_consumicion, post_produccion y post_consumicion. "
+                  "Las opciones de la línea de comandos prevalecen sobre el "
+                  "fichero\n"
+             "\t-> tam: número de posiciones del buffer (por defecto 10)\n"
+             "\t-> producciones: producciones a realizar por cada productor\n"
+             "\t-> p, c, P, C: tiempos de producción, consumición, post "
+                  "producción y post consumición en segundos. Admiten "
+                  "decimales y 'aleatorio' (entre 0 y 4 segundos)\n"
+                  , argv[0]);
+
+      exit(EXIT_SUCCESS);
+      break;
+
+      case 'F':
+      // El fichero ya se ha leído en la primera pasada
+      break;
+
+      case 'b':
+      valido = asignarConfiguracion(&configuracion, "tam_buffer", optarg);
+      break;
+
+      case 'n':
+      valido = asignarConfiguracion(&configuracion, "producciones", optarg);
+      break;
+
+      case 'p':
+      valido = asignarConfiguracion(&configuracion, "tiempo_produccion",
+                                    optarg);
+      break;
+
+      case 'c':
+      valido = asignarConfiguracion(&configuracion, "tiempo_consumicion",
+                                    optarg);
+      break;
+
+      case 'P':
+      valido = asignarConfiguracion(&configuracion, "post_produccion", optarg);
+      break;
+
+      case 'C':
+      valido = asignarConfiguracion(&configuracion, "post_consumicion",
+                                    optarg);
+      break;
+
+      default:
+      fprintf(stderr, "Utiliza %s -h para ver el modo de uso\n", argv[0]);
+      exit(EXIT_FAILURE);
+    }
+
+    if(valido != 0){
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // Número de argumentos posicionales restantes
+  numArgumentos = argc - optind;
+
+  // Se comprueba que se indiquen el número de productores y el de
+  // consumidores, salvo que se tomen del fichero de configuración
+  if((numArgumentos == 0 && fichero == NULL) || numArgumentos == 1 ||
+     numArgumentos > 3){
+    fprintf(stderr, "[!] Se deben indicar el número de productores y el de "
+                    "consumidores\nUtiliza %s -h para ver el modo de uso\n",
+            argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  if(numArgumentos >= 2 &&
+     (asignarConfiguracion(&configuracion, "productores", argv[optind]) != 0 ||
+      asignarConfiguracion(&configuracion, "consumidores",
+                           argv[optind + 1]) != 0)){
+    exit(EXIT_FAILURE);
+  }
+
+  // En caso de que no se indique la opción por defecto ni ninguno de los
+  // parámetros de los hilos, se pide al usuario que los indique. Las
+  // respuestas se validan igual que las opciones
+  if(numArgumentos <= 2 && fichero == NULL && !configuracion.parametrosHilos){
+    preguntar(&configuracion, "[?] ¿Tiempo de producción? ",
+              "tiempo_produccion");
+    preguntar(&configuracion, "[?] ¿Tiempo de consumición? ",
+              "tiempo_consumicion");
+    preguntar(&configuracion, "[?] ¿Tiempo de post producción? ",
+              "post_produccion");
+    preguntar(&configuracion, "[?] ¿Tiempo de post consumición? ",
+              "post_consumicion");
+    preguntar(&configuracion, "[?] ¿Producciones a realizar por hilo? ",
+              "producciones");
+  }
+
+  // Sin trabajadores no se admiten más hilos de los que se pueden crear
+  if(comprobarConfiguracion(&configuracion) != 0){
+    exit(EXIT_FAILURE);
+  }
+
+  // El fichero de configuración puede contener claves de las otras
+  // implementaciones que esta no puede respetar
+  if(comprobarParametros(&configuracion) != 0){
+    exit(EXIT_FAILURE);
+  }
+
+  // Se aplica la configuración
+  numProductores = configuracion.numProductores;
+  numConsumidores = configuracion.numConsumidores;
+
+  // Se reserva memoria para los productores y consumidores
+  productores = (HiloProductor*)  malloc(sizeof(HiloProductor)*numProductores);
+  consumidores = (HiloConsumidor*) malloc(sizeof(HiloConsumidor)*
+                                          numConsumidores);
+
+  // Los parámetros del primer hilo de cada tipo se duplican para el resto. Al
+  // establecer los tiempos a -1 se utilizarán tiempos aleatorios entre 0 y 4
+  // segundos
+  productores[0].tiempo = configuracion.tiempoProduccion;
+  productores[0].postProduccion = configuracion.postProduccion;
+  consumidores[0].tiempo = configuracion.tiempoConsumicion;
+  consumidores[0].postConsumicion = configuracion.postConsumicion;
+  productores[0].numProducciones = configuracion.producciones;
+
+  // Se llama a la función de crearBuffer para obtener un buffer del tamaño
+  // indicado
+  buffer = crearBuffer(configuracion.tamBuffer);
+
+  // Se crean los productores y consumidores, pasándole a estas funciones los
+  // arrays con la información de los hilos correspondientes.
+  //
+  // El primer elemento de cada array contiene la información que deberá ser
+  // duplicada para el resto de hilos
+  crearProductores(productores, numProductores);
+  crearConsumidores(consumidores, numConsumidores);
+
+  // Las funciones join realizan un pthread_join sobre todos los Hilos
+  // La función joinProductores realiza un join sobre los productores, que serán
+  // en gran parte de los casos los primeros en acabar.
+  joinProductores(productores, numProductores);
+
+  // La función joinConsumidores realiza un join sobre los consumidores, que
+  // serán, en la gran parte de los casos, los últimos en finalizar.
+  joinConsumidores(consumidores, numConsumidores);
+
+  // Se destruye el buffer
+  destruirBuffer(&buffer);
+
+  // El proceso finaliza
+  exit(EXIT_SUCCESS);
+}
+
+void crearProductores(HiloProductor* hilos, unsigned int numProductores){
+  // Contador
+  int i;
+
+  // Resultado de la creación de cada hilo
+  int error;
+
+  // Se registran todos los productores antes de crear el primero, de forma que
+  // el buffer no se pueda cerrar mientras quede alguno por terminar
+  registrarProductores(&buffer, numProductores);
+
+  for(i = 0; i < numProductores; i++){
+    // Se asigna el id correspondiente al hilo, en función del orden
+    hilos[i].id = i;
+
+    // El número de producciones de cualquier hilo se establece como el mismo
+    // del primer hilo.
+    // Lo mismo ocurre para las variables de postProduccion y tiempo
+    hilos[i].numProducciones = hilos[0].numProducciones;
+    hilos[i].postProduccion = hilos[0].postProduccion;
+    hilos[i].tiempo = hilos[0].tiempo;
+
+    // Se crea el hilo, almacenando la información en su variable concreta.
+    // El hilo ejecutará la función 'productor' que recibe como parámetro el
+    // puntero a la información del hilo correspondiente
+    error = pthread_create(&(hilos[i].tid), NULL, (void*)productor, hilos+i);
+    if(error != 0){
+      fprintf(stderr, "[!] No se ha podido crear el hilo del productor %d: "
+                      "%s\n", i, strerror(error));
+      exit(EXIT_FAILURE);
+    }
+  }
+
+}
+
+void crearConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
+  int i;
+  int error;
+
+  for(i = 0; i < numConsumidores; i++){
+    // Se asigna el id correspondiente al hilo, en función del orden
+    hilos[i].id = i;
+
+    // Los tiempos de cualquier hilo se establecen como los mismos del primer
+    // hilo
+    hilos[i].tiempo = hilos[0].tiempo;
+    hilos[i].postConsumicion = hilos[0].postConsumicion;
+
+    // Se crea el hilo, almacenando la información en su variable concreta.
+    // El hilo ejecutará la función 'consumidor' que recibe como parámetro el
+    // puntero a la información del hilo correspondiente
+    error = pthread_create(&(hilos[i].tid), NULL, (void*)consumidor, hilos+i);
+    if(error != 0){
+      fprintf(stderr, "[!] No se ha podido crear el hilo del consumidor %d: "
+                      "%s\n", i, strerror(error));
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void joinProductores(HiloProductor* hilos, unsigned int numProductores){
+  int i;
+  for(i = 0; i < numProductores; i++){
+    // Se hace un join sobre todos los hilos productores
+    pthread_join(hilos[i].tid, NULL);
+  }
+}
+
+void joinConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
+  int i;
+  for(i = 0; i < numConsumidores; i++){
+    // Se hace un join sobre todos los hilos consumidores
+    pthread_join(hilos[i].tid, NULL);
+  }
+}
+
+
+void productor(HiloProductor* hilo){
+  int i;
+  int item;
+  unsigned int intentos;
+
+  // Se informa al usuario del número del productor
+  imprimirCabeceraProduc(*hilo, reset);
+  printf("[i] Soy el productor número %d\n", hilo->id);
+
+  // Se crean las producciones indicadas en la información del hilo
+  for(i = 0; i < hilo->numProducciones; i++){
+    // Se produce el item, tardando el tiempo de producción indicado. Al no
+    // existir región crítica, el tiempo de producción no bloquea a nadie
+    item = producir();
+    dormir(hilo->tiempo);
+
+    // Se intenta insertar en el buffer hasta que haya una posición libre
+    intentos = 0;
+    while(!insertarBuffer(&buffer, item)){
+      if(intentos == 0){
+        imprimirCabeceraProduc(*hilo, fpurple);
+        printf("[!] La cola está llena. Esperando...%s\n", reset);
+      }
+      esperar(&intentos);
+    }
+
+    imprimirCabeceraProduc(*hilo, tgreen);
+    printf("[%d / %d] He fabricado el valor: %d (elementos: %d)\n%s", i+1,
+            hilo->numProducciones, item, numElementos(&buffer), reset);
+
+    // Se realiza la post producción, en caso de que el tiempo indicado sea
+    // negativo, se escoge un tiempo aleatorio entre 0 y 4
+    if(hilo->postProduccion < 0){
+      hilo->postProduccion = rand()%5;
+    }
+
+    imprimirCabeceraProduc(*hilo, tpurple);
+    printf("[*] Realizando espera post producción de %g segundos\n%s",
+            hilo->postProduccion, reset);
+
+    dormir(hilo->postProduccion);
+  }
+
+  // Se indica que el productor ha terminado. El último en hacerlo cierra el
+  // buffer, y los consumidores terminan cuando lo encuentran cerrado y vacío
+  terminarProductor(&buffer);
+
+  imprimirCabeceraProduc(*hilo, tred);
+  printf("[!] He acabado de producir. Finalizando...\n%s", reset);
+
+  // El hilo finaliza correctamente
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidor(HiloConsumidor* hilo){
+  // Contador del número de consumiciones
+  int i = 1;
+  int item;
+  int obtenido;
+  unsigned int intentos;
+
+  // Bucle hasta que el buffer esté cerrado y vacío. Sacar un valor no modifica
+  // ningún contador compartido aparte del propio buffer, y el cierre solo se
+  // consulta cuando no hay ningún valor que sacar
+  while(1){
+
+    // Se intenta sacar un valor del buffer hasta que haya alguno disponible o
+    // hasta que, cerrado el buffer, otros consumidores se hayan llevado los
+    // valores restantes
+    intentos = 0;
+    while(!(obtenido = sacarBuffer(&buffer, &item)) &&
+          !bufferAgotado(&buffer)){
+      if(intentos == 0){
+        imprimirCabeceraConsum(*hilo, fpurple);
+        printf("[!] La cola está vacía. Esperando...%s\n", reset);
+      }
+      esperar(&intentos);
+    }
+
+    if(!obtenido){
+      break;
+    }
+
+    // El tiempo de consumición se realiza después de sacar el valor, sin
+    // bloquear al resto de hilos
+    dormir(hilo->tiempo);
+
+    imprimirCabeceraConsum(*hilo, tgreen);
+    printf("[Nª: %d] He consumido el valor: %d\n%s", i, item, reset);
+
+    imprimirCabeceraConsum(*hilo, tyellow);
+    printf("[i] Quedan en el buffer %d elementos\n%s",
+            numElementos(&buffer), reset);
+
+    // Se realiza una espera de post consumición antes de volver a intentar
+    // sacar un valor
+    if(hilo->postConsumicion < 0){
+      hilo->postConsumicion = rand()%5;
+    }
+
+    imprimirCabeceraConsum(*hilo, tpurple);
+    printf("[*] Realizando espera post consumición de %g segundos\n%s",
+            hilo->postConsumicion, reset);
+
+    dormir(hilo->postConsumicion);
+
+    // Se incrementa el número de consumiciones
+    i++;
+  }
+
+  imprimirCabeceraConsum(*hilo, tred);
+  printf("[!] El buffer está cerrado y vacío. Finalizando...\n%s", reset);
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void esperar(unsigned int* intentos){
+  if(*intentos < INTENTOS_ESPERA){
+    // Mientras el número de intentos sea bajo se cede la CPU, ya que es probable
+    // que otro hilo cambie el estado del buffer en muy poco tiempo
+    sched_yield();
+    (*intentos)++;
+  } else {
+    usleep(TIEMPO_ESPERA);
+  }
+}
+
+int producir(){
+  return rand()%10;
+}
+
+void preguntar(Configuracion* configuracion, const char* pregunta,
+               const char* clave){
+  char respuesta[64];
+
+  do{
+    printf("%s", pregunta);
+    fflush(stdout);
+    if(scanf("%63s", respuesta) != 1){
+      fprintf(stderr, "\n[!] No se ha indicado el parámetro '%s'\n", clave);
+      exit(EXIT_FAILURE);
+    }
+  } while(asignarConfiguracion(configuracion, clave, respuesta) != 0);
+}
+
+int comprobarParametros(const Configuracion* configuracion){
+  Configuracion defecto;
+
+  // Los parámetros que no se utilizan deben conservar su valor por defecto
+  iniciarConfiguracion(&defecto);
+
+  if(configuracion->lote != defecto.lote){
+    fprintf(stderr, "[!] Esta implementación no admite lotes\n");
+    return -1;
+  }
+  if(configuracion->nivel != defecto.nivel){
+    fprintf(stderr, "[!] Esta implementación no admite niveles de mensajes\n");
+    return -1;
+  }
+  if(configuracion->estrategia != defecto.estrategia ||
+     configuracion->pausas != defecto.pausas){
+    fprintf(stderr, "[!] Esta implementación no duerme a los hilos, por lo "
+                    "que no admite estrategias ni pausas\n");
+    return -1;
+  }
+  if(configuracion->medir != defecto.medir){
+    fprintf(stderr, "[!] Esta implementación no admite medir las fases\n");
+    return -1;
+  }
+  if(configuracion->fragmentos != defecto.fragmentos){
+    fprintf(stderr, "[!] Esta implementación no admite fragmentos\n");
+    return -1;
+  }
+  if(strcmp(configuracion->afinidad, defecto.afinidad) != 0){
+    fprintf(stderr, "[!] Esta implementación no admite afinidad\n");
+    return -1;
+  }
+  if(configuracion->trabajadores != defecto.trabajadores){
+    fprintf(stderr, "[!] Esta implementación no admite trabajadores\n");
+    return -1;
+  }
+  if(configuracion->entrada[0] != '\0'){
+    fprintf(stderr, "[!] Esta implementación no admite fichero de entrada\n");
+    return -1;
+  }
+
+  return 0;
+}
+
+void dormir(double segundos){
+  struct timespec espera;
+
+  if(segundos <= 0){
+    return;
+  }
+
+  espera.tv_sec = (time_t) segundos;
+  espera.tv_nsec = (long)((segundos - espera.tv_sec) * 1e9);
+
+  // Si una señal interrumpe la espera se continúa con el tiempo restante
+  while(nanosleep(&espera, &espera) == -1 && errno == EINTR);
+}
+
+void calcularHora(char* hora){
+  time_t t;
+  struct tm *tim;
+
+  t = time(NULL);
+  tim = localtime(&t);
+  strftime(hora, TAM_HORA, "%H:%M:%S", tim);
+}
+
+void imprimirCabeceraProduc(HiloProductor hilo, char* color){
+  char hora[TAM_HORA];
+  calcularHora(hora);
+  printf("%s{P: %d}(%s) │ ", color, hilo.id, hora);
+}
+
+void imprimirCabeceraConsum(HiloConsumidor hilo, char* color){
+  char hora[TAM_HORA];
+  calcularHora(hora);
+  printf("%s{C: %d}(%s) │ ", color, hilo.id, hora);
+}
@@ -0,0 +1,90 @@
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "aviso.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+int crearAviso(Aviso* aviso){
+#ifdef __linux__
+	aviso->descriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(aviso->descriptor < 0){
+		return -1;
+	}
+	aviso->escritura = aviso->descriptor;
+#else
+	int tuberia[2];
+
+	if(pipe(tuberia) != 0){
+		return -1;
+	}
+	fcntl(tuberia[0], F_SETFL, O_NONBLOCK);
+	fcntl(tuberia[1], F_SETFL, O_NONBLOCK);
+	aviso->descriptor = tuberia[0];
+	aviso->escritura = tuberia[1];
+#endif
+
+	atomic_init(&aviso->pendiente, 0);
+	return 0;
+}
+
+void destruirAviso(Aviso* aviso){
+	if(aviso->escritura != aviso->descriptor){
+		close(aviso->escritura);
+	}
+	close(aviso->descriptor);
+	aviso->descriptor = -1;
+	aviso->escritura = -1;
+}
+
+int descriptorAviso(const Aviso* aviso){
+	return aviso->descriptor;
+}
+
+int avisar(Aviso* aviso){
+	uint64_t uno = 1;
+
+	// Pareja de la barrera de 'limpiarAviso': o bien este hilo ve que el aviso
+	// se ha limpiado y escribe, o bien quien lo limpió ve el cambio de la
+	// condición al volver a comprobarla
+	atomic_thread_fence(memory_order_seq_cst);
+
+	if(atomic_exchange_explicit(&aviso->pendiente, 1, memory_order_acq_rel)){
+		return 0;
+	}
+
+	// El descriptor no bloquea: si el contador o la tubería están llenos ya
+	// hay un aviso que leer
+	while(write(aviso->escritura, &uno, sizeof(uno)) < 0 && errno == EINTR);
+
+	return 1;
+}
+
+void limpiarAviso(Aviso* aviso){
+	uint64_t valor[8];
+	ssize_t leidos;
+
+	atomic_store_explicit(&aviso->pendiente, 0, memory_order_release);
+
+	// El descriptor se vacía aunque no hubiera un aviso pendiente: 'avisar'
+	// marca el aviso antes de escribir, por lo que una limpieza entre ambos
+	// pasos deja el descriptor legible con el aviso ya limpio. Un 'eventfd' se
+	// vacía con una lectura; una tubería puede contener varios avisos
+	do{
+		leidos = read(aviso->descriptor, valor, sizeof(valor));
+	} while(leidos > 0 || (leidos < 0 && errno == EINTR));
+
+	atomic_thread_fence(memory_order_seq_cst);
+}
+
+void esperarAviso(Aviso* aviso){
+	struct pollfd descriptor;
+
+	descriptor.fd = aviso->descriptor;
+	descriptor.events = POLLIN;
+	while(poll(&descriptor, 1, -1) < 0 && errno == EINTR);
+}
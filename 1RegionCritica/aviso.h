@@ -0,0 +1,120 @@
+#ifndef AVISO_H
+#define AVISO_H
+
+#include <stdatomic.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Aviso expone una condición de la cola (que no esté vacía o que no esté
+* llena) como un descriptor de fichero que pasa a ser legible cuando la
+* condición puede haber cambiado. Así un hilo que ya espera en un bucle de
+* 'epoll' o 'poll' puede atender la cola junto con el resto de sus
+* descriptores, en lugar de dedicar un hilo bloqueado en una variable de
+* condición. En Linux el descriptor es un 'eventfd'; en otros sistemas se
+* utiliza una tubería.
+*
+* Los avisos se agrupan: 'avisar' solo escribe en el descriptor si no hay ya un
+* aviso pendiente, por lo que una ráfaga de inserciones cuesta una única
+* llamada al sistema. El aviso queda pendiente, y el descriptor legible, hasta
+* que algún hilo lo limpia.
+*
+* El uso es el siguiente:
+*		1. El hilo que va a esperar comprueba su condición. Si no se cumple llama a
+*			 'limpiarAviso' y vuelve a comprobarla (o la comprueba con el mutex de la
+*			 cola bloqueado, de forma que no pueda cambiar entre ambas llamadas).
+*		2. Espera a que el descriptor sea legible con 'epoll', 'poll' o
+*			 'esperarAviso', y vuelve al paso 1.
+*		3. El hilo que cambia la condición llama a 'avisar' después de cambiarla.
+*
+* Como el aviso se limpia antes de la última comprobación, cualquier cambio
+* posterior vuelve a escribir en el descriptor y la espera no se pierde. Como
+* no se vacía al despertar, todos los hilos que esperan en el descriptor se
+* despiertan y vuelven a comprobar la condición.
+*/
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_AVISO
+* Campos:
+*		- descriptor: descriptor que se vuelve legible con cada aviso
+*		- escritura: descriptor en el que se escriben los avisos (el mismo que
+*								 'descriptor' con 'eventfd')
+*		- pendiente: 1 si se ha escrito un aviso que aún no se ha limpiado
+*/
+typedef struct ST_AVISO{
+	int descriptor;
+	int escritura;
+	atomic_int pendiente;
+} Aviso;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: crearAviso
+* Tipo: constructor
+* Función que crea el descriptor del aviso, sin ningún aviso pendiente.
+*
+* Precondición : ninguna
+* Postcondición: se devuelve 0 y el aviso puede ser utilizado, o -1 si no se ha
+*								 podido crear el descriptor
+*/
+int crearAviso(Aviso* aviso);
+
+/*
+* Nombre: destruirAviso
+* Tipo: destructor
+* Función que cierra los descriptores del aviso.
+*
+* Precondición : ningún hilo está utilizando el aviso
+* Postcondición: el aviso no puede volver a utilizarse
+*/
+void destruirAviso(Aviso* aviso);
+
+/*
+* Nombre: descriptorAviso
+* Tipo: consulta
+* Función que devuelve el descriptor que se debe añadir al bucle de eventos
+* para leer (EPOLLIN o POLLIN).
+*
+* Precondición : el aviso debe haber sido creado con 'crearAviso'
+* Postcondición: se devuelve el descriptor
+*/
+int descriptorAviso(const Aviso* aviso);
+
+/*
+* Nombre: avisar
+* Tipo: modificador
+* Función que hace legible el descriptor si no había ya un aviso pendiente.
+*
+* Precondición : el aviso debe haber sido creado con 'crearAviso'
+* Postcondición: se devuelve 1 si se ha escrito en el descriptor y 0 si el
+*								 aviso ya estaba pendiente
+*/
+int avisar(Aviso* aviso);
+
+/*
+* Nombre: limpiarAviso
+* Tipo: modificador
+* Función que elimina el aviso pendiente, si lo hay, y vacía el descriptor hasta
+* que no quede nada que leer.
+*
+* Precondición : el aviso debe haber sido creado con 'crearAviso'
+* Postcondición: no hay ningún aviso pendiente
+*/
+void limpiarAviso(Aviso* aviso);
+
+/*
+* Nombre: esperarAviso
+* Tipo: modificador
+* Función que duerme al hilo hasta que el descriptor sea legible, para los hilos
+* que no tienen su propio bucle de eventos.
+*
+* Precondición : el aviso debe haber sido creado con 'crearAviso'
+* Postcondición: hay un aviso pendiente, o lo ha habido desde la última
+*								 limpieza
+*/
+void esperarAviso(Aviso* aviso);
+
+#endif
@@ -0,0 +1,1379 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "buffer.h"
+#include "evento.h"
+#include "espera.h"
+
+/*
+* Programa de medida del rendimiento de la implementación con una única región
+* crítica. Utiliza el mismo Buffer y el mismo esquema de mutex y variables de
+* condición que 'main.c', pero sin esperas ni mensajes por pantalla, y recorre
+* todas las combinaciones de productores, consumidores y tamaños de buffer
+* indicadas. Para cada una se imprime una línea CSV con las operaciones por
+* segundo y los percentiles 50, 99 y 99.9 de la latencia de entrega, medida
+* desde que el productor intenta acceder a la región crítica hasta que un
+* consumidor saca el elemento.
+*/
+
+// Nombre de la implementación que aparece en el CSV. Se distingue la versión
+// compilada sin separar los campos del buffer en líneas de caché
+#ifdef BUFFER_SIN_PADDING
+#define IMPLEMENTACION "1RegionCritica-sin-padding"
+#else
+#define IMPLEMENTACION "1RegionCritica"
+#endif
+
+// Número de operaciones por configuración por defecto
+#define OPERACIONES 200000
+
+// Tamaño máximo de los lotes de productores y consumidores
+#define MAX_LOTE 256
+
+// Tamaño máximo (en bytes) de los elementos del buffer genérico
+#define MAX_BYTES_GENERICO (1 << 16)
+
+// Número máximo de valores en cada lista de la línea de comandos
+#define MAX_LISTA 16
+
+// Número de intentos fallidos consecutivos sobre el buffer SPSC a partir de los
+// cuales el hilo deja de ceder la CPU y pasa a dormir brevemente
+#define INTENTOS_SPSC 64
+
+// Tiempo (en microsegundos) que duerme un hilo sobre el buffer SPSC una vez
+// superados los INTENTOS_SPSC
+#define ESPERA_SPSC 100
+
+// Estructura con la información de cada hilo de la medida
+typedef struct ST_HILOBENCH{
+  // TID del hilo
+  pthread_t tid;
+
+  // Primer item que produce el hilo (solo productores)
+  int primero;
+
+  // Número de items que produce el hilo (solo productores)
+  int numItems;
+
+  // Número máximo de items por acceso a la región crítica
+  int lote;
+
+  // Espera activa que realiza el hilo antes de dormir
+  EsperaActiva espera;
+} HiloBench;
+
+// Buffer y mecanismos de sincronización, iguales a los de 'main.c'
+Buffer buffer;
+BufferSPSC bufferSPSC;
+pthread_mutex_t mutexRegion;
+pthread_cond_t condProductor;
+pthread_cond_t condConsumidor;
+int productoresEsperando;
+int consumidoresEsperando;
+
+// Eventos utilizados en lugar de las variables de condición con la opción -f
+int usarFutex = 0;
+Evento eventoNoLlena;
+Evento eventoNoVacia;
+
+// Número máximo de pausas de la espera activa previa a dormir
+unsigned int maximoEspera = ESPERA_MAX_DEFECTO;
+
+// Número de operaciones tras el cual se sincroniza el buffer persistente
+#define INTERVALO_PERSISTENTE 1024
+
+// Buffer persistente y mecanismos de sincronización de 'medirPersistente'. El
+// TAD no utiliza mutexes, por lo que se accede a él en exclusión mutua con
+// 'mutexPersistente'
+BufferPersistente bufferPersistente;
+pthread_mutex_t mutexPersistente;
+pthread_cond_t condPersistenteNoLlena;
+pthread_cond_t condPersistenteNoVacia;
+int pendientesPersistente;
+
+// Buffer con prioridades y mecanismos de sincronización de 'medirPrioridad'.
+// Se accede a él en exclusión mutua con 'mutexPrioridad'
+BufferPrioridad bufferPrioridad;
+pthread_mutex_t mutexPrioridad;
+pthread_cond_t condPrioridadNoLlena;
+pthread_cond_t condPrioridadNoVacia;
+
+// Buffer segmentado y mecanismos de sincronización de 'medirSegmentado'. Se
+// accede a él en exclusión mutua con 'mutexSegmentado'
+BufferSegmentado bufferSegmentado;
+pthread_mutex_t mutexSegmentado;
+pthread_cond_t condSegmentadoNoLlena;
+pthread_cond_t condSegmentadoNoVacia;
+
+// Buffer genérico y mecanismos de sincronización de 'medirGenerico'. Se accede
+// a él en exclusión mutua con 'mutexGenerico', salvo para escribir y leer el
+// contenido de los huecos. 'pendientesGenerico' es el número de items que aún
+// no ha adquirido ningún consumidor
+BufferGenerico bufferGenerico;
+pthread_mutex_t mutexGenerico;
+pthread_cond_t condGenericoNoLlena;
+pthread_cond_t condGenericoNoVacia;
+int pendientesGenerico;
+
+// Instante (en nanosegundos) en el que se produjo cada item y latencia con la
+// que fue consumido. Cada item es su propio índice en estos arrays
+uint64_t* marcas;
+uint64_t* latencias;
+
+/*
+* Función que devuelve el instante actual en nanosegundos, según el reloj
+* monótono del sistema
+*/
+static inline uint64_t ahora();
+
+/*
+* Funciones asociadas a los hilos productores y consumidores con el esquema de
+* una región crítica
+*/
+void productor(HiloBench* hilo);
+void consumidor(HiloBench* hilo);
+
+/*
+* Funciones asociadas al productor y al consumidor sobre el buffer SPSC
+*/
+void productorSPSC(HiloBench* hilo);
+void consumidorSPSC(HiloBench* hilo);
+
+/*
+* Función que realiza una medida con el buffer compartido entre procesos: se
+* crea un proceso por cada productor y consumidor, y cada uno abre el segmento
+* por su nombre. El tiempo medido incluye la creación de los procesos.
+*/
+void medirProcesos(int numProductores, int numConsumidores, int tam, int lote,
+                   int operaciones);
+
+/*
+* Función que realiza una medida con el buffer persistente sobre el fichero
+* indicado, que se crea de nuevo en cada medida. Los hilos acceden a él con un
+* único mutex y dos variables de condición, y el buffer se sincroniza con el
+* disco cada INTERVALO_PERSISTENTE operaciones.
+*/
+void medirPersistente(int numProductores, int numConsumidores, int tam,
+                      int lote, int operaciones, const char* fichero);
+
+/*
+* Funciones asociadas al productor y al consumidor sobre el buffer persistente
+*/
+void productorPersistente(HiloBench* hilo);
+void consumidorPersistente(HiloBench* hilo);
+
+/*
+* Función que realiza una medida con el buffer con prioridades de 'niveles'
+* niveles, cada uno del tamaño indicado. La prioridad de cada item es su número
+* módulo 'niveles', y además de la línea CSV de todos los items se imprime la
+* de los items de prioridad 0 (líneas 'Prioridad-urgente'), que deben adelantar
+* al resto.
+*/
+void medirPrioridad(int numProductores, int numConsumidores, int tam, int lote,
+                    int operaciones, int niveles);
+
+/*
+* Funciones asociadas al productor y al consumidor sobre el buffer con
+* prioridades
+*/
+void productorPrioridad(HiloBench* hilo);
+void consumidorPrioridad(HiloBench* hilo);
+
+/*
+* Función que realiza una medida con el buffer segmentado, utilizando el tamaño
+* indicado como límite orientativo: los productores esperan mientras la cola lo
+* alcanza, pero cada lote se inserta completo sin esperar a mitad.
+*/
+void medirSegmentado(int numProductores, int numConsumidores, int tam,
+                     int lote, int operaciones);
+
+/*
+* Funciones asociadas al productor y al consumidor sobre el buffer segmentado
+*/
+void productorSegmentado(HiloBench* hilo);
+void consumidorSegmentado(HiloBench* hilo);
+
+/*
+* Función que realiza una medida con el buffer genérico con huecos de 'bytes'
+* bytes. Los productores escriben cada elemento directamente en su hueco y los
+* consumidores lo leen directamente de él, fuera de la región crítica. Cada hilo
+* reserva o adquiere hasta 'lote' huecos a la vez y los confirma o libera en
+* orden inverso, de forma que con lotes de más de un item o varios hilos las
+* confirmaciones y liberaciones llegan desordenadas.
+*/
+void medirGenerico(int numProductores, int numConsumidores, int tam, int lote,
+                   int operaciones, int bytes);
+
+/*
+* Funciones asociadas al productor y al consumidor sobre el buffer genérico
+*/
+void productorGenerico(HiloBench* hilo);
+void consumidorGenerico(HiloBench* hilo);
+
+/*
+* Función que imprime la línea CSV de una medida a partir de sus latencias, que
+* se ordenan
+*/
+void imprimirMedida(const char* nombre, int numProductores, int numConsumidores,
+                    int tam, int lote, int operaciones, double segundos,
+                    uint64_t* medidas, int numMedidas);
+
+/*
+* Función que realiza una medida con la configuración indicada e imprime su
+* línea CSV. Si 'spsc' vale 1 se mide el buffer SPSC en lugar del esquema con
+* región crítica (solo con un productor y un consumidor).
+*/
+void medir(int numProductores, int numConsumidores, int tam, int lote,
+           int operaciones, int spsc);
+
+/*
+* Función que lee una lista de enteros positivos separados por comas. Devuelve
+* el número de valores leídos, o 0 si la lista no es válida
+*/
+int leerLista(char* texto, int* valores);
+
+/*
+* Condiciones de la espera activa, iguales a las de 'main.c'
+*/
+int hayHueco(const void* buffer);
+int hayElementos(const void* buffer);
+
+/*
+* Función de comparación para ordenar las latencias con qsort
+*/
+int compararLatencias(const void* a, const void* b);
+
+int main(int argc, char *argv[]){
+  int productores[MAX_LISTA] = {1, 2, 4, 8};
+  int consumidores[MAX_LISTA] = {1, 2, 4, 8};
+  int tamanos[MAX_LISTA] = {16, 1024};
+  int numProductores = 4, numConsumidores = 4, numTamanos = 2;
+  int operaciones = OPERACIONES;
+  int lote = 1;
+  int procesos = 0;
+  char* fichero = NULL;
+  int niveles = 0;
+  int segmentado = 0;
+  int bytes = 0;
+  int opcion;
+  int p, c, t;
+
+  while((opcion = getopt(argc, argv, "fhn:p:c:t:l:s:xd:q:ug:")) != -1){
+    switch(opcion){
+      case 'h':
+      printf("Modo de uso: %s [-f] [-n operaciones] [-p productores] "
+             "[-c consumidores] [-t tamaños] [-l lote] [-s pausas] [-x] "
+             "[-d fichero] [-q niveles] [-u] [-g bytes]\n"
+             "\t-> f: se utilizan eventos con futex en lugar de variables de "
+                  "condición\n"
+             "\t-> operaciones: items transferidos en cada medida (por "
+                  "defecto %d)\n"
+             "\t-> productores, consumidores y tamaños: listas separadas por "
+                  "comas (por defecto 1,2,4,8 / 1,2,4,8 / 16,1024)\n"
+             "\t-> lote: items por acceso a la región crítica (por defecto "
+                  "1)\n"
+             "\t-> pausas: máximo de pausas de la espera activa previa a "
+                  "dormir (0 la desactiva, por defecto %d)\n"
+             "\t-> x: se mide también el buffer compartido entre procesos\n"
+             "\t-> fichero: se mide también el buffer persistente sobre el "
+                  "fichero indicado, que se sobrescribe\n"
+             "\t-> niveles: se mide también el buffer con el número de "
+                  "niveles de prioridad indicado (entre 1 y %d)\n"
+             "\t-> u: se mide también el buffer segmentado sin tamaño máximo, "
+                  "con el tamaño como límite orientativo\n"
+             "\t-> bytes: se mide también el buffer genérico con elementos del "
+                  "tamaño indicado (entre %d y %d)\n",
+             argv[0], OPERACIONES, ESPERA_MAX_DEFECTO, BUFFER_MAX_NIVELES,
+             (int)sizeof(int), MAX_BYTES_GENERICO);
+      exit(EXIT_SUCCESS);
+      break;
+
+      case 'f':
+      usarFutex = 1;
+      break;
+
+      case 'n':
+      operaciones = atoi(optarg);
+      if(operaciones < 1){
+        fprintf(stderr, "[!] El número de operaciones debe ser positivo\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      case 'p':
+      numProductores = leerLista(optarg, productores);
+      break;
+
+      case 'c':
+      numConsumidores = leerLista(optarg, consumidores);
+      break;
+
+      case 't':
+      numTamanos = leerLista(optarg, tamanos);
+      break;
+
+      case 'l':
+      lote = atoi(optarg);
+      if(lote < 1 || lote > MAX_LOTE){
+        fprintf(stderr, "[!] El lote debe estar entre 1 y %d\n", MAX_LOTE);
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      case 's':
+      if(atoi(optarg) < 0){
+        fprintf(stderr, "[!] El número de pausas no puede ser negativo\n");
+        exit(EXIT_FAILURE);
+      }
+      maximoEspera = atoi(optarg);
+      break;
+
+      case 'x':
+      procesos = 1;
+      break;
+
+      case 'd':
+      fichero = optarg;
+      break;
+
+      case 'u':
+      segmentado = 1;
+      break;
+
+      case 'g':
+      bytes = atoi(optarg);
+      if(bytes < (int)sizeof(int) || bytes > MAX_BYTES_GENERICO){
+        fprintf(stderr, "[!] El tamaño de los elementos debe estar entre %d y "
+                        "%d bytes\n", (int)sizeof(int), MAX_BYTES_GENERICO);
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      case 'q':
+      niveles = atoi(optarg);
+      if(niveles < 1 || niveles > BUFFER_MAX_NIVELES){
+        fprintf(stderr, "[!] Los niveles deben estar entre 1 y %d\n",
+                BUFFER_MAX_NIVELES);
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      default:
+      fprintf(stderr, "Utiliza %s -h para ver el modo de uso\n", argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if(numProductores == 0 || numConsumidores == 0 || numTamanos == 0){
+    fprintf(stderr, "[!] Las listas deben contener enteros positivos separados"
+                    " por comas\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Las marcas y latencias se reservan en memoria compartida para que también
+  // las puedan escribir los procesos de 'medirProcesos'
+  marcas = (uint64_t*) mmap(NULL, sizeof(uint64_t) * operaciones,
+                            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                            -1, 0);
+  latencias = (uint64_t*) mmap(NULL, sizeof(uint64_t) * operaciones,
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(marcas == MAP_FAILED || latencias == MAP_FAILED){
+    perror("[!] mmap");
+    exit(EXIT_FAILURE);
+  }
+
+  printf("implementacion,productores,consumidores,tam,lote,operaciones,"
+         "segundos,ops_seg,p50_ns,p99_ns,p999_ns\n");
+
+  for(t = 0; t < numTamanos; t++){
+    for(p = 0; p < numProductores; p++){
+      for(c = 0; c < numConsumidores; c++){
+        medir(productores[p], consumidores[c], tamanos[t], lote, operaciones,
+              0);
+
+        // Con un productor y un consumidor 'main.c' utiliza el buffer SPSC,
+        // por lo que también se mide
+        if(productores[p] == 1 && consumidores[c] == 1){
+          medir(1, 1, tamanos[t], lote, operaciones, 1);
+        }
+
+        if(procesos){
+          medirProcesos(productores[p], consumidores[c], tamanos[t], lote,
+                        operaciones);
+        }
+
+        if(fichero != NULL){
+          medirPersistente(productores[p], consumidores[c], tamanos[t], lote,
+                           operaciones, fichero);
+        }
+
+        if(niveles > 0){
+          medirPrioridad(productores[p], consumidores[c], tamanos[t], lote,
+                         operaciones, niveles);
+        }
+
+        if(segmentado){
+          medirSegmentado(productores[p], consumidores[c], tamanos[t], lote,
+                          operaciones);
+        }
+
+        if(bytes > 0){
+          medirGenerico(productores[p], consumidores[c], tamanos[t], lote,
+                        operaciones, bytes);
+        }
+      }
+    }
+  }
+
+  munmap(marcas, sizeof(uint64_t) * operaciones);
+  munmap(latencias, sizeof(uint64_t) * operaciones);
+
+  exit(EXIT_SUCCESS);
+}
+
+void medir(int numProductores, int numConsumidores, int tam, int lote,
+           int operaciones, int spsc){
+  HiloBench* productores;
+  HiloBench* consumidores;
+  uint64_t inicio, fin;
+  double segundos;
+  int i, primero;
+  const char* nombre;
+
+  productores = (HiloBench*) malloc(sizeof(HiloBench) * numProductores);
+  consumidores = (HiloBench*) malloc(sizeof(HiloBench) * numConsumidores);
+
+  pthread_mutex_init(&mutexRegion, NULL);
+  pthread_cond_init(&condProductor, NULL);
+  pthread_cond_init(&condConsumidor, NULL);
+  iniciarEvento(&eventoNoLlena);
+  iniciarEvento(&eventoNoVacia);
+  productoresEsperando = 0;
+  consumidoresEsperando = 0;
+  buffer = crearBuffer(tam);
+  if(spsc){
+    bufferSPSC = crearBufferSPSC(tam);
+  }
+
+  // Las operaciones se reparten entre los productores, y el número total de
+  // producciones se registra en el buffer igual que en 'main.c'
+  incrementarProducciones(&buffer, operaciones);
+
+  inicio = ahora();
+
+  primero = 0;
+  for(i = 0; i < numProductores; i++){
+    productores[i].primero = primero;
+    productores[i].numItems = operaciones / numProductores +
+                              (i < operaciones % numProductores);
+    productores[i].lote = lote;
+    primero += productores[i].numItems;
+    pthread_create(&(productores[i].tid), NULL,
+                   spsc ? (void*)productorSPSC : (void*)productor,
+                   productores+i);
+  }
+
+  for(i = 0; i < numConsumidores; i++){
+    consumidores[i].lote = lote;
+    pthread_create(&(consumidores[i].tid), NULL,
+                   spsc ? (void*)consumidorSPSC : (void*)consumidor,
+                   consumidores+i);
+  }
+
+  for(i = 0; i < numProductores; i++){
+    pthread_join(productores[i].tid, NULL);
+  }
+  for(i = 0; i < numConsumidores; i++){
+    pthread_join(consumidores[i].tid, NULL);
+  }
+
+  fin = ahora();
+  segundos = (fin - inicio) / 1e9;
+
+  qsort(latencias, operaciones, sizeof(uint64_t), compararLatencias);
+
+  if(spsc){
+    nombre = "SPSC";
+  } else {
+    nombre = usarFutex ? IMPLEMENTACION "-futex" : IMPLEMENTACION;
+  }
+
+  printf("%s,%d,%d,%d,%d,%d,%.6f,%.0f,%lu,%lu,%lu\n",
+         nombre, numProductores, numConsumidores, tam,
+         spsc ? 1 : lote, operaciones, segundos, operaciones / segundos,
+         (unsigned long)latencias[(operaciones - 1) * 50 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 99 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 999 / 1000]);
+  fflush(stdout);
+
+  if(spsc){
+    destruirBufferSPSC(&bufferSPSC);
+  }
+  destruirBuffer(&buffer);
+  pthread_mutex_destroy(&mutexRegion);
+  pthread_cond_destroy(&condProductor);
+  pthread_cond_destroy(&condConsumidor);
+  free(productores);
+  free(consumidores);
+}
+
+void productor(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int i, j, numItems, insertados, n, sinNotificar, girar;
+  uint32_t ticket;
+
+  iniciarEsperaActiva(&hilo->espera, maximoEspera);
+
+  for(i = 0; i < hilo->numItems; i += numItems){
+    numItems = hilo->numItems - i;
+    if(numItems > hilo->lote){
+      numItems = hilo->lote;
+    }
+    for(j = 0; j < numItems; j++){
+      items[j] = hilo->primero + i + j;
+      marcas[items[j]] = ahora();
+    }
+
+    pthread_mutex_lock(&mutexRegion);
+
+    sinNotificar = 0;
+    for(insertados = 0; insertados < numItems; insertados += n){
+      girar = esperaActivaHabilitada(&hilo->espera);
+      while(colaLlena(&buffer)){
+        if(girar){
+          girar = 0;
+          pthread_mutex_unlock(&mutexRegion);
+          if(usarFutex && sinNotificar > 0){
+            notificarEvento(&eventoNoVacia, sinNotificar);
+          }
+          sinNotificar = 0;
+          esperarActivamente(&hilo->espera, hayHueco, &buffer);
+          pthread_mutex_lock(&mutexRegion);
+        } else if(usarFutex){
+          ticket = prepararEspera(&eventoNoLlena);
+          pthread_mutex_unlock(&mutexRegion);
+          if(sinNotificar > 0){
+            notificarEvento(&eventoNoVacia, sinNotificar);
+          }
+          sinNotificar = 0;
+          esperarEvento(&eventoNoLlena, ticket);
+          pthread_mutex_lock(&mutexRegion);
+        } else {
+          productoresEsperando++;
+          pthread_cond_wait(&condProductor, &mutexRegion);
+          productoresEsperando--;
+        }
+      }
+
+      n = insertarBufferN(&buffer, items + insertados, numItems - insertados);
+      sinNotificar += n;
+
+      if(!usarFutex && consumidoresEsperando > 0){
+        if(n == 1){
+          pthread_cond_signal(&condConsumidor);
+        } else {
+          pthread_cond_broadcast(&condConsumidor);
+        }
+      }
+    }
+
+    pthread_mutex_unlock(&mutexRegion);
+
+    if(usarFutex){
+      notificarEvento(&eventoNoVacia, sinNotificar);
+    }
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidor(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int j, n, girar;
+  uint64_t instante;
+  uint32_t ticket;
+
+  iniciarEsperaActiva(&hilo->espera, maximoEspera);
+
+  while(1){
+    pthread_mutex_lock(&mutexRegion);
+
+    if(obtenerProducciones(&buffer) == 0){
+      pthread_cond_broadcast(&condConsumidor);
+      pthread_mutex_unlock(&mutexRegion);
+      if(usarFutex){
+        notificarTodos(&eventoNoVacia);
+      }
+      pthread_exit(EXIT_SUCCESS);
+    }
+
+    girar = esperaActivaHabilitada(&hilo->espera);
+    while(colaVacia(&buffer)){
+      if(girar){
+        girar = 0;
+        pthread_mutex_unlock(&mutexRegion);
+        esperarActivamente(&hilo->espera, hayElementos, &buffer);
+        pthread_mutex_lock(&mutexRegion);
+      } else if(usarFutex){
+        ticket = prepararEspera(&eventoNoVacia);
+        pthread_mutex_unlock(&mutexRegion);
+        esperarEvento(&eventoNoVacia, ticket);
+        pthread_mutex_lock(&mutexRegion);
+      } else {
+        consumidoresEsperando++;
+        pthread_cond_wait(&condConsumidor, &mutexRegion);
+        consumidoresEsperando--;
+      }
+
+      if(obtenerProducciones(&buffer) == 0){
+        pthread_mutex_unlock(&mutexRegion);
+        pthread_exit(EXIT_SUCCESS);
+      }
+    }
+
+    n = sacarBufferN(&buffer, items, hilo->lote);
+    incrementarProducciones(&buffer, -n);
+
+    if(!usarFutex && productoresEsperando > 0){
+      if(n == 1){
+        pthread_cond_signal(&condProductor);
+      } else {
+        pthread_cond_broadcast(&condProductor);
+      }
+    }
+
+    pthread_mutex_unlock(&mutexRegion);
+
+    if(usarFutex){
+      notificarEvento(&eventoNoLlena, n);
+    }
+
+    // La latencia se calcula fuera de la región crítica
+    instante = ahora();
+    for(j = 0; j < n; j++){
+      latencias[items[j]] = instante - marcas[items[j]];
+    }
+  }
+}
+
+void productorSPSC(HiloBench* hilo){
+  int i, item;
+  unsigned int intentos;
+
+  for(i = 0; i < hilo->numItems; i++){
+    item = hilo->primero + i;
+    marcas[item] = ahora();
+
+    intentos = 0;
+    while(!insertarBufferSPSC(&bufferSPSC, item)){
+      if(intentos < INTENTOS_SPSC){
+        sched_yield();
+        intentos++;
+      } else {
+        usleep(ESPERA_SPSC);
+      }
+    }
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidorSPSC(HiloBench* hilo){
+  int i, item, pendientes;
+  unsigned int intentos;
+
+  pendientes = obtenerProducciones(&buffer);
+
+  for(i = 0; i < pendientes; i++){
+    intentos = 0;
+    while(!sacarBufferSPSC(&bufferSPSC, &item)){
+      if(intentos < INTENTOS_SPSC){
+        sched_yield();
+        intentos++;
+      } else {
+        usleep(ESPERA_SPSC);
+      }
+    }
+    latencias[item] = ahora() - marcas[item];
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void medirProcesos(int numProductores, int numConsumidores, int tam, int lote,
+                   int operaciones){
+  BufferCompartido compartido;
+  char nombre[64];
+  int items[MAX_LOTE];
+  uint64_t inicio, fin, instante;
+  double segundos;
+  int i, j, primero, numItems, hechos, insertados, n;
+
+  snprintf(nombre, sizeof(nombre), "/bench-%d", (int) getpid());
+  compartido = crearBufferCompartido(nombre, tam);
+  if(compartido.cabecera == NULL){
+    perror("[!] crearBufferCompartido");
+    return;
+  }
+  incrementarProduccionesCompartido(&compartido, operaciones);
+
+  inicio = ahora();
+
+  primero = 0;
+  for(i = 0; i < numProductores; i++){
+    numItems = operaciones / numProductores + (i < operaciones % numProductores);
+
+    if(fork() == 0){
+      // El proceso hijo abre el segmento por su nombre, igual que lo haría un
+      // proceso independiente
+      compartido = abrirBufferCompartido(nombre);
+      for(hechos = 0; hechos < numItems; hechos += n){
+        n = numItems - hechos;
+        if(n > lote){
+          n = lote;
+        }
+        for(j = 0; j < n; j++){
+          items[j] = primero + hechos + j;
+          marcas[items[j]] = ahora();
+        }
+        for(insertados = 0; insertados < n; ){
+          insertados += insertarBufferCompartido(&compartido, items + insertados,
+                                                 n - insertados);
+        }
+      }
+      cerrarBufferCompartido(&compartido);
+      _exit(EXIT_SUCCESS);
+    }
+
+    primero += numItems;
+  }
+
+  for(i = 0; i < numConsumidores; i++){
+    if(fork() == 0){
+      compartido = abrirBufferCompartido(nombre);
+      while((n = sacarBufferCompartido(&compartido, items, lote)) > 0){
+        instante = ahora();
+        for(j = 0; j < n; j++){
+          latencias[items[j]] = instante - marcas[items[j]];
+        }
+      }
+      cerrarBufferCompartido(&compartido);
+      _exit(EXIT_SUCCESS);
+    }
+  }
+
+  for(i = 0; i < numProductores + numConsumidores; i++){
+    wait(NULL);
+  }
+
+  fin = ahora();
+  segundos = (fin - inicio) / 1e9;
+
+  qsort(latencias, operaciones, sizeof(uint64_t), compararLatencias);
+
+  printf("%s,%d,%d,%d,%d,%d,%.6f,%.0f,%lu,%lu,%lu\n",
+         "Compartido", numProductores, numConsumidores, tam, lote, operaciones,
+         segundos, operaciones / segundos,
+         (unsigned long)latencias[(operaciones - 1) * 50 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 99 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 999 / 1000]);
+  fflush(stdout);
+
+  cerrarBufferCompartido(&compartido);
+  eliminarBufferCompartido(nombre);
+}
+
+void medirPersistente(int numProductores, int numConsumidores, int tam,
+                      int lote, int operaciones, const char* fichero){
+  HiloBench* productores;
+  HiloBench* consumidores;
+  uint64_t inicio, fin;
+  double segundos;
+  int i, primero;
+
+  unlink(fichero);
+  bufferPersistente = abrirBufferPersistente(fichero, tam,
+                                             INTERVALO_PERSISTENTE);
+  if(bufferPersistente.cabecera == NULL){
+    perror("[!] abrirBufferPersistente");
+    return;
+  }
+
+  productores = (HiloBench*) malloc(sizeof(HiloBench) * numProductores);
+  consumidores = (HiloBench*) malloc(sizeof(HiloBench) * numConsumidores);
+
+  pthread_mutex_init(&mutexPersistente, NULL);
+  pthread_cond_init(&condPersistenteNoLlena, NULL);
+  pthread_cond_init(&condPersistenteNoVacia, NULL);
+  pendientesPersistente = operaciones;
+
+  inicio = ahora();
+
+  primero = 0;
+  for(i = 0; i < numProductores; i++){
+    productores[i].primero = primero;
+    productores[i].numItems = operaciones / numProductores +
+                              (i < operaciones % numProductores);
+    productores[i].lote = lote;
+    primero += productores[i].numItems;
+    pthread_create(&(productores[i].tid), NULL, (void*)productorPersistente,
+                   productores+i);
+  }
+
+  for(i = 0; i < numConsumidores; i++){
+    consumidores[i].lote = lote;
+    pthread_create(&(consumidores[i].tid), NULL, (void*)consumidorPersistente,
+                   consumidores+i);
+  }
+
+  for(i = 0; i < numProductores; i++){
+    pthread_join(productores[i].tid, NULL);
+  }
+  for(i = 0; i < numConsumidores; i++){
+    pthread_join(consumidores[i].tid, NULL);
+  }
+
+  // El cierre incluye la última sincronización
+  cerrarBufferPersistente(&bufferPersistente);
+
+  fin = ahora();
+  segundos = (fin - inicio) / 1e9;
+
+  qsort(latencias, operaciones, sizeof(uint64_t), compararLatencias);
+
+  printf("%s,%d,%d,%d,%d,%d,%.6f,%.0f,%lu,%lu,%lu\n",
+         "Persistente", numProductores, numConsumidores, tam, lote,
+         operaciones, segundos, operaciones / segundos,
+         (unsigned long)latencias[(operaciones - 1) * 50 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 99 / 100],
+         (unsigned long)latencias[(operaciones - 1) * 999 / 1000]);
+  fflush(stdout);
+
+  unlink(fichero);
+  pthread_mutex_destroy(&mutexPersistente);
+  pthread_cond_destroy(&condPersistenteNoLlena);
+  pthread_cond_destroy(&condPersistenteNoVacia);
+  free(productores);
+  free(consumidores);
+}
+
+void productorPersistente(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int i, j, numItems, insertados, n;
+
+  for(i = 0; i < hilo->numItems; i += numItems){
+    numItems = hilo->numItems - i;
+    if(numItems > hilo->lote){
+      numItems = hilo->lote;
+    }
+    for(j = 0; j < numItems; j++){
+      items[j] = hilo->primero + i + j;
+      marcas[items[j]] = ahora();
+    }
+
+    pthread_mutex_lock(&mutexPersistente);
+    for(insertados = 0; insertados < numItems; insertados += n){
+      while((n = insertarBufferPersistenteN(&bufferPersistente,
+                                            items + insertados,
+                                            numItems - insertados)) == 0){
+        pthread_cond_wait(&condPersistenteNoLlena, &mutexPersistente);
+      }
+      pthread_cond_broadcast(&condPersistenteNoVacia);
+    }
+    pthread_mutex_unlock(&mutexPersistente);
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidorPersistente(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int j, n;
+  uint64_t instante;
+
+  while(1){
+    pthread_mutex_lock(&mutexPersistente);
+    while((n = sacarBufferPersistenteN(&bufferPersistente, items,
+                                       hilo->lote)) == 0){
+      if(pendientesPersistente == 0){
+        pthread_cond_broadcast(&condPersistenteNoVacia);
+        pthread_mutex_unlock(&mutexPersistente);
+        pthread_exit(EXIT_SUCCESS);
+      }
+      pthread_cond_wait(&condPersistenteNoVacia, &mutexPersistente);
+    }
+    pendientesPersistente -= n;
+    pthread_cond_broadcast(&condPersistenteNoLlena);
+    pthread_mutex_unlock(&mutexPersistente);
+
+    instante = ahora();
+    for(j = 0; j < n; j++){
+      latencias[items[j]] = instante - marcas[items[j]];
+    }
+  }
+}
+
+void medirPrioridad(int numProductores, int numConsumidores, int tam, int lote,
+                    int operaciones, int niveles){
+  HiloBench* productores;
+  HiloBench* consumidores;
+  uint64_t* urgentes;
+  uint64_t inicio, fin;
+  double segundos;
+  int i, primero, numUrgentes;
+
+  productores = (HiloBench*) malloc(sizeof(HiloBench) * numProductores);
+  consumidores = (HiloBench*) malloc(sizeof(HiloBench) * numConsumidores);
+  urgentes = (uint64_t*) malloc(sizeof(uint64_t) * operaciones);
+
+  pthread_mutex_init(&mutexPrioridad, NULL);
+  pthread_cond_init(&condPrioridadNoLlena, NULL);
+  pthread_cond_init(&condPrioridadNoVacia, NULL);
+  bufferPrioridad = crearBufferPrioridad(tam, niveles);
+  incrementarProduccionesPrioridad(&bufferPrioridad, operaciones);
+
+  inicio = ahora();
+
+  primero = 0;
+  for(i = 0; i < numProductores; i++){
+    productores[i].primero = primero;
+    productores[i].numItems = operaciones / numProductores +
+                              (i < operaciones % numProductores);
+    productores[i].lote = lote;
+    primero += productores[i].numItems;
+    pthread_create(&(productores[i].tid), NULL, (void*)productorPrioridad,
+                   productores+i);
+  }
+
+  for(i = 0; i < numConsumidores; i++){
+    consumidores[i].lote = lote;
+    pthread_create(&(consumidores[i].tid), NULL, (void*)consumidorPrioridad,
+                   consumidores+i);
+  }
+
+  for(i = 0; i < numProductores; i++){
+    pthread_join(productores[i].tid, NULL);
+  }
+  for(i = 0; i < numConsumidores; i++){
+    pthread_join(consumidores[i].tid, NULL);
+  }
+
+  fin = ahora();
+  segundos = (fin - inicio) / 1e9;
+
+  // Las latencias de los items de prioridad 0 se separan antes de ordenar
+  numUrgentes = 0;
+  for(i = 0; i < operaciones; i += niveles){
+    urgentes[numUrgentes++] = latencias[i];
+  }
+
+  imprimirMedida("Prioridad", numProductores, numConsumidores, tam, lote,
+                 operaciones, segundos, latencias, operaciones);
+  imprimirMedida("Prioridad-urgente", numProductores, numConsumidores, tam,
+                 lote, operaciones, segundos, urgentes, numUrgentes);
+
+  destruirBufferPrioridad(&bufferPrioridad);
+  pthread_mutex_destroy(&mutexPrioridad);
+  pthread_cond_destroy(&condPrioridadNoLlena);
+  pthread_cond_destroy(&condPrioridadNoVacia);
+  free(urgentes);
+  free(productores);
+  free(consumidores);
+}
+
+void productorPrioridad(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int i, j, numItems;
+  int niveles = bufferPrioridad.numNiveles;
+
+  for(i = 0; i < hilo->numItems; i += numItems){
+    numItems = hilo->numItems - i;
+    if(numItems > hilo->lote){
+      numItems = hilo->lote;
+    }
+    for(j = 0; j < numItems; j++){
+      items[j] = hilo->primero + i + j;
+      marcas[items[j]] = ahora();
+    }
+
+    // Los items de un lote tienen prioridades distintas, por lo que se
+    // insertan de uno en uno, cada uno en su nivel
+    pthread_mutex_lock(&mutexPrioridad);
+    for(j = 0; j < numItems; j++){
+      while(!insertarBufferPrioridad(&bufferPrioridad, items[j],
+                                     items[j] % niveles)){
+        pthread_cond_wait(&condPrioridadNoLlena, &mutexPrioridad);
+      }
+    }
+    pthread_cond_broadcast(&condPrioridadNoVacia);
+    pthread_mutex_unlock(&mutexPrioridad);
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidorPrioridad(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int j, n;
+  uint64_t instante;
+
+  while(1){
+    pthread_mutex_lock(&mutexPrioridad);
+    while((n = sacarBufferPrioridadN(&bufferPrioridad, items, hilo->lote,
+                                     NULL)) == 0){
+      if(obtenerProduccionesPrioridad(&bufferPrioridad) == 0){
+        pthread_cond_broadcast(&condPrioridadNoVacia);
+        pthread_mutex_unlock(&mutexPrioridad);
+        pthread_exit(EXIT_SUCCESS);
+      }
+      pthread_cond_wait(&condPrioridadNoVacia, &mutexPrioridad);
+    }
+    incrementarProduccionesPrioridad(&bufferPrioridad, -n);
+    pthread_cond_broadcast(&condPrioridadNoLlena);
+    pthread_mutex_unlock(&mutexPrioridad);
+
+    instante = ahora();
+    for(j = 0; j < n; j++){
+      latencias[items[j]] = instante - marcas[items[j]];
+    }
+  }
+}
+
+void medirSegmentado(int numProductores, int numConsumidores, int tam,
+                     int lote, int operaciones){
+  HiloBench* productores;
+  HiloBench* consumidores;
+  uint64_t inicio, fin;
+  double segundos;
+  int i, primero;
+
+  bufferSegmentado = crearBufferSegmentado(tam);
+  if(bufferSegmentado.cola == NULL){
+    perror("[!] crearBufferSegmentado");
+    return;
+  }
+
+  productores = (HiloBench*) malloc(sizeof(HiloBench) * numProductores);
+  consumidores = (HiloBench*) malloc(sizeof(HiloBench) * numConsumidores);
+
+  pthread_mutex_init(&mutexSegmentado, NULL);
+  pthread_cond_init(&condSegmentadoNoLlena, NULL);
+  pthread_cond_init(&condSegmentadoNoVacia, NULL);
+  incrementarProduccionesSegmentado(&bufferSegmentado, operaciones);
+
+  inicio = ahora();
+
+  primero = 0;
+  for(i = 0; i < numProductores; i++){
+    productores[i].primero = primero;
+    productores[i].numItems = operaciones / numProductores +
+                              (i < operaciones % numProductores);
+    productores[i].lote = lote;
+    primero += productores[i].numItems;
+    pthread_create(&(productores[i].tid), NULL, (void*)productorSegmentado,
+                   productores+i);
+  }
+
+  for(i = 0; i < numConsumidores; i++){
+    consumidores[i].lote = lote;
+    pthread_create(&(consumidores[i].tid), NULL, (void*)consumidorSegmentado,
+                   consumidores+i);
+  }
+
+  for(i = 0; i < numProductores; i++){
+    pthread_join(productores[i].tid, NULL);
+  }
+  for(i = 0; i < numConsumidores; i++){
+    pthread_join(consumidores[i].tid, NULL);
+  }
+
+  fin = ahora();
+  segundos = (fin - inicio) / 1e9;
+
+  imprimirMedida("Segmentado", numProductores, numConsumidores, tam, lote,
+                 operaciones, segundos, latencias, operaciones);
+
+  destruirBufferSegmentado(&bufferSegmentado);
+  pthread_mutex_destroy(&mutexSegmentado);
+  pthread_cond_destroy(&condSegmentadoNoLlena);
+  pthread_cond_destroy(&condSegmentadoNoVacia);
+  free(productores);
+  free(consumidores);
+}
+
+void productorSegmentado(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int i, j, numItems;
+
+  for(i = 0; i < hilo->numItems; i += numItems){
+    numItems = hilo->numItems - i;
+    if(numItems > hilo->lote){
+      numItems = hilo->lote;
+    }
+    for(j = 0; j < numItems; j++){
+      items[j] = hilo->primero + i + j;
+      marcas[items[j]] = ahora();
+    }
+
+    // Solo se espera antes de empezar el lote: una vez por debajo del límite
+    // el lote se inserta completo
+    pthread_mutex_lock(&mutexSegmentado);
+    while(colaLlenaSegmentado(&bufferSegmentado)){
+      pthread_cond_wait(&condSegmentadoNoLlena, &mutexSegmentado);
+    }
+    if(insertarBufferSegmentadoN(&bufferSegmentado, items, numItems) <
+       numItems){
+      perror("[!] insertarBufferSegmentadoN");
+      exit(EXIT_FAILURE);
+    }
+    pthread_cond_broadcast(&condSegmentadoNoVacia);
+    pthread_mutex_unlock(&mutexSegmentado);
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidorSegmentado(HiloBench* hilo){
+  int items[MAX_LOTE];
+  int j, n;
+  uint64_t instante;
+
+  while(1){
+    pthread_mutex_lock(&mutexSegmentado);
+    while((n = sacarBufferSegmentadoN(&bufferSegmentado, items,
+                                      hilo->lote)) == 0){
+      if(obtenerProduccionesSegmentado(&bufferSegmentado) == 0){
+        pthread_cond_broadcast(&condSegmentadoNoVacia);
+        pthread_mutex_unlock(&mutexSegmentado);
+        pthread_exit(EXIT_SUCCESS);
+      }
+      pthread_cond_wait(&condSegmentadoNoVacia, &mutexSegmentado);
+    }
+    incrementarProduccionesSegmentado(&bufferSegmentado, -n);
+    pthread_cond_broadcast(&condSegmentadoNoLlena);
+    pthread_mutex_unlock(&mutexSegmentado);
+
+    instante = ahora();
+    for(j = 0; j < n; j++){
+      latencias[items[j]] = instante - marcas[items[j]];
+    }
+  }
+}
+
+void medirGenerico(int numProductores, int numConsumidores, int tam, int lote,
+                   int operaciones, int bytes){
+  HiloBench* productores;
+  HiloBench* consumidores;
+  uint64_t inicio, fin;
+  double segundos;
+  int i, primero;
+  char nombre[32];
+
+  bufferGenerico = crearBufferGenerico(tam, bytes);
+  if(bufferGenerico.datos == NULL){
+    perror("[!] crearBufferGenerico");
+    return;
+  }
+
+  productores = (HiloBench*) malloc(sizeof(HiloBench) * numProductores);
+  consumidores = (HiloBench*) malloc(sizeof(HiloBench) * numConsumidores);
+
+  pthread_mutex_init(&mutexGenerico, NULL);
+  pthread_cond_init(&condGenericoNoLlena, NULL);
+  pthread_cond_init(&condGenericoNoVacia, NULL);
+  pendientesGenerico = operaciones;
+
+  inicio = ahora();
+
+  primero = 0;
+  for(i = 0; i < numProductores; i++){
+    productores[i].primero = primero;
+    productores[i].numItems = operaciones / numProductores +
+                              (i < operaciones % numProductores);
+    productores[i].lote = lote;
+    primero += productores[i].numItems;
+    pthread_create(&(productores[i].tid), NULL, (void*)productorGenerico,
+                   productores+i);
+  }
+
+  for(i = 0; i < numConsumidores; i++){
+    consumidores[i].lote = lote;
+    pthread_create(&(consumidores[i].tid), NULL, (void*)consumidorGenerico,
+                   consumidores+i);
+  }
+
+  for(i = 0; i < numProductores; i++){
+    pthread_join(productores[i].tid, NULL);
+  }
+  for(i = 0; i < numConsumidores; i++){
+    pthread_join(consumidores[i].tid, NULL);
+  }
+
+  fin = ahora();
+  segundos = (fin - inicio) / 1e9;
+
+  // El tamaño de los elementos forma parte del nombre, ya que el CSV no tiene
+  // columna para él
+  snprintf(nombre, sizeof(nombre), "Generico-%dB", bytes);
+  imprimirMedida(nombre, numProductores, numConsumidores, tam, lote,
+                 operaciones, segundos, latencias, operaciones);
+
+  destruirBufferGenerico(&bufferGenerico);
+  pthread_mutex_destroy(&mutexGenerico);
+  pthread_cond_destroy(&condGenericoNoLlena);
+  pthread_cond_destroy(&condGenericoNoVacia);
+  free(productores);
+  free(consumidores);
+}
+
+void productorGenerico(HiloBench* hilo){
+  unsigned char* huecos[MAX_LOTE];
+  size_t bytes = bufferGenerico.tamElemento;
+  int i, j, numItems, item;
+
+  for(i = 0; i < hilo->numItems; i += numItems){
+    numItems = hilo->numItems - i;
+    if(numItems > hilo->lote){
+      numItems = hilo->lote;
+    }
+
+    // Se reservan tantos huecos del lote como estén libres, esperando solo
+    // mientras no haya ninguno
+    pthread_mutex_lock(&mutexGenerico);
+    while((huecos[0] = reservarHueco(&bufferGenerico)) == NULL){
+      pthread_cond_wait(&condGenericoNoLlena, &mutexGenerico);
+    }
+    for(j = 1; j < numItems; j++){
+      if((huecos[j] = reservarHueco(&bufferGenerico)) == NULL){
+        break;
+      }
+    }
+    numItems = j;
+    pthread_mutex_unlock(&mutexGenerico);
+
+    // Cada elemento se escribe directamente en su hueco: el número de item al
+    // principio y el resto del hueco relleno con su byte menos significativo
+    for(j = 0; j < numItems; j++){
+      item = hilo->primero + i + j;
+      memset(huecos[j] + sizeof(int), item & 0xff, bytes - sizeof(int));
+      memcpy(huecos[j], &item, sizeof(int));
+      marcas[item] = ahora();
+    }
+
+    // Los huecos se confirman en orden inverso, por lo que solo se publican
+    // cuando se confirma el primero
+    pthread_mutex_lock(&mutexGenerico);
+    for(j = numItems - 1; j >= 0; j--){
+      confirmarHueco(&bufferGenerico, huecos[j]);
+    }
+    pthread_cond_broadcast(&condGenericoNoVacia);
+    pthread_mutex_unlock(&mutexGenerico);
+  }
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidorGenerico(HiloBench* hilo){
+  unsigned char* huecos[MAX_LOTE];
+  size_t bytes = bufferGenerico.tamElemento;
+  int items[MAX_LOTE];
+  int j, n;
+  uint64_t instante;
+
+  while(1){
+    pthread_mutex_lock(&mutexGenerico);
+    while((huecos[0] = adquirirHueco(&bufferGenerico)) == NULL){
+      if(pendientesGenerico == 0){
+        pthread_cond_broadcast(&condGenericoNoVacia);
+        pthread_mutex_unlock(&mutexGenerico);
+        pthread_exit(EXIT_SUCCESS);
+      }
+      pthread_cond_wait(&condGenericoNoVacia, &mutexGenerico);
+    }
+    for(n = 1; n < hilo->lote; n++){
+      if((huecos[n] = adquirirHueco(&bufferGenerico)) == NULL){
+        break;
+      }
+    }
+    pendientesGenerico -= n;
+    pthread_mutex_unlock(&mutexGenerico);
+
+    // Cada elemento se lee directamente de su hueco, comprobando que el último
+    // byte corresponde al número de item
+    instante = ahora();
+    for(j = 0; j < n; j++){
+      memcpy(&items[j], huecos[j], sizeof(int));
+      if(bytes > sizeof(int) &&
+         huecos[j][bytes - 1] != (unsigned char)(items[j] & 0xff)){
+        fprintf(stderr, "[!] El hueco del item %d está corrupto\n", items[j]);
+        exit(EXIT_FAILURE);
+      }
+      latencias[items[j]] = instante - marcas[items[j]];
+    }
+
+    // Igual que las confirmaciones, las liberaciones se realizan en orden
+    // inverso
+    pthread_mutex_lock(&mutexGenerico);
+    for(j = n - 1; j >= 0; j--){
+      liberarHueco(&bufferGenerico, huecos[j]);
+    }
+    pthread_cond_broadcast(&condGenericoNoLlena);
+    pthread_mutex_unlock(&mutexGenerico);
+  }
+}
+
+void imprimirMedida(const char* nombre, int numProductores, int numConsumidores,
+                    int tam, int lote, int operaciones, double segundos,
+                    uint64_t* medidas, int numMedidas){
+  qsort(medidas, numMedidas, sizeof(uint64_t), compararLatencias);
+
+  printf("%s,%d,%d,%d,%d,%d,%.6f,%.0f,%lu,%lu,%lu\n",
+         nombre, numProductores, numConsumidores, tam, lote, operaciones,
+         segundos, operaciones / segundos,
+         (unsigned long)medidas[(numMedidas - 1) * 50 / 100],
+         (unsigned long)medidas[(numMedidas - 1) * 99 / 100],
+         (unsigned long)medidas[(numMedidas - 1) * 999 / 1000]);
+  fflush(stdout);
+}
+
+static inline uint64_t ahora(){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+int leerLista(char* texto, int* valores){
+  char* elemento;
+  int n = 0;
+
+  for(elemento = strtok(texto, ","); elemento != NULL;
+      elemento = strtok(NULL, ",")){
+    if(n == MAX_LISTA || atoi(elemento) < 1){
+      return 0;
+    }
+    valores[n++] = atoi(elemento);
+  }
+
+  return n;
+}
+
+int compararLatencias(const void* a, const void* b){
+  uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+int hayHueco(const void* buffer){
+  return numElementos((const Buffer*) buffer) < tamano((const Buffer*) buffer);
+}
+
+int hayElementos(const void* buffer){
+  return numElementos((const Buffer*) buffer) > 0;
+}
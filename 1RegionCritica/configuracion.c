@@ -0,0 +1,300 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include "configuracion.h"
+#include "registro.h"
+#include "espera.h"
+
+// Tipos de los parámetros de la configuración
+#define PARAMETRO_ENTERO 0
+#define PARAMETRO_TIEMPO 1
+#define PARAMETRO_ESTRATEGIA 2
+#define PARAMETRO_AFINIDAD 3
+#define PARAMETRO_RUTA 4
+
+// Tiempo máximo (en segundos) que se admite para los tiempos de los hilos
+#define MAX_TIEMPO 3600.0
+
+/*
+* Descripción de cada parámetro: clave, tipo, posición del campo dentro de la
+* estructura, rango de los enteros e indicación de si es uno de los parámetros
+* de los hilos por los que se pregunta al usuario
+*/
+typedef struct ST_PARAMETRO{
+	const char* clave;
+	int tipo;
+	size_t desplazamiento;
+	int minimo;
+	int maximo;
+	int deHilos;
+} Parametro;
+
+static const Parametro parametros[] = {
+	{"productores", PARAMETRO_ENTERO,
+			offsetof(Configuracion, numProductores), 1, MAX_FIBRAS, 0},
+	{"consumidores", PARAMETRO_ENTERO,
+			offsetof(Configuracion, numConsumidores), 1, MAX_FIBRAS, 0},
+	{"tam_buffer", PARAMETRO_ENTERO,
+			offsetof(Configuracion, tamBuffer), 1, 1 << 24, 0},
+	{"producciones", PARAMETRO_ENTERO,
+			offsetof(Configuracion, producciones), 0, INT_MAX, 1},
+	{"tiempo_produccion", PARAMETRO_TIEMPO,
+			offsetof(Configuracion, tiempoProduccion), 0, 0, 1},
+	{"tiempo_consumicion", PARAMETRO_TIEMPO,
+			offsetof(Configuracion, tiempoConsumicion), 0, 0, 1},
+	{"post_produccion", PARAMETRO_TIEMPO,
+			offsetof(Configuracion, postProduccion), 0, 0, 1},
+	{"post_consumicion", PARAMETRO_TIEMPO,
+			offsetof(Configuracion, postConsumicion), 0, 0, 1},
+	{"lote", PARAMETRO_ENTERO,
+			offsetof(Configuracion, lote), 1, MAX_LOTE, 0},
+	{"nivel", PARAMETRO_ENTERO,
+			offsetof(Configuracion, nivel), REGISTRO_DESACTIVADO,
+			REGISTRO_DETALLE, 0},
+	{"estrategia", PARAMETRO_ESTRATEGIA,
+			offsetof(Configuracion, estrategia), 0, 0, 0},
+	{"pausas", PARAMETRO_ENTERO,
+			offsetof(Configuracion, pausas), 0, INT_MAX, 0},
+	{"medir", PARAMETRO_ENTERO,
+			offsetof(Configuracion, medir), 0, 1, 0},
+	{"fragmentos", PARAMETRO_ENTERO,
+			offsetof(Configuracion, fragmentos), 1, 4096, 0},
+	{"afinidad", PARAMETRO_AFINIDAD,
+			offsetof(Configuracion, afinidad), 0, 0, 0},
+	{"trabajadores", PARAMETRO_ENTERO,
+			offsetof(Configuracion, trabajadores), 0, 4096, 0},
+	{"entrada", PARAMETRO_RUTA,
+			offsetof(Configuracion, entrada), 0, 0, 0},
+	{"salida", PARAMETRO_RUTA,
+			offsetof(Configuracion, salida), 1, 0, 0}
+};
+
+#define NUM_PARAMETROS (sizeof(parametros) / sizeof(parametros[0]))
+
+/*
+* Función que elimina los espacios del principio y del final de la cadena,
+* modificándola, y devuelve el nuevo principio
+*/
+static char* recortar(char* texto){
+	char* fin;
+
+	while(isspace((unsigned char) *texto)){
+		texto++;
+	}
+
+	fin = texto + strlen(texto);
+	while(fin > texto && isspace((unsigned char) fin[-1])){
+		fin--;
+	}
+	*fin = '\0';
+
+	return texto;
+}
+
+void iniciarConfiguracion(Configuracion* configuracion){
+	configuracion->numProductores = 1;
+	configuracion->numConsumidores = 1;
+	configuracion->tamBuffer = 10;
+	configuracion->producciones = 10;
+	configuracion->tiempoProduccion = 2;
+	configuracion->tiempoConsumicion = 1;
+	configuracion->postProduccion = -1;
+	configuracion->postConsumicion = -1;
+	configuracion->lote = 1;
+	configuracion->nivel = REGISTRO_DETALLE;
+	configuracion->estrategia = ESTRATEGIA_CONDICIONES;
+	configuracion->pausas = ESPERA_MAX_DEFECTO;
+	configuracion->medir = 0;
+	configuracion->fragmentos = 1;
+	strcpy(configuracion->afinidad, "ninguna");
+	configuracion->trabajadores = 0;
+	configuracion->entrada[0] = '\0';
+	strcpy(configuracion->salida, "/dev/null");
+	configuracion->parametrosHilos = 0;
+}
+
+int asignarConfiguracion(Configuracion* configuracion, const char* clave,
+		const char* valor){
+	const Parametro* parametro = NULL;
+	char* campo;
+	char* fin;
+	long entero;
+	double tiempo;
+	int i;
+
+	for(i = 0; i < NUM_PARAMETROS; i++){
+		if(strcmp(parametros[i].clave, clave) == 0){
+			parametro = &parametros[i];
+			break;
+		}
+	}
+	if(parametro == NULL){
+		fprintf(stderr, "[!] Parámetro desconocido: '%s'\n", clave);
+		return -1;
+	}
+
+	campo = (char*) configuracion + parametro->desplazamiento;
+
+	switch(parametro->tipo){
+		case PARAMETRO_ENTERO:
+		errno = 0;
+		entero = strtol(valor, &fin, 10);
+		if(fin == valor || *fin != '\0' || errno != 0 ||
+				entero < parametro->minimo || entero > parametro->maximo){
+			fprintf(stderr, "[!] El parámetro '%s' debe ser un entero entre %d y "
+					"%d (se ha indicado '%s')\n", clave, parametro->minimo,
+					parametro->maximo, valor);
+			return -1;
+		}
+		*(int*) campo = (int) entero;
+		break;
+
+		case PARAMETRO_TIEMPO:
+		// Los tiempos negativos indican un tiempo aleatorio
+		if(strcasecmp(valor, "aleatorio") == 0){
+			tiempo = -1;
+		} else {
+			errno = 0;
+			tiempo = strtod(valor, &fin);
+			if(fin == valor || *fin != '\0' || errno != 0 || tiempo != tiempo ||
+					tiempo > MAX_TIEMPO){
+				fprintf(stderr, "[!] El parámetro '%s' debe ser un número de "
+						"segundos no mayor que %.0f, o 'aleatorio' (se ha indicado "
+						"'%s')\n", clave, MAX_TIEMPO, valor);
+				return -1;
+			}
+			if(tiempo < 0){
+				tiempo = -1;
+			}
+		}
+		*(double*) campo = tiempo;
+		break;
+
+		case PARAMETRO_ESTRATEGIA:
+		if(strcmp(valor, "condiciones") == 0){
+			*(int*) campo = ESTRATEGIA_CONDICIONES;
+		} else if(strcmp(valor, "futex") == 0){
+			*(int*) campo = ESTRATEGIA_FUTEX;
+		} else if(strcmp(valor, "eventfd") == 0){
+			*(int*) campo = ESTRATEGIA_EVENTFD;
+		} else {
+			fprintf(stderr, "[!] La estrategia debe ser 'condiciones', 'futex' o "
+					"'eventfd' (se ha indicado '%s')\n", valor);
+			return -1;
+		}
+		break;
+
+		case PARAMETRO_AFINIDAD:
+		if(strlen(valor) >= MAX_TEXTO_AFINIDAD){
+			fprintf(stderr, "[!] La afinidad no puede tener más de %d "
+					"caracteres\n", MAX_TEXTO_AFINIDAD - 1);
+			return -1;
+		}
+		if(comprobarAfinidad(valor) != 0){
+			return -1;
+		}
+		strcpy(campo, valor);
+		break;
+
+		case PARAMETRO_RUTA:
+		// El mínimo indica si la ruta es obligatoria. Una entrada vacía indica
+		// que no se utiliza ningún fichero
+		if(strlen(valor) >= MAX_RUTA || (parametro->minimo && *valor == '\0')){
+			fprintf(stderr, "[!] El parámetro '%s' debe ser una ruta de entre %d "
+					"y %d caracteres\n", clave, parametro->minimo, MAX_RUTA - 1);
+			return -1;
+		}
+		strcpy(campo, valor);
+		break;
+	}
+
+	if(parametro->deHilos){
+		configuracion->parametrosHilos = 1;
+	}
+
+	return 0;
+}
+
+int leerConfiguracion(Configuracion* configuracion, const char* ruta){
+	FILE* fichero;
+	char linea[MAX_LINEA_CONFIGURACION];
+	char* texto;
+	char* igual;
+	char* comentario;
+	int numLinea = 0;
+	int resultado = 0;
+
+	fichero = fopen(ruta, "r");
+	if(fichero == NULL){
+		fprintf(stderr, "[!] No se puede abrir el fichero de configuración "
+				"'%s': %s\n", ruta, strerror(errno));
+		return -1;
+	}
+
+	while(resultado == 0 && fgets(linea, sizeof(linea), fichero) != NULL){
+		numLinea++;
+
+		// Una línea que no cabe en el buffer no termina en salto de línea
+		if(strchr(linea, '\n') == NULL && !feof(fichero)){
+			fprintf(stderr, "[!] %s:%d: la línea es demasiado larga\n", ruta,
+					numLinea);
+			resultado = -1;
+			break;
+		}
+
+		comentario = strchr(linea, '#');
+		if(comentario != NULL){
+			*comentario = '\0';
+		}
+
+		texto = recortar(linea);
+		if(*texto == '\0'){
+			continue;
+		}
+
+		igual = strchr(texto, '=');
+		if(igual == NULL){
+			fprintf(stderr, "[!] %s:%d: se esperaba 'clave = valor'\n", ruta,
+					numLinea);
+			resultado = -1;
+			break;
+		}
+		*igual = '\0';
+
+		if(asignarConfiguracion(configuracion, recortar(texto),
+				recortar(igual + 1)) != 0){
+			fprintf(stderr, "[!] %s:%d: valor no válido\n", ruta, numLinea);
+			resultado = -1;
+		}
+	}
+
+	fclose(fichero);
+	return resultado;
+}
+
+int comprobarConfiguracion(const Configuracion* configuracion){
+	if(configuracion->trabajadores == 0 &&
+			(configuracion->numProductores > MAX_HILOS ||
+			 configuracion->numConsumidores > MAX_HILOS)){
+		fprintf(stderr, "[!] Sin trabajadores cada productor y cada consumidor es "
+				"un hilo, por lo que no puede haber más de %d de cada tipo\n",
+				MAX_HILOS);
+		return -1;
+	}
+
+	return 0;
+}
+
+const char* nombreEstrategia(int estrategia){
+	if(estrategia == ESTRATEGIA_FUTEX){
+		return "futex";
+	} else if(estrategia == ESTRATEGIA_EVENTFD){
+		return "eventfd";
+	}
+	return "condiciones";
+}
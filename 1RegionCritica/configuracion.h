@@ -0,0 +1,170 @@
+#ifndef CONFIGURACION_H
+#define CONFIGURACION_H
+
+#include "afinidad.h"
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Configuracion reúne todos los parámetros de una ejecución del
+* programa: número de hilos, tamaño del buffer, producciones, tiempos de
+* trabajo, estrategia de sincronización, ubicación de los hilos y ficheros de
+* entrada y salida. Cada parámetro tiene una clave, y tanto las opciones de la
+* línea de comandos como las líneas de un fichero de configuración se asignan
+* mediante 'asignarConfiguracion', que comprueba el formato y el rango del
+* valor. Así el programa se puede ejecutar desde scripts sin preguntar nada al
+* usuario.
+*
+* El fichero de configuración tiene una asignación 'clave = valor' por línea.
+* Las líneas vacías y el texto a partir de '#' se ignoran.
+*
+* Los tiempos se indican en segundos y admiten decimales. Un tiempo negativo o
+* el valor 'aleatorio' indica que se escoja un tiempo aleatorio entre 0 y 4
+* segundos.
+*/
+
+// Número máximo de elementos de los lotes de productores y consumidores
+#define MAX_LOTE 256
+
+// Número máximo de productores o de consumidores cuando cada uno es un hilo
+#define MAX_HILOS 4096
+
+// Número máximo de productores o de consumidores cuando se ejecutan como
+// fibras sobre los trabajadores
+#define MAX_FIBRAS (1 << 20)
+
+// Tamaño máximo de una línea del fichero de configuración
+#define MAX_LINEA_CONFIGURACION 256
+
+// Tamaño máximo de las rutas de los ficheros de entrada y salida
+#define MAX_RUTA 256
+
+// Estrategias de sincronización para dormir a los hilos
+#define ESTRATEGIA_CONDICIONES 0 // Variables de condición
+#define ESTRATEGIA_FUTEX 1 // Eventos sobre futex
+#define ESTRATEGIA_EVENTFD 2 // Avisos sobre eventfd
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_CONFIGURACION
+* Campos (entre paréntesis la clave de cada uno):
+*		- numProductores (productores) y numConsumidores (consumidores): número
+*								de hilos de cada tipo
+*		- tamBuffer (tam_buffer): número de posiciones del buffer
+*		- producciones (producciones): producciones que realiza cada productor
+*		- tiempoProduccion (tiempo_produccion), tiempoConsumicion
+*								(tiempo_consumicion), postProduccion (post_produccion) y
+*								postConsumicion (post_consumicion): tiempos en segundos
+*		- lote (lote): número máximo de elementos por acceso al buffer
+*		- nivel (nivel): nivel de los mensajes que se muestran por pantalla
+*		- estrategia (estrategia): 'condiciones', 'futex' o 'eventfd'
+*		- pausas (pausas): máximo de pausas de la espera activa
+*		- medir (medir): 1 si se mide la duración de las fases de los hilos
+*		- fragmentos (fragmentos): número de fragmentos de la cola, en las
+*								implementaciones que los admiten
+*		- afinidad (afinidad): política de ubicación de los hilos en las CPUs
+*								(ver afinidad.h)
+*		- trabajadores (trabajadores): número de hilos sobre los que se ejecutan
+*								los productores y consumidores como fibras, en las
+*								implementaciones que lo admiten. Con 0 cada uno es un
+*								hilo
+*		- entrada (entrada) y salida (salida): con una entrada, los productores
+*								reparten sus líneas y los consumidores las escriben en
+*								la salida, en las implementaciones que lo admiten. Sin
+*								entrada se producen enteros aleatorios
+*		- parametrosHilos: 1 si se ha asignado algún tiempo o el número de
+*								producciones, en cuyo caso no se pregunta por ellos
+*/
+typedef struct ST_CONFIGURACION{
+	int numProductores;
+	int numConsumidores;
+	int tamBuffer;
+	int producciones;
+	double tiempoProduccion;
+	double tiempoConsumicion;
+	double postProduccion;
+	double postConsumicion;
+	int lote;
+	int nivel;
+	int estrategia;
+	int pausas;
+	int medir;
+	int fragmentos;
+	char afinidad[MAX_TEXTO_AFINIDAD];
+	int trabajadores;
+	char entrada[MAX_RUTA];
+	char salida[MAX_RUTA];
+	int parametrosHilos;
+} Configuracion;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: iniciarConfiguracion
+* Tipo: constructor
+* Función que asigna a todos los parámetros su valor por defecto: un productor
+* y un consumidor, buffer de 10 posiciones, 10 producciones por hilo, tiempos
+* de producción y consumición de 2 y 1 segundos, tiempos posteriores
+* aleatorios, lote 1, todos los mensajes, variables de condición, espera activa
+* por defecto, sin medir, un único fragmento, sin afinidad, un hilo por
+* productor y por consumidor, sin fichero de entrada y con '/dev/null' como
+* salida.
+*
+* Precondición : ninguna
+* Postcondición: la configuración tiene los valores por defecto
+*/
+void iniciarConfiguracion(Configuracion* configuracion);
+
+/*
+* Nombre: asignarConfiguracion
+* Tipo: modificador
+* Función que asigna el valor indicado al parámetro de la clave indicada. El
+* valor debe ser completo: no se admiten caracteres sobrantes.
+*
+* Precondición : la configuración debe haber sido iniciada
+* Postcondición: se devuelve 0 si el valor es válido y se ha asignado, y -1 en
+*								 caso contrario, tras escribir el motivo por la salida de
+*								 error
+*/
+int asignarConfiguracion(Configuracion* configuracion, const char* clave,
+		const char* valor);
+
+/*
+* Nombre: leerConfiguracion
+* Tipo: modificador
+* Función que asigna todos los parámetros del fichero de configuración
+* indicado, en el orden en el que aparecen.
+*
+* Precondición : la configuración debe haber sido iniciada
+* Postcondición: se devuelve 0 si el fichero es válido y -1 en caso contrario,
+*								 tras escribir por la salida de error el motivo y la línea
+*								 del fichero
+*/
+int leerConfiguracion(Configuracion* configuracion, const char* ruta);
+
+/*
+* Nombre: comprobarConfiguracion
+* Tipo: consulta
+* Función que comprueba las restricciones entre parámetros, que no se pueden
+* validar al asignar cada uno ya que dependen del orden en que se indiquen:
+* sin trabajadores cada productor y cada consumidor es un hilo, por lo que no
+* puede haber más de MAX_HILOS de cada tipo.
+*
+* Precondición : se deben haber asignado todos los parámetros
+* Postcondición: se devuelve 0 si la configuración es válida y -1 en caso
+*								 contrario, tras escribir el motivo por la salida de error
+*/
+int comprobarConfiguracion(const Configuracion* configuracion);
+
+/*
+* Nombre: nombreEstrategia
+* Tipo: consulta
+* Función que devuelve el nombre de la estrategia de sincronización indicada.
+*
+* Precondición : ninguna
+* Postcondición: se devuelve una cadena constante
+*/
+const char* nombreEstrategia(int estrategia);
+
+#endif
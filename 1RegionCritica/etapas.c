@@ -0,0 +1,536 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "buffer.h"
+#include "histograma.h"
+
+/*
+* Programa que encadena varias etapas, cada una con su propio Buffer de
+* entrada, su propio número de trabajadores y su propia función de trabajo. Un
+* hilo fuente inserta los items en el buffer de la primera etapa, y los
+* trabajadores de cada etapa los sacan de su buffer, les aplican la función de
+* la etapa y los insertan en el buffer de la siguiente. Los de la última etapa
+* los descartan.
+*
+* Cada buffer se protege con el mismo esquema de un mutex y dos variables de
+* condición que 'main.c', y las funciones de trabajo se aplican fuera de la
+* región crítica. Mientras se ejecuta, el hilo principal muestrea la ocupación
+* de cada buffer, y al finalizar se imprime por etapa la ocupación media, la
+* utilización de sus trabajadores, la capacidad que podría sostener y cuántas
+* veces se ha esperado a la cola vacía o llena, señalando el cuello de botella.
+*/
+
+// Número de items por defecto
+#define ITEMS 100000
+
+// Tamaño por defecto del buffer de cada etapa
+#define TAM_ETAPA 64
+
+// Tamaño máximo de los lotes de los trabajadores
+#define MAX_LOTE 256
+
+// Número máximo de etapas
+#define MAX_ETAPAS 16
+
+// Intervalo por defecto (en microsegundos) entre muestras de la ocupación
+#define INTERVALO_MUESTRAS 1000
+
+// Tipo de las funciones de trabajo de las etapas. Reciben el item y el
+// parámetro de la etapa y devuelven el item que pasa a la siguiente
+typedef int (*FuncionEtapa)(int item, double parametro);
+
+// Estructura utilizada para guardar la información de cada etapa
+typedef struct ST_ETAPA{
+  // Posición de la etapa en la cadena
+  int numero;
+
+  // Número de trabajadores de la etapa y sus TIDs
+  int numTrabajadores;
+  pthread_t* trabajadores;
+
+  // Función de trabajo, su nombre y su parámetro, tal y como se indicaron
+  FuncionEtapa trabajar;
+  const char* descripcion;
+  double parametro;
+
+  // Buffer del que sacan los items los trabajadores, mutex que lo protege y
+  // variables de condición en las que esperan quienes lo encuentran lleno o
+  // vacío
+  Buffer entrada;
+  pthread_mutex_t mutex;
+  pthread_cond_t noLlena;
+  pthread_cond_t noVacia;
+
+  // Hilos dormidos en cada variable de condición. Solo se modifican y consultan
+  // con el mutex bloqueado
+  int esperandoHueco;
+  int esperandoItems;
+
+  // Etapa en la que se insertan los items procesados, o NULL en la última
+  struct ST_ETAPA* siguiente;
+
+  // Estadísticas protegidas por el mutex: items procesados, tiempo total de
+  // trabajo de todos los trabajadores en nanosegundos y veces que se ha
+  // esperado a que el buffer tenga items o hueco
+  uint64_t procesados;
+  uint64_t tiempoTrabajo;
+  uint64_t esperasVacia;
+  uint64_t esperasLlena;
+
+  // Muestras de la ocupación del buffer tomadas por el hilo principal
+  uint64_t sumaOcupacion;
+  uint64_t numMuestras;
+} Etapa;
+
+// Etapas de la cadena, número de ellas, items que las atraviesan y número
+// máximo de items por acceso a cada buffer
+Etapa etapas[MAX_ETAPAS];
+int numEtapas = 0;
+int numItems = ITEMS;
+int lote = 1;
+
+// Número de trabajadores que aún no han terminado. El hilo principal muestrea
+// la ocupación mientras quede alguno
+atomic_int activos;
+
+/*
+* Funciones de trabajo disponibles: 'nada' devuelve el item, 'dormir' duerme el
+* número de segundos indicado en el parámetro (simulando una espera de E/S) y
+* 'calcular' realiza el número de iteraciones indicado de un generador
+* xorshift sobre el item (simulando trabajo de CPU)
+*/
+int nada(int item, double parametro);
+int dormir(int item, double parametro);
+int calcular(int item, double parametro);
+
+/*
+* Función que interpreta la descripción de una etapa, con el formato
+* 'trabajadores:funcion[:parametro]', y la asigna a la etapa indicada. Devuelve
+* 0 si es válida y -1 en caso contrario, tras escribir el motivo por la salida
+* de error
+*/
+int leerEtapa(const char* texto, Etapa* etapa);
+
+/*
+* Función que inserta los items indicados en el buffer de la etapa, durmiendo
+* en su variable de condición mientras esté lleno
+*/
+void insertarEtapa(Etapa* etapa, const int* items, int n);
+
+/*
+* Función que indica que uno de los productores de la etapa (el hilo fuente o
+* un trabajador de la anterior) ha terminado. El último en hacerlo cierra su
+* buffer y despierta a todos los trabajadores dormidos de la etapa
+*/
+void terminarEtapa(Etapa* etapa);
+
+/*
+* Función asociada al hilo fuente, que inserta todos los items en la primera
+* etapa
+*/
+void fuente(void* argumento);
+
+/*
+* Función asociada a los trabajadores de cada etapa
+*/
+void trabajador(Etapa* etapa);
+
+/*
+* Función que imprime las estadísticas de cada etapa y señala la de mayor
+* utilización
+*/
+void imprimirEtapas(double segundos);
+
+int main(int argc, char *argv[]){
+  pthread_t tidFuente;
+  int tam = TAM_ETAPA;
+  int intervalo = INTERVALO_MUESTRAS;
+  struct timespec espera;
+  uint64_t inicio;
+  int opcion;
+  int i, j;
+
+  while((opcion = getopt(argc, argv, "hn:b:l:i:")) != -1){
+    switch(opcion){
+      case 'h':
+      printf("Modo de uso: %s [-n items] [-b tam] [-l lote] [-i intervalo] "
+             "<etapa> [<etapa> ...]\n"
+             "\t-> etapa: 'trabajadores:funcion[:parametro]', donde la función "
+                  "es 'nada', 'dormir' (parámetro en segundos) o 'calcular' "
+                  "(parámetro en iteraciones). Como mucho %d etapas\n"
+             "\t-> items: items que atraviesan todas las etapas (por defecto "
+                  "%d)\n"
+             "\t-> tam: número de posiciones del buffer de cada etapa (por "
+                  "defecto %d)\n"
+             "\t-> lote: items por acceso a cada buffer (entre 1 y %d, por "
+                  "defecto 1)\n"
+             "\t-> intervalo: microsegundos entre muestras de la ocupación de "
+                  "los buffers (por defecto %d)\n",
+             argv[0], MAX_ETAPAS, ITEMS, TAM_ETAPA, MAX_LOTE,
+             INTERVALO_MUESTRAS);
+      exit(EXIT_SUCCESS);
+      break;
+
+      case 'n':
+      numItems = atoi(optarg);
+      if(numItems < 1){
+        fprintf(stderr, "[!] El número de items debe ser positivo\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      case 'b':
+      tam = atoi(optarg);
+      if(tam < 1){
+        fprintf(stderr, "[!] El tamaño del buffer debe ser positivo\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      case 'l':
+      lote = atoi(optarg);
+      if(lote < 1 || lote > MAX_LOTE){
+        fprintf(stderr, "[!] El lote debe estar entre 1 y %d\n", MAX_LOTE);
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      case 'i':
+      intervalo = atoi(optarg);
+      if(intervalo < 1){
+        fprintf(stderr, "[!] El intervalo debe ser positivo\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+      default:
+      fprintf(stderr, "Utiliza %s -h para ver el modo de uso\n", argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  numEtapas = argc - optind;
+  if(numEtapas < 1 || numEtapas > MAX_ETAPAS){
+    fprintf(stderr, "[!] Se deben indicar entre 1 y %d etapas\nUtiliza %s -h "
+                    "para ver el modo de uso\n", MAX_ETAPAS, argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  // Se validan todas las etapas antes de crear ningún hilo
+  for(i = 0; i < numEtapas; i++){
+    etapas[i].numero = i;
+    if(leerEtapa(argv[optind + i], &etapas[i]) != 0){
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // Los productores del buffer de cada etapa son los trabajadores de la
+  // anterior, o el hilo fuente en la primera. Se registran antes de crear
+  // ningún hilo, y los trabajadores de una etapa terminan cuando encuentran
+  // su buffer cerrado y vacío, igual que los consumidores de 'main.c'
+  atomic_init(&activos, 0);
+  for(i = 0; i < numEtapas; i++){
+    etapas[i].entrada = crearBuffer(tam);
+    registrarProductores(&etapas[i].entrada,
+                         i == 0 ? 1 : etapas[i - 1].numTrabajadores);
+    pthread_mutex_init(&etapas[i].mutex, NULL);
+    pthread_cond_init(&etapas[i].noLlena, NULL);
+    pthread_cond_init(&etapas[i].noVacia, NULL);
+    etapas[i].esperandoHueco = 0;
+    etapas[i].esperandoItems = 0;
+    etapas[i].siguiente = i + 1 < numEtapas ? &etapas[i + 1] : NULL;
+    etapas[i].procesados = 0;
+    etapas[i].tiempoTrabajo = 0;
+    etapas[i].esperasVacia = 0;
+    etapas[i].esperasLlena = 0;
+    etapas[i].sumaOcupacion = 0;
+    etapas[i].numMuestras = 0;
+    etapas[i].trabajadores = (pthread_t*) malloc(sizeof(pthread_t) *
+                                                 etapas[i].numTrabajadores);
+    atomic_fetch_add(&activos, etapas[i].numTrabajadores);
+  }
+
+  inicio = instanteMonotono();
+
+  for(i = 0; i < numEtapas; i++){
+    for(j = 0; j < etapas[i].numTrabajadores; j++){
+      pthread_create(&etapas[i].trabajadores[j], NULL, (void*)trabajador,
+                     etapas + i);
+    }
+  }
+  pthread_create(&tidFuente, NULL, (void*)fuente, NULL);
+
+  // Mientras quede algún trabajador se muestrea la ocupación de los buffers.
+  // Solo se consultan sus índices atómicos, por lo que no se bloquea ningún
+  // mutex
+  espera.tv_sec = intervalo / 1000000;
+  espera.tv_nsec = (intervalo % 1000000) * 1000L;
+  while(atomic_load(&activos) > 0){
+    for(i = 0; i < numEtapas; i++){
+      etapas[i].sumaOcupacion += numElementos(&etapas[i].entrada);
+      etapas[i].numMuestras++;
+    }
+    while(nanosleep(&espera, &espera) != 0 && errno == EINTR);
+    espera.tv_sec = intervalo / 1000000;
+    espera.tv_nsec = (intervalo % 1000000) * 1000L;
+  }
+
+  pthread_join(tidFuente, NULL);
+  for(i = 0; i < numEtapas; i++){
+    for(j = 0; j < etapas[i].numTrabajadores; j++){
+      pthread_join(etapas[i].trabajadores[j], NULL);
+    }
+  }
+
+  imprimirEtapas((instanteMonotono() - inicio) / 1e9);
+
+  for(i = 0; i < numEtapas; i++){
+    destruirBuffer(&etapas[i].entrada);
+    pthread_mutex_destroy(&etapas[i].mutex);
+    pthread_cond_destroy(&etapas[i].noLlena);
+    pthread_cond_destroy(&etapas[i].noVacia);
+    free(etapas[i].trabajadores);
+  }
+
+  exit(EXIT_SUCCESS);
+}
+
+int leerEtapa(const char* texto, Etapa* etapa){
+  const char* nombre;
+  char* fin;
+  size_t longitud;
+  long trabajadores;
+
+  errno = 0;
+  trabajadores = strtol(texto, &fin, 10);
+  if(fin == texto || *fin != ':' || errno != 0 || trabajadores < 1 ||
+     trabajadores > 4096){
+    fprintf(stderr, "[!] La etapa %d ('%s') debe empezar por un número de "
+                    "trabajadores entre 1 y 4096 seguido de ':'\n",
+            etapa->numero, texto);
+    return -1;
+  }
+  etapa->numTrabajadores = (int) trabajadores;
+
+  // El nombre de la función llega hasta el siguiente ':' o el final
+  nombre = fin + 1;
+  longitud = strcspn(nombre, ":");
+  etapa->descripcion = nombre;
+  etapa->parametro = 0;
+
+  if(longitud == 4 && strncmp(nombre, "nada", 4) == 0){
+    etapa->trabajar = nada;
+  } else if(longitud == 6 && strncmp(nombre, "dormir", 6) == 0){
+    etapa->trabajar = dormir;
+  } else if(longitud == 8 && strncmp(nombre, "calcular", 8) == 0){
+    etapa->trabajar = calcular;
+  } else {
+    fprintf(stderr, "[!] La función de la etapa %d ('%s') debe ser 'nada', "
+                    "'dormir' o 'calcular'\n", etapa->numero, texto);
+    return -1;
+  }
+
+  if(nombre[longitud] == ':'){
+    errno = 0;
+    etapa->parametro = strtod(nombre + longitud + 1, &fin);
+    if(fin == nombre + longitud + 1 || *fin != '\0' || errno != 0 ||
+       !(etapa->parametro >= 0)){
+      fprintf(stderr, "[!] El parámetro de la etapa %d ('%s') debe ser un "
+                      "número no negativo\n", etapa->numero, texto);
+      return -1;
+    }
+  } else if(etapa->trabajar != nada){
+    fprintf(stderr, "[!] La función de la etapa %d ('%s') necesita un "
+                    "parámetro\n", etapa->numero, texto);
+    return -1;
+  }
+
+  return 0;
+}
+
+void insertarEtapa(Etapa* etapa, const int* items, int n){
+  int insertados, insertadosAhora;
+
+  pthread_mutex_lock(&etapa->mutex);
+  for(insertados = 0; insertados < n; insertados += insertadosAhora){
+    while(colaLlena(&etapa->entrada)){
+      etapa->esperasLlena++;
+      etapa->esperandoHueco++;
+      pthread_cond_wait(&etapa->noLlena, &etapa->mutex);
+      etapa->esperandoHueco--;
+    }
+
+    insertadosAhora = insertarBufferN(&etapa->entrada, items + insertados,
+                                      n - insertados);
+
+    // Se despierta a un trabajador, o a todos si hay más de un item nuevo
+    if(etapa->esperandoItems > 0){
+      if(insertadosAhora > 1){
+        pthread_cond_broadcast(&etapa->noVacia);
+      } else {
+        pthread_cond_signal(&etapa->noVacia);
+      }
+    }
+  }
+  pthread_mutex_unlock(&etapa->mutex);
+}
+
+void terminarEtapa(Etapa* etapa){
+  pthread_mutex_lock(&etapa->mutex);
+  if(terminarProductor(&etapa->entrada)){
+    pthread_cond_broadcast(&etapa->noVacia);
+  }
+  pthread_mutex_unlock(&etapa->mutex);
+}
+
+void fuente(void* argumento){
+  int items[MAX_LOTE];
+  int i, j, n;
+
+  for(i = 0; i < numItems; i += n){
+    n = numItems - i < lote ? numItems - i : lote;
+    for(j = 0; j < n; j++){
+      items[j] = i + j;
+    }
+    insertarEtapa(&etapas[0], items, n);
+  }
+  terminarEtapa(&etapas[0]);
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void trabajador(Etapa* etapa){
+  int items[MAX_LOTE];
+  int j, n;
+
+  // Estadísticas locales, que se añaden a las de la etapa al terminar
+  uint64_t inicio;
+  uint64_t procesados = 0;
+  uint64_t tiempoTrabajo = 0;
+
+  while(1){
+    pthread_mutex_lock(&etapa->mutex);
+    while(colaVacia(&etapa->entrada)){
+      // Cuando el buffer está cerrado y vacío el trabajador termina, y como
+      // productor de la siguiente etapa se lo indica. Quien cerró el buffer
+      // ya despertó al resto de trabajadores dormidos
+      if(bufferAgotado(&etapa->entrada)){
+        etapa->procesados += procesados;
+        etapa->tiempoTrabajo += tiempoTrabajo;
+        pthread_mutex_unlock(&etapa->mutex);
+
+        if(etapa->siguiente != NULL){
+          terminarEtapa(etapa->siguiente);
+        }
+        atomic_fetch_sub(&activos, 1);
+        pthread_exit(EXIT_SUCCESS);
+      }
+
+      etapa->esperasVacia++;
+      etapa->esperandoItems++;
+      pthread_cond_wait(&etapa->noVacia, &etapa->mutex);
+      etapa->esperandoItems--;
+    }
+
+    n = sacarBufferN(&etapa->entrada, items, lote);
+
+    if(etapa->esperandoHueco > 0){
+      if(n > 1){
+        pthread_cond_broadcast(&etapa->noLlena);
+      } else {
+        pthread_cond_signal(&etapa->noLlena);
+      }
+    }
+    pthread_mutex_unlock(&etapa->mutex);
+
+    // La función de trabajo se aplica fuera de la región crítica
+    inicio = instanteMonotono();
+    for(j = 0; j < n; j++){
+      items[j] = etapa->trabajar(items[j], etapa->parametro);
+    }
+    tiempoTrabajo += instanteMonotono() - inicio;
+    procesados += n;
+
+    if(etapa->siguiente != NULL){
+      insertarEtapa(etapa->siguiente, items, n);
+    }
+  }
+}
+
+void imprimirEtapas(double segundos){
+  double ocupacion, utilizacion, capacidad;
+  double maximaUtilizacion = -1;
+  int cuello = 0;
+  int i;
+
+  printf("[i] %d items atraviesan %d etapas en %.3f s: %.0f items/s\n",
+         numItems, numEtapas, segundos, numItems / segundos);
+  printf("etapa,trabajadores,funcion,procesados,ocupacion_media,tam,"
+         "utilizacion,capacidad_items_seg,esperas_vacia,esperas_llena\n");
+
+  for(i = 0; i < numEtapas; i++){
+    // Ocupación media del buffer de entrada, fracción del tiempo que los
+    // trabajadores han estado aplicando la función, e items por segundo que
+    // podría procesar la etapa si sus trabajadores nunca esperasen
+    ocupacion = etapas[i].numMuestras > 0 ?
+                (double) etapas[i].sumaOcupacion / etapas[i].numMuestras : 0;
+    utilizacion = etapas[i].tiempoTrabajo /
+                  (segundos * 1e9 * etapas[i].numTrabajadores);
+    capacidad = etapas[i].tiempoTrabajo > 0 ?
+                etapas[i].procesados * etapas[i].numTrabajadores /
+                (etapas[i].tiempoTrabajo / 1e9) : 0;
+
+    printf("%d,%d,%s,%lu,%.2f,%d,%.3f,%.0f,%lu,%lu\n", i,
+           etapas[i].numTrabajadores, etapas[i].descripcion,
+           (unsigned long) etapas[i].procesados, ocupacion,
+           tamano(&etapas[i].entrada), utilizacion, capacidad,
+           (unsigned long) etapas[i].esperasVacia,
+           (unsigned long) etapas[i].esperasLlena);
+
+    if(utilizacion > maximaUtilizacion){
+      maximaUtilizacion = utilizacion;
+      cuello = i;
+    }
+  }
+
+  // La etapa cuyos trabajadores pasan más tiempo trabajando es la que limita
+  // el rendimiento: su buffer de entrada tiende a estar lleno y los de las
+  // siguientes vacíos
+  printf("[i] Cuello de botella: etapa %d (%s), utilización %.1f%%\n", cuello,
+         etapas[cuello].descripcion, maximaUtilizacion * 100);
+}
+
+int nada(int item, double parametro){
+  return item;
+}
+
+int dormir(int item, double parametro){
+  struct timespec tiempo;
+
+  tiempo.tv_sec = (time_t) parametro;
+  tiempo.tv_nsec = (long) ((parametro - tiempo.tv_sec) * 1e9);
+  while(nanosleep(&tiempo, &tiempo) != 0 && errno == EINTR);
+
+  return item;
+}
+
+int calcular(int item, double parametro){
+  uint32_t x = (uint32_t) item | 1;
+  long i;
+
+  for(i = 0; i < (long) parametro; i++){
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+  }
+
+  // Se conserva el item, pero el resultado se utiliza para que el compilador
+  // no elimine el bucle
+  return x == 0 ? -item : item;
+}
@@ -0,0 +1,68 @@
+#include <limits.h>
+#include <sched.h>
+#include "evento.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+void iniciarEvento(Evento* evento){
+	atomic_init(&evento->secuencia, 0);
+	atomic_init(&evento->esperando, 0);
+}
+
+uint32_t prepararEspera(Evento* evento){
+	atomic_fetch_add_explicit(&evento->esperando, 1, memory_order_seq_cst);
+
+	// La barrera asegura que, o bien el hilo que notifica ve que este hilo está
+	// esperando, o bien este hilo ve el cambio de la condición al comprobarla
+	// de nuevo
+	atomic_thread_fence(memory_order_seq_cst);
+
+	return atomic_load_explicit(&evento->secuencia, memory_order_acquire);
+}
+
+void esperarEvento(Evento* evento, uint32_t ticket){
+#ifdef __linux__
+	// El núcleo solo duerme al hilo si la secuencia sigue valiendo 'ticket', por
+	// lo que una notificación anterior hace que la llamada vuelva inmediatamente
+	syscall(SYS_futex, &evento->secuencia, FUTEX_WAIT_PRIVATE, ticket, NULL,
+			NULL, 0);
+#else
+	while(atomic_load_explicit(&evento->secuencia, memory_order_acquire) ==
+			ticket){
+		sched_yield();
+	}
+#endif
+
+	atomic_fetch_sub_explicit(&evento->esperando, 1, memory_order_relaxed);
+}
+
+void cancelarEspera(Evento* evento){
+	atomic_fetch_sub_explicit(&evento->esperando, 1, memory_order_relaxed);
+}
+
+int notificarEvento(Evento* evento, int n){
+	// Pareja de la barrera de 'prepararEspera'
+	atomic_thread_fence(memory_order_seq_cst);
+
+	// Si no hay nadie esperando no se realiza ninguna llamada al sistema
+	if(atomic_load_explicit(&evento->esperando, memory_order_relaxed) == 0){
+		return 0;
+	}
+
+	atomic_fetch_add_explicit(&evento->secuencia, 1, memory_order_release);
+
+#ifdef __linux__
+	syscall(SYS_futex, &evento->secuencia, FUTEX_WAKE_PRIVATE, n, NULL, NULL,
+			0);
+#endif
+
+	return 1;
+}
+
+int notificarTodos(Evento* evento){
+	return notificarEvento(evento, INT_MAX);
+}
@@ -0,0 +1,120 @@
+#ifndef EVENTO_H
+#define EVENTO_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Evento permite a un hilo dormir hasta que otro le notifique que la
+* condición que esperaba (por ejemplo, que la cola deje de estar llena) puede
+* haber cambiado. A diferencia de las variables de condición no tiene un mutex
+* asociado: en Linux el hilo duerme directamente con la llamada al sistema
+* 'futex' sobre la palabra 'secuencia', por lo que despertarlo cuesta una única
+* llamada al sistema y el hilo despertado no tiene que volver a obtener ningún
+* mutex antes de continuar. En otros sistemas el hilo cede la CPU hasta que la
+* secuencia cambie.
+*
+* El uso es el siguiente:
+*		1. El hilo que espera llama a 'prepararEspera', que le devuelve un ticket.
+*		2. Vuelve a comprobar su condición. Si ya se cumple llama a
+*			 'cancelarEspera', y en caso contrario a 'esperarEvento' con el ticket.
+*		3. El hilo que cambia la condición llama a 'notificarEvento' después de
+*			 cambiarla.
+*
+* Cualquier notificación posterior a 'prepararEspera' cambia la secuencia, por
+* lo que 'esperarEvento' vuelve inmediatamente y la notificación no se pierde.
+* Si no hay ningún hilo esperando, notificar no realiza ninguna llamada al
+* sistema.
+*/
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_EVENTO
+* Campos:
+*		- secuencia: palabra de 32 bits sobre la que duermen los hilos. Se
+*								 incrementa en cada notificación con hilos esperando
+*		- esperando: número de hilos que han preparado una espera y aún no la han
+*								 terminado
+*/
+typedef struct ST_EVENTO{
+	_Atomic uint32_t secuencia;
+	atomic_int esperando;
+} Evento;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: iniciarEvento
+* Tipo: constructor
+* Función que inicia el evento sin ningún hilo esperando.
+*
+* Precondición : ningún hilo está utilizando el evento
+* Postcondición: el evento puede ser utilizado
+*/
+void iniciarEvento(Evento* evento);
+
+/*
+* Nombre: prepararEspera
+* Tipo: modificador
+* Función que anuncia que el hilo va a esperar en el evento y devuelve el
+* ticket que debe pasar a 'esperarEvento'. La condición se debe comprobar de
+* nuevo después de llamar a esta función.
+*
+* Precondición : el evento debe haber sido iniciado con 'iniciarEvento'
+* Postcondición: el hilo cuenta como esperando hasta que llame a
+*								 'esperarEvento' o 'cancelarEspera'
+*/
+uint32_t prepararEspera(Evento* evento);
+
+/*
+* Nombre: esperarEvento
+* Tipo: modificador
+* Función que duerme al hilo hasta que se produzca una notificación posterior a
+* la obtención del ticket indicado. Puede volver sin notificación, por lo que
+* la condición se debe comprobar de nuevo al volver.
+*
+* Precondición : ticket obtenido con 'prepararEspera' sobre el mismo evento
+* Postcondición: el hilo deja de contar como esperando
+*/
+void esperarEvento(Evento* evento, uint32_t ticket);
+
+/*
+* Nombre: cancelarEspera
+* Tipo: modificador
+* Función que anula una espera preparada cuya condición ya se cumple.
+*
+* Precondición : espera preparada con 'prepararEspera' sobre el mismo evento
+* Postcondición: el hilo deja de contar como esperando
+*/
+void cancelarEspera(Evento* evento);
+
+/*
+* Nombre: notificarEvento
+* Tipo: modificador
+* Función que despierta como mucho a 'n' hilos que esperan en el evento. Se
+* debe llamar después de cambiar la condición que esperan, y no es necesario
+* tener ningún mutex bloqueado.
+*
+* Precondición : el evento debe haber sido iniciado con 'iniciarEvento'
+* Postcondición: las esperas preparadas antes de la llamada no se pierden. Se
+*								 devuelve 1 si había algún hilo esperando y 0 en caso
+*								 contrario
+*/
+int notificarEvento(Evento* evento, int n);
+
+/*
+* Nombre: notificarTodos
+* Tipo: modificador
+* Función que despierta a todos los hilos que esperan en el evento.
+*
+* Precondición : el evento debe haber sido iniciado con 'iniciarEvento'
+* Postcondición: las esperas preparadas antes de la llamada no se pierden. Se
+*								 devuelve 1 si había algún hilo esperando y 0 en caso
+*								 contrario
+*/
+int notificarTodos(Evento* evento);
+
+#endif
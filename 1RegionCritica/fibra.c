@@ -0,0 +1,424 @@
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "fibra.h"
+
+// Acciones que el trabajador completa cuando una fibra le devuelve el control.
+// Se realizan desde la pila del trabajador porque hasta entonces la fibra
+// sigue ejecutándose en la suya
+#define ACCION_CEDER 0 // La fibra vuelve a la cola de listas
+#define ACCION_DORMIR 1 // La fibra pasa al montículo de dormidas
+#define ACCION_ESPERAR 2 // La fibra pasa a la condición y se libera el mutex
+#define ACCION_TERMINAR 3 // Se libera la pila de la fibra
+
+/*
+* Estado de cada hilo trabajador. Solo lo utilizan el propio trabajador y la
+* fibra que está ejecutando
+*/
+typedef struct ST_TRABAJADOR{
+	Planificador* planificador;
+	ucontext_t contexto;
+	Fibra* actual;
+	int accion;
+	CondicionFibra* condicion;
+	pthread_mutex_t* mutex;
+} Trabajador;
+
+// Trabajador del hilo actual, o NULL si el hilo no es un trabajador
+static __thread Trabajador* trabajadorActual = NULL;
+
+/*
+* Función que devuelve el trabajador del hilo actual. Una fibra puede continuar
+* en un trabajador distinto tras suspenderse, por lo que la dirección de la
+* variable del hilo no se puede reutilizar de una llamada a otra
+*/
+static __attribute__((noinline)) Trabajador* obtenerTrabajador(){
+	__asm__ __volatile__("" ::: "memory");
+	return trabajadorActual;
+}
+
+// Instante actual del reloj monótono en nanosegundos
+static uint64_t ahora(){
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t) t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/*
+* Funciones del montículo de fibras dormidas. Se deben llamar con el mutex del
+* planificador bloqueado
+*/
+static void insertarDormida(Planificador* planificador, Fibra* fibra){
+	Fibra* aux;
+	int i, padre;
+
+	if(planificador->numDormidas == planificador->capacidadDormidas){
+		planificador->capacidadDormidas = planificador->capacidadDormidas == 0 ?
+				64 : planificador->capacidadDormidas * 2;
+		planificador->dormidas = (Fibra**) realloc(planificador->dormidas,
+				sizeof(Fibra*) * planificador->capacidadDormidas);
+	}
+
+	i = planificador->numDormidas++;
+	planificador->dormidas[i] = fibra;
+	while(i > 0){
+		padre = (i - 1) / 2;
+		if(planificador->dormidas[padre]->plazo <=
+				planificador->dormidas[i]->plazo){
+			break;
+		}
+		aux = planificador->dormidas[padre];
+		planificador->dormidas[padre] = planificador->dormidas[i];
+		planificador->dormidas[i] = aux;
+		i = padre;
+	}
+}
+
+static Fibra* extraerDormida(Planificador* planificador){
+	Fibra** dormidas = planificador->dormidas;
+	Fibra* primera = dormidas[0];
+	Fibra* aux;
+	int i = 0, hijo;
+
+	dormidas[0] = dormidas[--planificador->numDormidas];
+	while((hijo = 2 * i + 1) < planificador->numDormidas){
+		if(hijo + 1 < planificador->numDormidas &&
+				dormidas[hijo + 1]->plazo < dormidas[hijo]->plazo){
+			hijo++;
+		}
+		if(dormidas[i]->plazo <= dormidas[hijo]->plazo){
+			break;
+		}
+		aux = dormidas[i];
+		dormidas[i] = dormidas[hijo];
+		dormidas[hijo] = aux;
+		i = hijo;
+	}
+
+	return primera;
+}
+
+/*
+* Función que añade una fibra al final de la cola de listas. Se debe llamar
+* con el mutex del planificador bloqueado
+*/
+static void encolarLista(Planificador* planificador, Fibra* fibra){
+	fibra->siguiente = NULL;
+	if(planificador->ultima == NULL){
+		planificador->primera = fibra;
+	} else {
+		planificador->ultima->siguiente = fibra;
+	}
+	planificador->ultima = fibra;
+}
+
+/*
+* Función que devuelve la siguiente fibra a ejecutar, esperando a que haya
+* alguna lista, o NULL si ya han terminado todas
+*/
+static Fibra* siguienteFibra(Planificador* planificador){
+	Fibra* fibra = NULL;
+	struct timespec plazo;
+	uint64_t instante;
+
+	pthread_mutex_lock(&planificador->mutex);
+	while(1){
+		// Las fibras cuyo plazo ha vencido pasan a la cola de listas
+		instante = ahora();
+		while(planificador->numDormidas > 0 &&
+				planificador->dormidas[0]->plazo <= instante){
+			encolarLista(planificador, extraerDormida(planificador));
+		}
+
+		if(planificador->primera != NULL){
+			fibra = planificador->primera;
+			planificador->primera = fibra->siguiente;
+			if(planificador->primera == NULL){
+				planificador->ultima = NULL;
+			}
+			break;
+		}
+
+		if(planificador->activas == 0){
+			break;
+		}
+
+		if(planificador->numDormidas > 0){
+			instante = planificador->dormidas[0]->plazo;
+			plazo.tv_sec = instante / 1000000000ULL;
+			plazo.tv_nsec = instante % 1000000000ULL;
+			pthread_cond_timedwait(&planificador->hayTrabajo,
+					&planificador->mutex, &plazo);
+		} else {
+			pthread_cond_wait(&planificador->hayTrabajo, &planificador->mutex);
+		}
+	}
+	pthread_mutex_unlock(&planificador->mutex);
+
+	return fibra;
+}
+
+/*
+* Función que completa la acción que la fibra indicada ha pedido al devolver el
+* control a su trabajador
+*/
+static void completarAccion(Trabajador* trabajador, Fibra* fibra){
+	Planificador* planificador = trabajador->planificador;
+	CondicionFibra* condicion;
+
+	switch(trabajador->accion){
+		case ACCION_CEDER:
+		pthread_mutex_lock(&planificador->mutex);
+		encolarLista(planificador, fibra);
+		pthread_cond_signal(&planificador->hayTrabajo);
+		pthread_mutex_unlock(&planificador->mutex);
+		break;
+
+		case ACCION_DORMIR:
+		pthread_mutex_lock(&planificador->mutex);
+		insertarDormida(planificador, fibra);
+		// Si es la primera en despertar, los trabajadores que esperan deben
+		// recalcular su plazo
+		if(planificador->dormidas[0] == fibra){
+			pthread_cond_broadcast(&planificador->hayTrabajo);
+		}
+		pthread_mutex_unlock(&planificador->mutex);
+		break;
+
+		case ACCION_ESPERAR:
+		// El trabajador sigue teniendo bloqueado el mutex de la condición, por
+		// lo que ninguna notificación puede producirse hasta liberarlo
+		condicion = trabajador->condicion;
+		fibra->siguiente = NULL;
+		if(condicion->ultima == NULL){
+			condicion->primera = fibra;
+		} else {
+			condicion->ultima->siguiente = fibra;
+		}
+		condicion->ultima = fibra;
+		pthread_mutex_unlock(trabajador->mutex);
+		break;
+
+		case ACCION_TERMINAR:
+		munmap(fibra->pila, fibra->tamPila);
+		free(fibra);
+		pthread_mutex_lock(&planificador->mutex);
+		planificador->activas--;
+		if(planificador->activas == 0){
+			pthread_cond_broadcast(&planificador->hayTrabajo);
+		}
+		pthread_mutex_unlock(&planificador->mutex);
+		break;
+	}
+}
+
+/*
+* Función que ejecuta cada trabajador hasta que terminan todas las fibras
+*/
+static void* trabajar(void* argumento){
+	Trabajador trabajador;
+	Fibra* fibra;
+
+	trabajador.planificador = (Planificador*) argumento;
+	trabajadorActual = &trabajador;
+
+	while((fibra = siguienteFibra(trabajador.planificador)) != NULL){
+		trabajador.actual = fibra;
+		trabajador.accion = ACCION_CEDER;
+		swapcontext(&trabajador.contexto, &fibra->contexto);
+		completarAccion(&trabajador, fibra);
+	}
+
+	trabajadorActual = NULL;
+	return NULL;
+}
+
+/*
+* Función con la que empieza cada fibra. Ejecuta su función y devuelve el
+* control al trabajador para que libere la pila, por lo que nunca retorna
+*/
+static void iniciarFibra(){
+	Trabajador* trabajador = obtenerTrabajador();
+	Fibra* fibra = trabajador->actual;
+
+	fibra->funcion(fibra->argumento);
+
+	trabajador = obtenerTrabajador();
+	trabajador->accion = ACCION_TERMINAR;
+	setcontext(&trabajador->contexto);
+}
+
+/*
+* Función que suspende la fibra actual y devuelve el control a su trabajador
+* para que complete la acción indicada
+*/
+static void suspender(Trabajador* trabajador, int accion){
+	trabajador->accion = accion;
+	swapcontext(&trabajador->actual->contexto, &trabajador->contexto);
+}
+
+void iniciarPlanificador(Planificador* planificador, int numTrabajadores,
+		size_t tamPila){
+	pthread_condattr_t atributos;
+
+	pthread_mutex_init(&planificador->mutex, NULL);
+
+	// Los plazos de las fibras dormidas se miden con el reloj monótono
+	pthread_condattr_init(&atributos);
+	pthread_condattr_setclock(&atributos, CLOCK_MONOTONIC);
+	pthread_cond_init(&planificador->hayTrabajo, &atributos);
+	pthread_condattr_destroy(&atributos);
+
+	planificador->primera = NULL;
+	planificador->ultima = NULL;
+	planificador->dormidas = NULL;
+	planificador->numDormidas = 0;
+	planificador->capacidadDormidas = 0;
+	planificador->activas = 0;
+	planificador->numTrabajadores = numTrabajadores;
+	planificador->tamPila = tamPila;
+}
+
+void destruirPlanificador(Planificador* planificador){
+	pthread_mutex_destroy(&planificador->mutex);
+	pthread_cond_destroy(&planificador->hayTrabajo);
+	free(planificador->dormidas);
+	planificador->dormidas = NULL;
+}
+
+int crearFibra(Planificador* planificador, FuncionFibra funcion,
+		void* argumento){
+	Fibra* fibra;
+	size_t pagina = sysconf(_SC_PAGESIZE);
+
+	fibra = (Fibra*) malloc(sizeof(Fibra));
+	if(fibra == NULL){
+		return -1;
+	}
+
+	// La memoria física de la pila solo se reserva al utilizarla
+	fibra->tamPila = (planificador->tamPila + pagina - 1) / pagina * pagina;
+	fibra->pila = mmap(NULL, fibra->tamPila, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+	if(fibra->pila == MAP_FAILED){
+		free(fibra);
+		return -1;
+	}
+
+	// Las pilas crecen hacia abajo, por lo que la página de protección es la
+	// de menor dirección
+	mprotect(fibra->pila, pagina, PROT_NONE);
+
+	getcontext(&fibra->contexto);
+	fibra->contexto.uc_stack.ss_sp = (char*) fibra->pila + pagina;
+	fibra->contexto.uc_stack.ss_size = fibra->tamPila - pagina;
+	fibra->contexto.uc_link = NULL;
+	makecontext(&fibra->contexto, iniciarFibra, 0);
+
+	fibra->funcion = funcion;
+	fibra->argumento = argumento;
+	fibra->plazo = 0;
+
+	pthread_mutex_lock(&planificador->mutex);
+	planificador->activas++;
+	encolarLista(planificador, fibra);
+	pthread_cond_signal(&planificador->hayTrabajo);
+	pthread_mutex_unlock(&planificador->mutex);
+
+	return 0;
+}
+
+void ejecutarPlanificador(Planificador* planificador){
+	pthread_t* trabajadores;
+	int i;
+
+	trabajadores = (pthread_t*) malloc(sizeof(pthread_t) *
+			planificador->numTrabajadores);
+
+	for(i = 0; i < planificador->numTrabajadores; i++){
+		pthread_create(&trabajadores[i], NULL, trabajar, planificador);
+	}
+	for(i = 0; i < planificador->numTrabajadores; i++){
+		pthread_join(trabajadores[i], NULL);
+	}
+
+	free(trabajadores);
+}
+
+void cederFibra(){
+	suspender(obtenerTrabajador(), ACCION_CEDER);
+}
+
+void dormirFibra(double segundos){
+	Trabajador* trabajador;
+
+	if(segundos <= 0){
+		return;
+	}
+
+	trabajador = obtenerTrabajador();
+	trabajador->actual->plazo = ahora() + (uint64_t) (segundos * 1e9);
+	suspender(trabajador, ACCION_DORMIR);
+}
+
+void bloquearMutexFibra(pthread_mutex_t* mutex){
+	while(pthread_mutex_trylock(mutex) != 0){
+		cederFibra();
+	}
+}
+
+void iniciarCondicionFibra(CondicionFibra* condicion){
+	condicion->primera = NULL;
+	condicion->ultima = NULL;
+}
+
+void esperarCondicionFibra(CondicionFibra* condicion, pthread_mutex_t* mutex){
+	Trabajador* trabajador = obtenerTrabajador();
+
+	// El trabajador añade la fibra a la condición y libera el mutex una vez la
+	// fibra se ha suspendido, por lo que una notificación nunca la encuentra
+	// aún en ejecución
+	trabajador->condicion = condicion;
+	trabajador->mutex = mutex;
+	suspender(trabajador, ACCION_ESPERAR);
+
+	bloquearMutexFibra(mutex);
+}
+
+int notificarCondicionFibra(CondicionFibra* condicion, int n){
+	Planificador* planificador = obtenerTrabajador()->planificador;
+	Fibra* fibra;
+	int notificadas = 0;
+
+	if(condicion->primera == NULL){
+		return 0;
+	}
+
+	pthread_mutex_lock(&planificador->mutex);
+	while(notificadas < n && condicion->primera != NULL){
+		fibra = condicion->primera;
+		condicion->primera = fibra->siguiente;
+		encolarLista(planificador, fibra);
+		notificadas++;
+	}
+	if(condicion->primera == NULL){
+		condicion->ultima = NULL;
+	}
+
+	// Se despiertan tantos trabajadores como fibras notificadas
+	if(notificadas == 1){
+		pthread_cond_signal(&planificador->hayTrabajo);
+	} else {
+		pthread_cond_broadcast(&planificador->hayTrabajo);
+	}
+	pthread_mutex_unlock(&planificador->mutex);
+
+	return notificadas;
+}
+
+int notificarTodasFibra(CondicionFibra* condicion){
+	return notificarCondicionFibra(condicion, INT_MAX);
+}
@@ -0,0 +1,222 @@
+#ifndef FIBRA_H
+#define FIBRA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <ucontext.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Planificador ejecuta fibras (hilos de usuario con su propia pila) sobre
+* un número fijo de hilos trabajadores, de forma que el número de productores y
+* consumidores lógicos no está limitado por el número de hilos del sistema. Los
+* cambios de contexto entre fibras se realizan con 'swapcontext', sin pasar por
+* el planificador del núcleo.
+*
+* Una fibra nunca bloquea a su trabajador: en lugar de esperar en un mutex, una
+* variable de condición o un 'nanosleep', se suspende y el trabajador ejecuta
+* otra fibra. Para ello las fibras deben utilizar 'bloquearMutexFibra',
+* 'esperarCondicionFibra' y 'dormirFibra' en lugar de sus equivalentes de
+* pthreads, y no deben suspenderse con un mutex bloqueado salvo dentro de
+* 'esperarCondicionFibra'.
+*
+* Las fibras listas forman una única cola FIFO protegida por el mutex del
+* planificador, y las dormidas un montículo ordenado por el instante en el que
+* deben despertar. Un trabajador sin fibras listas duerme en una variable de
+* condición hasta que haya alguna o venza el plazo de la primera dormida.
+*
+* Las pilas se reservan con 'mmap' sin reservar memoria física, por lo que solo
+* ocupan memoria las páginas que se utilizan, y su página más baja se protege
+* para que un desbordamiento termine el proceso en lugar de corromper memoria.
+*/
+
+// Tamaño por defecto de la pila de cada fibra
+#define FIBRA_TAM_PILA (64 * 1024)
+
+// Tipo de las funciones que ejecutan las fibras
+typedef void (*FuncionFibra)(void* argumento);
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_FIBRA
+* Campos:
+*		- contexto: registros de la fibra mientras está suspendida
+*		- pila: memoria de la pila, incluida la página de protección
+*		- tamPila: tamaño de 'pila'
+*		- funcion y argumento: función que ejecuta la fibra y su argumento
+*		- plazo: instante (en nanosegundos del reloj monótono) en el que debe
+*							despertar la fibra si está dormida
+*		- siguiente: siguiente fibra de la cola de listas o de la condición en
+*							la que espera
+*/
+typedef struct ST_FIBRA{
+	ucontext_t contexto;
+	void* pila;
+	size_t tamPila;
+	FuncionFibra funcion;
+	void* argumento;
+	uint64_t plazo;
+	struct ST_FIBRA* siguiente;
+} Fibra;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_CONDICIONFIBRA
+* Variable de condición para fibras: lista FIFO de las fibras que esperan en
+* ella. Se protege con el mutex que se indica al esperar, que debe ser el mismo
+* en todas las esperas y notificaciones.
+* Campos:
+*		- primera: fibra que lleva más tiempo esperando
+*		- ultima: última fibra en empezar a esperar
+*/
+typedef struct ST_CONDICIONFIBRA{
+	Fibra* primera;
+	Fibra* ultima;
+} CondicionFibra;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_PLANIFICADOR
+* Campos:
+*		- mutex: protege el resto de campos
+*		- hayTrabajo: los trabajadores sin fibras listas duermen en ella
+*		- primera y ultima: cola de fibras listas
+*		- dormidas: montículo de fibras dormidas, ordenado por plazo
+*		- numDormidas y capacidadDormidas: número de fibras dormidas y tamaño de
+*							'dormidas'
+*		- activas: número de fibras que aún no han terminado
+*		- numTrabajadores: número de hilos trabajadores
+*		- tamPila: tamaño de la pila de las fibras
+*/
+typedef struct ST_PLANIFICADOR{
+	pthread_mutex_t mutex;
+	pthread_cond_t hayTrabajo;
+	Fibra* primera;
+	Fibra* ultima;
+	Fibra** dormidas;
+	int numDormidas;
+	int capacidadDormidas;
+	int activas;
+	int numTrabajadores;
+	size_t tamPila;
+} Planificador;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: iniciarPlanificador
+* Tipo: constructor
+* Función que inicia un planificador sin fibras, que utilizará el número de
+* trabajadores y el tamaño de pila indicados.
+*
+* Precondición : numTrabajadores > 0 y tamPila de al menos dos páginas
+* Postcondición: se pueden crear fibras en el planificador
+*/
+void iniciarPlanificador(Planificador* planificador, int numTrabajadores,
+		size_t tamPila);
+
+/*
+* Nombre: destruirPlanificador
+* Tipo: destructor
+* Función que libera los recursos del planificador.
+*
+* Precondición : no debe quedar ninguna fibra activa
+* Postcondición: el planificador no puede volver a utilizarse
+*/
+void destruirPlanificador(Planificador* planificador);
+
+/*
+* Nombre: crearFibra
+* Tipo: constructor
+* Función que crea una fibra que ejecutará la función indicada con el
+* argumento indicado y la añade a la cola de fibras listas. La fibra termina
+* cuando la función retorna, y su pila se libera entonces.
+*
+* Precondición : el planificador debe haber sido iniciado
+* Postcondición: se devuelve 0, o -1 si no se ha podido reservar la pila
+*/
+int crearFibra(Planificador* planificador, FuncionFibra funcion,
+		void* argumento);
+
+/*
+* Nombre: ejecutarPlanificador
+* Tipo: modificador
+* Función que crea los trabajadores, que ejecutan las fibras hasta que todas
+* han terminado, y espera a que finalicen.
+*
+* Precondición : el planificador debe haber sido iniciado
+* Postcondición: todas las fibras han terminado
+*/
+void ejecutarPlanificador(Planificador* planificador);
+
+/*
+* Nombre: cederFibra
+* Tipo: modificador
+* Función que suspende la fibra actual y la coloca al final de la cola de
+* fibras listas.
+*
+* Precondición : se debe llamar desde una fibra
+* Postcondición: la fibra continúa cuando un trabajador vuelve a ejecutarla
+*/
+void cederFibra();
+
+/*
+* Nombre: dormirFibra
+* Tipo: modificador
+* Función que suspende la fibra actual durante el número de segundos indicado,
+* que puede tener decimales. Con un tiempo no positivo vuelve inmediatamente.
+*
+* Precondición : se debe llamar desde una fibra
+* Postcondición: ha transcurrido al menos el tiempo indicado
+*/
+void dormirFibra(double segundos);
+
+/*
+* Nombre: bloquearMutexFibra
+* Tipo: modificador
+* Función que bloquea el mutex indicado. Mientras esté bloqueado por otra fibra
+* o hilo, la fibra actual cede su trabajador.
+*
+* Precondición : se debe llamar desde una fibra
+* Postcondición: la fibra actual tiene el mutex bloqueado
+*/
+void bloquearMutexFibra(pthread_mutex_t* mutex);
+
+/*
+* Nombre: iniciarCondicionFibra
+* Tipo: constructor
+* Función que inicia una variable de condición para fibras sin esperas.
+*
+* Precondición : ninguna
+* Postcondición: la condición puede ser utilizada
+*/
+void iniciarCondicionFibra(CondicionFibra* condicion);
+
+/*
+* Nombre: esperarCondicionFibra
+* Tipo: modificador
+* Función que suspende la fibra actual en la condición indicada y libera el
+* mutex indicado, de forma atómica respecto a las notificaciones. Al volver, el
+* mutex está de nuevo bloqueado. Como con 'pthread_cond_wait', quien espera debe
+* volver a comprobar su condición.
+*
+* Precondición : se debe llamar desde una fibra que tenga el mutex bloqueado
+* Postcondición: la fibra ha sido notificada y tiene el mutex bloqueado
+*/
+void esperarCondicionFibra(CondicionFibra* condicion, pthread_mutex_t* mutex);
+
+/*
+* Nombre: notificarCondicionFibra / notificarTodasFibra
+* Tipo: modificador
+* Funciones que pasan a la cola de fibras listas como mucho 'n' de las fibras
+* que esperan en la condición, o todas ellas.
+*
+* Precondición : se debe llamar desde una fibra con el mutex de la condición
+*								 bloqueado
+* Postcondición: se devuelve el número de fibras notificadas
+*/
+int notificarCondicionFibra(CondicionFibra* condicion, int n);
+int notificarTodasFibra(CondicionFibra* condicion);
+
+#endif
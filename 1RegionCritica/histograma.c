@@ -0,0 +1,110 @@
+#include <string.h>
+#include "histograma.h"
+
+/*
+* Función que devuelve la cubeta correspondiente a la duración indicada. Las
+* duraciones menores que HISTOGRAMA_SUBCUBETAS tienen una cubeta cada una, y
+* el resto se clasifican por su bit más significativo y los
+* HISTOGRAMA_BITS_SUBCUBETA bits siguientes
+*/
+static inline unsigned int cubeta(uint64_t duracion){
+	unsigned int msb;
+
+	if(duracion < HISTOGRAMA_SUBCUBETAS){
+		return (unsigned int) duracion;
+	}
+
+	msb = 63 - __builtin_clzll(duracion);
+
+	return ((msb - HISTOGRAMA_BITS_SUBCUBETA + 1) << HISTOGRAMA_BITS_SUBCUBETA)
+			+ ((duracion >> (msb - HISTOGRAMA_BITS_SUBCUBETA)) &
+			(HISTOGRAMA_SUBCUBETAS - 1));
+}
+
+/*
+* Función que devuelve la mayor duración que se clasifica en la cubeta indicada
+*/
+static uint64_t limiteCubeta(unsigned int indice){
+	unsigned int msb, sub;
+	uint64_t ancho;
+
+	if(indice < HISTOGRAMA_SUBCUBETAS){
+		return indice;
+	}
+
+	msb = (indice >> HISTOGRAMA_BITS_SUBCUBETA) + HISTOGRAMA_BITS_SUBCUBETA - 1;
+	sub = indice & (HISTOGRAMA_SUBCUBETAS - 1);
+	ancho = 1ULL << (msb - HISTOGRAMA_BITS_SUBCUBETA);
+
+	return ((uint64_t)(HISTOGRAMA_SUBCUBETAS + sub) << (msb -
+			HISTOGRAMA_BITS_SUBCUBETA)) + ancho - 1;
+}
+
+void iniciarHistograma(Histograma* histograma){
+	memset(histograma, 0, sizeof(Histograma));
+}
+
+void registrarHistograma(Histograma* histograma, uint64_t duracion){
+	histograma->cubetas[cubeta(duracion)]++;
+	histograma->total++;
+	histograma->suma += duracion;
+
+	if(duracion > histograma->maximo){
+		histograma->maximo = duracion;
+	}
+}
+
+void combinarHistograma(Histograma* destino, const Histograma* origen){
+	int i;
+
+	for(i = 0; i < HISTOGRAMA_CUBETAS; i++){
+		destino->cubetas[i] += origen->cubetas[i];
+	}
+
+	destino->total += origen->total;
+	destino->suma += origen->suma;
+
+	if(origen->maximo > destino->maximo){
+		destino->maximo = origen->maximo;
+	}
+}
+
+uint64_t percentilHistograma(const Histograma* histograma, double percentil){
+	uint64_t objetivo, acumulado = 0;
+	uint64_t limite;
+	int i;
+
+	if(histograma->total == 0){
+		return 0;
+	}
+
+	// Número de duraciones que deben quedar por debajo del percentil, como
+	// mínimo una
+	objetivo = (uint64_t)(percentil / 100.0 * histograma->total + 0.5);
+	if(objetivo == 0){
+		objetivo = 1;
+	}
+
+	for(i = 0; i < HISTOGRAMA_CUBETAS; i++){
+		acumulado += histograma->cubetas[i];
+		if(acumulado >= objetivo){
+			limite = limiteCubeta(i);
+			return limite < histograma->maximo ? limite : histograma->maximo;
+		}
+	}
+
+	return histograma->maximo;
+}
+
+void imprimirHistograma(FILE* salida, const char* nombre,
+		const Histograma* histograma){
+	fprintf(salida, "%-10s n: %-8llu media: %-10llu p50: %-10llu p99: %-10llu "
+			"p99.9: %-10llu max: %llu\n", nombre,
+			(unsigned long long) histograma->total,
+			(unsigned long long)(histograma->total > 0 ?
+					histograma->suma / histograma->total : 0),
+			(unsigned long long) percentilHistograma(histograma, 50.0),
+			(unsigned long long) percentilHistograma(histograma, 99.0),
+			(unsigned long long) percentilHistograma(histograma, 99.9),
+			(unsigned long long) histograma->maximo);
+}
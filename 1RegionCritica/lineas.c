@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lineas.h"
+
+/*
+* Función que devuelve la posición en la que empieza la primera línea completa
+* a partir de la posición indicada: la propia posición si la anterior es un
+* salto de línea, o la siguiente al próximo salto de línea
+*/
+static size_t inicioLinea(const char* datos, size_t tam, size_t posicion){
+	const char* salto;
+
+	if(posicion == 0 || posicion >= tam || datos[posicion - 1] == '\n'){
+		return posicion < tam ? posicion : tam;
+	}
+
+	salto = memchr(datos + posicion, '\n', tam - posicion);
+	return salto == NULL ? tam : (size_t) (salto - datos) + 1;
+}
+
+int abrirFicheroLineas(FicheroLineas* fichero, const char* ruta, int numPartes){
+	struct stat estado;
+	size_t inicio, fin;
+	int descriptor;
+	int i;
+
+	descriptor = open(ruta, O_RDONLY | O_CLOEXEC);
+	if(descriptor < 0){
+		fprintf(stderr, "[!] No se puede abrir el fichero de entrada '%s': %s\n",
+				ruta, strerror(errno));
+		return -1;
+	}
+	if(fstat(descriptor, &estado) != 0){
+		fprintf(stderr, "[!] No se puede consultar el fichero de entrada '%s': "
+				"%s\n", ruta, strerror(errno));
+		close(descriptor);
+		return -1;
+	}
+	if(estado.st_size > INT_MAX){
+		fprintf(stderr, "[!] El fichero de entrada '%s' no puede superar %d "
+				"bytes\n", ruta, INT_MAX);
+		close(descriptor);
+		return -1;
+	}
+
+	fichero->tam = (size_t) estado.st_size;
+	fichero->datos = NULL;
+	fichero->lineas = NULL;
+	fichero->numPartes = numPartes;
+	fichero->partes = aligned_alloc(TAM_LINEA_CACHE,
+			sizeof(ParteLineas) * numPartes);
+
+	// Un fichero vacío no se puede proyectar, pero tampoco tiene líneas
+	if(fichero->tam > 0){
+		fichero->datos = mmap(NULL, fichero->tam, PROT_READ, MAP_PRIVATE,
+				descriptor, 0);
+		if(fichero->datos == MAP_FAILED){
+			fprintf(stderr, "[!] No se puede proyectar el fichero de entrada "
+					"'%s': %s\n", ruta, strerror(errno));
+			free(fichero->partes);
+			close(descriptor);
+			return -1;
+		}
+		madvise((void*) fichero->datos, fichero->tam, MADV_SEQUENTIAL);
+
+		fichero->lineas = mmap(NULL, sizeof(Linea) * fichero->tam,
+				PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+				-1, 0);
+		if(fichero->lineas == MAP_FAILED){
+			fprintf(stderr, "[!] No se puede reservar la tabla de líneas: %s\n",
+					strerror(errno));
+			munmap((void*) fichero->datos, fichero->tam);
+			free(fichero->partes);
+			close(descriptor);
+			return -1;
+		}
+	}
+
+	// La proyección se mantiene aunque se cierre el descriptor
+	close(descriptor);
+
+	// Cada parte termina donde empieza la siguiente, de forma que las líneas
+	// que cruzan el límite nominal pertenecen a la parte anterior
+	inicio = 0;
+	for(i = 0; i < numPartes; i++){
+		if(i == numPartes - 1){
+			fin = fichero->tam;
+		} else {
+			fin = inicioLinea(fichero->datos, fichero->tam,
+					fichero->tam / numPartes * (i + 1));
+			if(fin < inicio){
+				fin = inicio;
+			}
+		}
+		fichero->partes[i].posicion = inicio;
+		fichero->partes[i].fin = fin;
+		fichero->partes[i].siguiente = (int) inicio;
+		inicio = fin;
+	}
+
+	return 0;
+}
+
+void cerrarFicheroLineas(FicheroLineas* fichero){
+	if(fichero->tam > 0){
+		munmap(fichero->lineas, sizeof(Linea) * fichero->tam);
+		munmap((void*) fichero->datos, fichero->tam);
+	}
+	free(fichero->partes);
+	fichero->partes = NULL;
+	fichero->lineas = NULL;
+	fichero->datos = NULL;
+}
+
+int siguienteLinea(FicheroLineas* fichero, int parte){
+	ParteLineas* actual = &fichero->partes[parte];
+	const char* salto;
+	size_t fin;
+	int indice;
+
+	if(actual->posicion >= actual->fin){
+		return -1;
+	}
+
+	// La última línea de la parte puede no terminar en salto de línea si es la
+	// última del fichero
+	salto = memchr(fichero->datos + actual->posicion, '\n',
+			actual->fin - actual->posicion);
+	fin = salto == NULL ? actual->fin : (size_t) (salto - fichero->datos) + 1;
+
+	indice = actual->siguiente++;
+	fichero->lineas[indice].inicio = (uint32_t) actual->posicion;
+	fichero->lineas[indice].longitud = (uint32_t) (fin - actual->posicion);
+	actual->posicion = fin;
+
+	return indice;
+}
+
+void iniciarEscrituraLineas(EscrituraLineas* escritura, int descriptor){
+	escritura->descriptor = descriptor;
+	escritura->numVectores = 0;
+	escritura->bytes = 0;
+	escritura->lineas = 0;
+}
+
+int escribirLinea(EscrituraLineas* escritura, const char* texto,
+		size_t longitud){
+	static const char salto = '\n';
+	struct iovec* vector;
+
+	// Cada línea puede necesitar dos vectores, por lo que se escriben las
+	// acumuladas si no caben
+	if(escritura->numVectores > ESCRITURA_MAX_VECTORES - 2 &&
+			vaciarEscritura(escritura) != 0){
+		return -1;
+	}
+
+	// writev no modifica los datos, aunque 'iov_base' no sea constante
+	vector = &escritura->vectores[escritura->numVectores++];
+	vector->iov_base = (void*) texto;
+	vector->iov_len = longitud;
+
+	// La última línea del fichero puede no terminar en salto de línea, y sin él
+	// se uniría a la siguiente que se escriba
+	if(longitud == 0 || texto[longitud - 1] != '\n'){
+		vector = &escritura->vectores[escritura->numVectores++];
+		vector->iov_base = (void*) &salto;
+		vector->iov_len = 1;
+	}
+
+	escritura->lineas++;
+	return 0;
+}
+
+int vaciarEscritura(EscrituraLineas* escritura){
+	struct iovec* vector = escritura->vectores;
+	int restantes = escritura->numVectores;
+	ssize_t escritos;
+
+	escritura->numVectores = 0;
+
+	while(restantes > 0){
+		escritos = writev(escritura->descriptor, vector, restantes);
+		if(escritos < 0){
+			if(errno == EINTR){
+				continue;
+			}
+			return -1;
+		}
+		escritura->bytes += escritos;
+
+		// Tras una escritura parcial se descartan los vectores completos y se
+		// continúa por la mitad del primero que no se ha terminado
+		while(restantes > 0 && (size_t) escritos >= vector->iov_len){
+			escritos -= vector->iov_len;
+			vector++;
+			restantes--;
+		}
+		if(restantes > 0){
+			vector->iov_base = (char*) vector->iov_base + escritos;
+			vector->iov_len -= escritos;
+		}
+	}
+
+	return 0;
+}
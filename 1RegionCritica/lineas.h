@@ -0,0 +1,192 @@
+#ifndef LINEAS_H
+#define LINEAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include "buffer.h"
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD FicheroLineas proyecta en memoria con 'mmap' un fichero de entrada y
+* lo reparte en partes, una por productor, cuyos límites coinciden con saltos
+* de línea. Cada productor recorre su parte y, por cada línea, guarda su
+* descriptor (posición y longitud dentro del fichero) en una tabla común y
+* devuelve su índice, que es lo que se inserta en el buffer. Ni el productor ni
+* el consumidor copian el texto de la línea.
+*
+* Como cada línea ocupa al menos un byte, una parte que empieza en la posición
+* 'p' del fichero no tiene más líneas que bytes, y sus descriptores se guardan a
+* partir del índice 'p' de la tabla. Así los productores no necesitan
+* coordinarse. La tabla se reserva con 'mmap' sin reservar memoria física, por
+* lo que solo ocupan memoria las páginas de descriptores que se utilizan.
+*
+* Los índices son enteros, por lo que el fichero no puede superar INT_MAX
+* bytes.
+*
+* El TAD EscrituraLineas agrupa las líneas que escribe un consumidor y las
+* escribe con una única llamada a 'writev' cuando se han acumulado
+* ESCRITURA_MAX_VECTORES vectores. Los vectores apuntan directamente al fichero
+* proyectado.
+* Si el descriptor de salida se abre con O_APPEND, las escrituras de distintos
+* consumidores no se entremezclan dentro de una misma llamada.
+*/
+
+// Número máximo de vectores que se agrupan en cada llamada a 'writev'
+#define ESCRITURA_MAX_VECTORES 64
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_LINEA
+* Descriptor de una línea, incluido su salto de línea final si lo tiene.
+* Campos:
+*		- inicio: posición del primer byte de la línea en el fichero
+*		- longitud: número de bytes de la línea
+*/
+typedef struct ST_LINEA{
+	uint32_t inicio;
+	uint32_t longitud;
+} Linea;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_PARTELINEAS
+* Parte del fichero que recorre un productor. Cada parte ocupa su propia línea
+* de caché, ya que solo la modifica su productor.
+* Campos:
+*		- posicion: posición del fichero en la que empieza la siguiente línea
+*		- fin: posición en la que termina la parte
+*		- siguiente: índice de la tabla en el que se guarda la siguiente línea
+*/
+typedef struct ST_PARTELINEAS{
+	_Alignas(TAM_LINEA_CACHE) size_t posicion;
+	size_t fin;
+	int siguiente;
+} ParteLineas;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_FICHEROLINEAS
+* Campos:
+*		- datos: contenido del fichero proyectado en memoria
+*		- tam: tamaño del fichero en bytes
+*		- lineas: tabla de descriptores de las líneas
+*		- partes: parte de cada productor
+*		- numPartes: número de partes
+*/
+typedef struct ST_FICHEROLINEAS{
+	const char* datos;
+	size_t tam;
+	Linea* lineas;
+	ParteLineas* partes;
+	int numPartes;
+} FicheroLineas;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_ESCRITURALINEAS
+* Campos:
+*		- descriptor: descriptor en el que se escriben las líneas
+*		- vectores: líneas acumuladas que aún no se han escrito
+*		- numVectores: número de vectores acumulados
+*		- bytes: número total de bytes escritos
+*		- lineas: número total de líneas añadidas
+*/
+typedef struct ST_ESCRITURALINEAS{
+	int descriptor;
+	struct iovec vectores[ESCRITURA_MAX_VECTORES];
+	int numVectores;
+	uint64_t bytes;
+	uint64_t lineas;
+} EscrituraLineas;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: abrirFicheroLineas
+* Tipo: constructor
+* Función que proyecta en memoria el fichero indicado y lo reparte en el número
+* de partes indicado, de tamaños similares y terminadas en salto de línea.
+*
+* Precondición : numPartes > 0
+* Postcondición: se devuelve 0 si se ha podido abrir el fichero, y -1 en caso
+*								 contrario, tras escribir el motivo por la salida de error
+*/
+int abrirFicheroLineas(FicheroLineas* fichero, const char* ruta, int numPartes);
+
+/*
+* Nombre: cerrarFicheroLineas
+* Tipo: destructor
+* Función que libera la proyección del fichero y la tabla de descriptores.
+*
+* Precondición : ningún hilo está utilizando el fichero
+* Postcondición: el fichero no puede volver a utilizarse
+*/
+void cerrarFicheroLineas(FicheroLineas* fichero);
+
+/*
+* Nombre: siguienteLinea
+* Tipo: modificador
+* Función que busca la siguiente línea de la parte indicada, guarda su
+* descriptor en la tabla y devuelve su índice.
+*
+* Precondición : solo un hilo recorre cada parte
+* Postcondición: se devuelve el índice de la línea, o -1 si la parte se ha
+*								 terminado
+*/
+int siguienteLinea(FicheroLineas* fichero, int parte);
+
+/*
+* Nombre: textoLinea
+* Tipo: consulta
+* Función que devuelve el texto de la línea del índice indicado y guarda su
+* longitud en 'longitud'. El texto no termina en '\0'.
+*
+* Precondición : el índice debe haber sido devuelto por 'siguienteLinea' y
+*								 haber llegado al hilo a través de una sincronización
+*								 (por ejemplo, el buffer)
+* Postcondición: se devuelve un puntero al fichero proyectado
+*/
+static inline const char* textoLinea(const FicheroLineas* fichero, int indice,
+		size_t* longitud){
+	*longitud = fichero->lineas[indice].longitud;
+	return fichero->datos + fichero->lineas[indice].inicio;
+}
+
+/*
+* Nombre: iniciarEscrituraLineas
+* Tipo: constructor
+* Función que inicia una escritura sin líneas acumuladas sobre el descriptor
+* indicado.
+*
+* Precondición : ninguna
+* Postcondición: la escritura puede ser utilizada
+*/
+void iniciarEscrituraLineas(EscrituraLineas* escritura, int descriptor);
+
+/*
+* Nombre: escribirLinea
+* Tipo: modificador
+* Función que añade el texto indicado a las líneas acumuladas, con un salto de
+* línea si no termina en él, escribiendo antes las acumuladas si no queda
+* sitio. El texto debe seguir siendo válido hasta que se escriba.
+*
+* Precondición : la escritura debe haber sido iniciada
+* Postcondición: se devuelve 0, o -1 si ha fallado la escritura, con el error
+*								 en 'errno'
+*/
+int escribirLinea(EscrituraLineas* escritura, const char* texto,
+		size_t longitud);
+
+/*
+* Nombre: vaciarEscritura
+* Tipo: modificador
+* Función que escribe todas las líneas acumuladas, repitiendo 'writev' hasta
+* completar las escrituras parciales.
+*
+* Precondición : la escritura debe haber sido iniciada
+* Postcondición: se devuelve 0 y no quedan líneas acumuladas, o -1 si ha
+*								 fallado la escritura, con el error en 'errno'
+*/
+int vaciarEscritura(EscrituraLineas* escritura);
+
+#endif
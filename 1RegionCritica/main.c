@@ -3,8 +3,22 @@
 #include <pthread.h>
 #include <time.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
 #include <unistd.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
 #include "buffer.h"
+#include "registro.h"
+#include "histograma.h"
+#include "evento.h"
+#include "espera.h"
+#include "configuracion.h"
+#include "afinidad.h"
+#include "fibra.h"
+#include "aviso.h"
+#include "lineas.h"
 
 // Colores
 #define tblack "\E[30m" // Texto color negro
@@ -17,11 +31,36 @@
 #define reset "\E[m" // Texto color blanco
 #define fpurple "\E[45m" // Fondo color morado
 
-// Tamaño que ocupa el string de la hora
-#define TAM_HORA 9
+// Opciones de la línea de comandos
+#define OPCIONES "a:b:c:e:fhF:i:l:mn:o:p:r:s:t:C:P:"
 
-// Tamaño del Buffer
-#define TAM_BUFFER 10
+// Número de intentos fallidos consecutivos sobre el buffer SPSC a partir de los
+// cuales el hilo deja de ceder la CPU y pasa a dormir brevemente
+#define INTENTOS_SPSC 64
+
+// Tiempo (en microsegundos) que duerme un hilo sobre el buffer SPSC una vez
+// superados los INTENTOS_SPSC
+#define ESPERA_SPSC 100
+
+// Fases de los hilos cuya duración se mide con la opción -m
+#define FASE_REGION 0 // Espera del mutex de la región crítica
+#define FASE_CONDICION 1 // Espera en la variable de condición
+#define FASE_TRABAJO 2 // Producción o consumición de un item
+#define NUM_FASES 3
+
+struct ST_HILOPROD;
+struct ST_HILOCONS;
+
+// Tipo de las funciones de trabajo de los productores. Reciben la información
+// del hilo y devuelven el item producido, o un valor negativo si el hilo no
+// tiene más items que producir. Se ejecutan fuera de la región crítica, antes
+// de reservar la posición del buffer
+typedef int (*FuncionProduccion)(struct ST_HILOPROD* hilo);
+
+// Tipo de las funciones de trabajo de los consumidores. Reciben la información
+// del hilo y el item a consumir. Se ejecutan fuera de la región crítica,
+// después de haber liberado la posición del buffer
+typedef void (*FuncionConsumicion)(struct ST_HILOCONS* hilo, int item);
 
 // Estructura utilizada para guardar la información de los Hilos Productores.
 typedef struct ST_HILOPROD{
@@ -31,15 +70,32 @@ typedef struct ST_HILOPROD{
   // Número de hilo, autoincremental
   unsigned int id;
 
-  // Tiempo que el hilo va a tardar en realizar la producción
-  int tiempo;
+  // Tiempo (en segundos) que el hilo va a tardar en realizar la producción
+  double tiempo;
 
-  // Tiempo que esperará el hilo al salir de la región crítica. En caso de ser
-  // negativo se escogerá un aleatorio entre 0 y 4
-  int postProduccion;
+  // Tiempo (en segundos) que esperará el hilo al salir de la región crítica.
+  // En caso de ser negativo se escogerá un aleatorio entre 0 y 4
+  double postProduccion;
 
   // Número de producciones que va a realizar el hilo
   unsigned int numProducciones;
+
+  // Número máximo de producciones que el hilo inserta en el buffer en cada
+  // acceso a la región crítica
+  unsigned int lote;
+
+  // Función que produce cada uno de los items
+  FuncionProduccion producir;
+
+  // Cola en la que el hilo registra sus mensajes
+  ColaRegistro* registro;
+
+  // Duración de cada una de las fases del hilo. Solo se reserva si se miden
+  // las fases (opción -m), y en otro caso es NULL
+  Histograma* fases;
+
+  // Espera activa que realiza el hilo antes de dormir
+  EsperaActiva espera;
 } HiloProductor;
 
 // Estructura utilizada para guardar la información de los Hilos Consumidores.
@@ -50,18 +106,50 @@ typedef struct ST_HILOCONS{
   // Número de hilo, autoincremental
   unsigned int id;
 
-  // Tiempo que el hilo va a tardar en realizar la consumición
-  int tiempo;
+  // Tiempo (en segundos) que el hilo va a tardar en realizar la consumición
+  double tiempo;
 
-  // Tiempo que esperará el hilo al salir de la región crítica. En caso de ser
-  // negativo se escogerá un aleatorio entre 0 y 4
-  int postConsumicion;
+  // Tiempo (en segundos) que esperará el hilo al salir de la región crítica.
+  // En caso de ser negativo se escogerá un aleatorio entre 0 y 4
+  double postConsumicion;
+
+  // Número máximo de elementos que el hilo saca del buffer en cada acceso a la
+  // región crítica
+  unsigned int lote;
+
+  // Función que consume cada uno de los items
+  FuncionConsumicion consumir;
+
+  // Cola en la que el hilo registra sus mensajes
+  ColaRegistro* registro;
+
+  // Duración de cada una de las fases del hilo. Solo se reserva si se miden
+  // las fases (opción -m), y en otro caso es NULL
+  Histograma* fases;
+
+  // Espera activa que realiza el hilo antes de dormir
+  EsperaActiva espera;
+
+  // Con la opción -i, líneas pendientes de escribir en la salida
+  EscrituraLineas escritura;
 } HiloConsumidor;
 
 // Variable Buffer que hará la labor de cola, donde los productores añadirán sus
 // producciones y donde los consumidores obtendrán sus consumiciones.
 Buffer buffer;
 
+// Buffer utilizado cuando solo hay un productor y un consumidor. En ese caso no
+// se utilizan ni el mutex ni las variables de condición
+BufferSPSC bufferSPSC;
+
+// Indica si se está utilizando el buffer SPSC en lugar de 'buffer'
+int modoSPSC = 0;
+
+// Indica si se mide la duración de las fases de los hilos, y nombre de cada
+// una de las fases
+int medir = 0;
+const char* nombresFases[NUM_FASES] = {"region", "condicion", "trabajo"};
+
 // Mutex para el acceso a la región crítica de los consumidores y productores
 pthread_mutex_t mutexRegion;
 
@@ -73,6 +161,52 @@ pthread_cond_t condProductor;
 // cuando sea necesario
 pthread_cond_t condConsumidor;
 
+// Con la opción -t los productores y consumidores son fibras que se ejecutan
+// sobre un número fijo de trabajadores, y duermen en estas condiciones en lugar
+// de en las variables de condición, de forma que nunca bloquean al trabajador
+int modoFibras = 0;
+Planificador planificador;
+CondicionFibra condFibraProductor;
+CondicionFibra condFibraConsumidor;
+
+// Eventos utilizados en lugar de las variables de condición con la opción -f.
+// En 'eventoNoLlena' esperan los productores que encuentran la cola llena y en
+// 'eventoNoVacia' los consumidores que la encuentran vacía. Las notificaciones
+// se realizan fuera de la región crítica
+int usarFutex = 0;
+Evento eventoNoLlena;
+Evento eventoNoVacia;
+
+// Avisos utilizados en lugar de las variables de condición con la estrategia
+// 'eventfd'. Los consumidores esperan a 'avisoNoVacia' en su propio bucle de
+// 'epoll' y los productores a 'avisoNoLlena'. Como con los eventos, los avisos
+// se escriben fuera de la región crítica
+int usarAvisos = 0;
+Aviso avisoNoLlena;
+Aviso avisoNoVacia;
+
+// Número de productores y de consumidores dormidos en sus variables de
+// condición. Solo se modifican y consultan dentro de la región crítica, y
+// permiten despertar a un hilo cada vez que se libera o se ocupa una posición
+// mientras quede alguno dormido
+int productoresEsperando = 0;
+int consumidoresEsperando = 0;
+
+// Número máximo de pausas que los hilos esperan activamente a que cambie el
+// estado de la cola antes de dormir. Con 0 duermen directamente
+unsigned int maximoEspera = ESPERA_MAX_DEFECTO;
+
+// CPU en la que se ejecuta cada hilo y en cuyo nodo se ubican los buffers
+Afinidad afinidad;
+
+// Con la opción -i los productores reparten las líneas del fichero de entrada
+// e insertan sus índices en el buffer, y los consumidores las escriben en el
+// descriptor de salida. No se sabe de antemano cuántas líneas hay, pero los
+// consumidores no lo necesitan: terminan cuando el buffer está cerrado y vacío
+int modoLineas = 0;
+FicheroLineas entrada;
+int salida = -1;
+
 /*
 * Función que crea los hilos productores correspondientes a partir de la
 * información pasada por parámetro.
@@ -118,29 +252,106 @@ void productor(HiloProductor* hilo);
 void consumidor(HiloConsumidor* hilo);
 
 /*
-* Función de producción para los hilos productores. Devuelve un entero aleatorio
-* entre 0 y 9.
+* Función asociada al hilo productor cuando solo existe un productor y un
+* consumidor. Utiliza el buffer SPSC, por lo que no accede a ninguna región
+* crítica.
+*/
+void productorSPSC(HiloProductor* hilo);
+
+/*
+* Función asociada al hilo consumidor cuando solo existe un productor y un
+* consumidor. Utiliza el buffer SPSC, por lo que no accede a ninguna región
+* crítica.
+*/
+void consumidorSPSC(HiloConsumidor* hilo);
+
+/*
+* Función de espera para los hilos que operan sobre el buffer SPSC y lo han
+* encontrado lleno o vacío. Durante los primeros INTENTOS_SPSC intentos se cede
+* la CPU, y a partir de ahí se duerme ESPERA_SPSC microsegundos.
+*/
+void esperarSPSC(unsigned int* intentos);
+
+/*
+* Función que devuelve el instante en el que empieza una fase, o 0 si no se
+* están midiendo las fases de los hilos
+*/
+uint64_t iniciarFase();
+
+/*
+* Función que registra en el histograma de la fase indicada la duración de la
+* fase que empezó en el instante indicado, en caso de que se estén midiendo las
+* fases
+*/
+void finalizarFase(Histograma* fases, int fase, uint64_t inicio);
+
+/*
+* Función que reserva e inicia los histogramas de las fases de un hilo si se
+* están midiendo, o devuelve NULL en otro caso
+*/
+Histograma* crearFases();
+
+/*
+* Función que combina los histogramas de todos los productores y de todos los
+* consumidores e imprime los percentiles de cada fase
+*/
+void imprimirFases(HiloProductor* productores, unsigned int numProductores,
+                   HiloConsumidor* consumidores, unsigned int numConsumidores);
+
+/*
+* Condiciones de la espera activa de productores y consumidores. Se comprueban
+* fuera de la región crítica, por lo que solo consultan los índices atómicos del
+* buffer. Los consumidores también dejan de esperar si el buffer se cierra
+*/
+int hayHueco(const void* buffer);
+int hayElementos(const void* buffer);
+
+/*
+* Función de producción por defecto para los hilos productores. Tarda el tiempo
+* de producción del hilo y devuelve un entero aleatorio entre 0 y 9.
+*/
+int producir(HiloProductor* hilo);
+
+/*
+* Función de consumición por defecto para los hilos consumidores. Tarda el
+* tiempo de consumición del hilo.
+*/
+void consumir(HiloConsumidor* hilo, int item);
+
+/*
+* Funciones de trabajo de la opción -i. El productor devuelve el índice de la
+* siguiente línea de su parte del fichero, o -1 si la ha terminado, y el
+* consumidor añade la línea a su escritura agrupada
 */
-int producir();
+int producirLinea(HiloProductor* hilo);
+void consumirLinea(HiloConsumidor* hilo, int item);
 
 /*
-* Función que modifica la cadena de caracteres pasada por argumento añadiéndole
-* la hora actual. La cadena de caracteres tiene que tener como mínimo 'TAM_HORA'
-* caracteres.
+* Función que muestra la pregunta indicada y asigna la respuesta del usuario al
+* parámetro de la clave indicada, validándola. Si la respuesta no es válida se
+* vuelve a preguntar, y si la entrada se termina el programa finaliza
 */
-void calcularHora(char* hora);
+void preguntar(Configuracion* configuracion, const char* pregunta,
+               const char* clave);
 
 /*
-* Función para imprimir la cabecera del hilo productor indicado en un color
-* determinado.
+* Función que duerme al hilo el número de segundos indicado, que puede tener
+* decimales. Con un tiempo no positivo vuelve inmediatamente. Con la opción -t
+* solo se suspende la fibra
 */
-void imprimirCabeceraProduc(HiloProductor hilo, char* color);
+void dormir(double segundos);
 
 /*
-* Función para imprimir la cabecera del hilo consumidor indicado en un color
-* determinado.
+* Funciones que bloquean la región crítica, duermen al hilo en una variable de
+* condición liberándola y despiertan a uno o a todos los hilos dormidos en una
+* variable de condición. Con la opción -t utilizan las versiones para fibras,
+* que ceden el trabajador en lugar de bloquearlo
 */
-void imprimirCabeceraConsum(HiloConsumidor hilo, char* color);
+void bloquearRegion();
+void esperarCondicion(pthread_cond_t* condicion,
+                      CondicionFibra* condicionFibra);
+void despertar(pthread_cond_t* condicion, CondicionFibra* condicionFibra,
+               int todos);
 
 int main(int argc, char *argv[]){
 
@@ -149,51 +360,287 @@ int main(int argc, char *argv[]){
   HiloProductor* productores;
   HiloConsumidor* consumidores;
 
+  // Parámetros de la ejecución. Se parte de los valores por defecto, que se
+  // sustituyen por los del fichero de configuración y después por los de la
+  // línea de comandos
+  Configuracion configuracion;
+
   // Variables que indican el número de productores y consumidores que se
-  // crearán, que por defecto será de 1
-  int numProductores = 1, numConsumidores = 1;
+  // crearán
+  int numProductores, numConsumidores;
+
+  // Número de elementos que se insertan o sacan en cada acceso a la región
+  // crítica
+  int lote;
+
+  // Opción procesada, resultado de su validación, número de argumentos
+  // posicionales y fichero de configuración indicado
+  int opcion;
+  int valido = 0;
+  int numArgumentos;
+  char* fichero = NULL;
+
+  // Con la opción -i, instante en el que se crean los hilos, líneas y bytes
+  // escritos por los consumidores y duración total en nanosegundos
+  uint64_t inicioLineas = 0;
+  uint64_t numLineas = 0;
+  uint64_t bytesLineas = 0;
+  uint64_t duracionLineas = 0;
+  int i;
 
   srand(time(NULL));
 
-  // En caso de que el número de argumentos sea dos, se comprueba si lo que se
-  // está indicando es la opción de ayuda
-  if(argc == 2){
-    switch(argv[1][0]){
-      case '-':
-      // En caso de que lleve la terminación '-' se comprueba si está ejecutando
-      // el modo de ayuda
-      // Se comprueba que haya un segundo carácter en la cadena de caracteres
-      if(strlen(argv[1]) >= 2){
-        switch(argv[1][1]){
-          case 'h':
-
-          // Se imprime la ayuda al usuario y se sale de forma exitosa
-          printf("Modo de uso: %s <numProductores> <numConsumidores> "
-                 "<defecto>\n"
-                 "\t-> defecto: se utilizan los parámetros por defecto para los"
-                      " hilos:\n"
-                      "\t\t-> Tiempo de producción: 2\n"
-                      "\t\t-> Tiempo de consumición: 1\n"
-                      "\t\t-> Tiempo de postProducción: aleatorio entre 0 y 4\n"
-                      "\t\t-> Tiempo de postConsumición: aleatorio entre 0 y 4"
-                      "\n\t\t-> Número de producciones: 10 por hilo\n"
-                      , argv[0]);
-
-          exit(EXIT_SUCCESS);
-          break;
-        }
+  iniciarConfiguracion(&configuracion);
+
+  // En una primera pasada solo se lee el fichero de configuración, de forma
+  // que el resto de opciones prevalezcan sobre él sea cual sea su orden
+  opterr = 0;
+  while((opcion = getopt(argc, argv, OPCIONES)) != -1){
+    if(opcion == 'F'){
+      fichero = optarg;
+      if(leerConfiguracion(&configuracion, fichero) != 0){
+        exit(EXIT_FAILURE);
       }
+    }
+  }
+  opterr = 1;
+  optind = 1;
+
+  // Se procesan las opciones indicadas antes de los argumentos posicionales.
+  // Todas se validan con 'asignarConfiguracion', igual que las del fichero
+  while((opcion = getopt(argc, argv, OPCIONES)) != -1){
+    switch(opcion){
+      case 'h':
+      // Se imprime la ayuda al usuario y se sale de forma exitosa
+      printf("Modo de uso: %s [-F fichero] [-a afinidad] [-b tam] "
+             "[-n producciones] [-p segundos] [-c segundos] [-P segundos] "
+             "[-C segundos] [-e estrategia] [-f] [-i entrada] [-o salida] [-m] "
+             "[-l lote] [-r nivel] [-s pausas] [-t trabajadores] "
+             "<numProductores> <numConsumidores> <defecto>\n"
+             "\t-> defecto: se utilizan los parámetros por defecto para los"
+                  " hilos:\n"
+                  "\t\t-> Tiempo de producción: 2\n"
+                  "\t\t-> Tiempo de consumición: 1\n"
+                  "\t\t-> Tiempo de postProducción: aleatorio entre 0 y 4\n"
+                  "\t\t-> Tiempo de postConsumición: aleatorio entre 0 y 4"
+                  "\n\t\t-> Número de producciones: 10 por hilo\n"
+             "\t   Si no se indica, ni se indica ningún tiempo, el número de "
+                  "producciones o un fichero de configuración, se pregunta por "
+                  "ellos\n"
+             "\t-> F: fichero de configuración con una asignación 'clave = "
+                  "valor' por línea. Claves: productores, consumidores, "
+                  "tam_buffer, producciones, tiempo_produccion, "
+                  "tiempo_consumicion, post_produccion, post_consumicion, "
+                  "lote, nivel, estrategia, pausas, medir, fragmentos, "
+                  "afinidad, trabajadores, entrada y salida. Las opciones de "
+                  "la línea de comandos prevalecen sobre el fichero\n"
+             "\t-> afinidad: CPU en la que se ejecuta cada hilo: 'ninguna' "
+                  "(por defecto), 'compacta' (llenando núcleos), 'dispersa' "
+                  "(alternando paquetes y núcleos), 'parejas' (cada productor "
+                  "junto a su consumidor) o una lista de CPUs como '0,2,4-7'. "
+                  "Los buffers se ubican en el nodo NUMA de los consumidores\n"
+             "\t-> tam: número de posiciones del buffer (por defecto 10)\n"
+             "\t-> producciones: producciones a realizar por cada productor\n"
+             "\t-> p, c, P, C: tiempos de producción, consumición, post "
+                  "producción y post consumición en segundos. Admiten "
+                  "decimales y 'aleatorio' (entre 0 y 4 segundos)\n"
+             "\t-> estrategia: 'condiciones' (por defecto), 'futex' o "
+                  "'eventfd'\n"
+             "\t-> lote: número máximo de elementos que productores y "
+                  "consumidores insertan o sacan en cada acceso a la región "
+                  "crítica (entre 1 y %d, por defecto 1)\n"
+             "\t-> nivel: mensajes que muestran los hilos (0: ninguno, 1: "
+                  "producciones y consumiciones, 2: todos, por defecto 2). Los "
+                  "mensajes se escriben desde un hilo dedicado, fuera de las "
+                  "regiones críticas\n"
+             "\t-> pausas: número máximo de pausas que los hilos esperan "
+                  "activamente a que cambie la cola antes de dormir (0 la "
+                  "desactiva, por defecto %d). El número se adapta según el "
+                  "éxito de las esperas anteriores\n"
+             "\t-> trabajadores: los productores y consumidores se ejecutan "
+                  "como fibras sobre el número de hilos indicado (por ejemplo, "
+                  "el número de CPUs), de forma que puede haber decenas de "
+                  "miles de ellos. Las fibras que encuentran la cola llena o "
+                  "vacía ceden su hilo en lugar de bloquearlo. No se puede "
+                  "combinar con futex, eventfd ni afinidad (por defecto 0: un "
+                  "hilo por productor y por consumidor)\n"
+             "\t-> f: equivale a '-e futex'\n"
+             "\t-> entrada: fichero cuyas líneas reparten los productores, sin "
+                  "copiarlas, entre los consumidores, que las escriben en la "
+                  "salida agrupadas con writev. Se ignoran las producciones y "
+                  "los tiempos de producción y consumición, y al finalizar se "
+                  "imprime el rendimiento en GB/s\n"
+             "\t-> salida: fichero en el que se escriben las líneas (por "
+                  "defecto /dev/null)\n"
+             "\t-> m: se mide la duración de la espera de los mutexes, de "
+                  "las variables de condición y de cada producción y "
+                  "consumición, y se imprimen sus percentiles al finalizar\n"
+             "\tLos tiempos de producción y consumición se realizan fuera de "
+                  "las regiones críticas\n"
+             "\tCon un único productor y un único consumidor se utiliza un"
+                  " buffer SPSC sin mutexes ni variables de condición, en el "
+                  "que no se utilizan lotes\n"
+                  , argv[0], MAX_LOTE, ESPERA_MAX_DEFECTO);
+
+      exit(EXIT_SUCCESS);
+      break;
+
+      case 'F':
+      // El fichero ya se ha leído en la primera pasada
+      break;
+
+      case 'a':
+      valido = asignarConfiguracion(&configuracion, "afinidad", optarg);
+      break;
+
+      case 'b':
+      valido = asignarConfiguracion(&configuracion, "tam_buffer", optarg);
+      break;
+
+      case 'n':
+      valido = asignarConfiguracion(&configuracion, "producciones", optarg);
+      break;
+
+      case 'p':
+      valido = asignarConfiguracion(&configuracion, "tiempo_produccion",
+                                    optarg);
+      break;
+
+      case 'c':
+      valido = asignarConfiguracion(&configuracion, "tiempo_consumicion",
+                                    optarg);
+      break;
+
+      case 'P':
+      valido = asignarConfiguracion(&configuracion, "post_produccion", optarg);
+      break;
+
+      case 'C':
+      valido = asignarConfiguracion(&configuracion, "post_consumicion",
+                                    optarg);
+      break;
+
+      case 'e':
+      valido = asignarConfiguracion(&configuracion, "estrategia", optarg);
+      break;
+
+      case 'l':
+      valido = asignarConfiguracion(&configuracion, "lote", optarg);
+      break;
+
+      case 'f':
+      configuracion.estrategia = ESTRATEGIA_FUTEX;
       break;
+
+      case 'm':
+      configuracion.medir = 1;
+      break;
+
+      case 'r':
+      valido = asignarConfiguracion(&configuracion, "nivel", optarg);
+      break;
+
+      case 's':
+      valido = asignarConfiguracion(&configuracion, "pausas", optarg);
+      break;
+
+      case 't':
+      valido = asignarConfiguracion(&configuracion, "trabajadores", optarg);
+      break;
+
+      case 'i':
+      valido = asignarConfiguracion(&configuracion, "entrada", optarg);
+      break;
+
+      case 'o':
+      valido = asignarConfiguracion(&configuracion, "salida", optarg);
+      break;
+
+      default:
+      fprintf(stderr, "Utiliza %s -h para ver el modo de uso\n", argv[0]);
+      exit(EXIT_FAILURE);
+    }
+
+    if(valido != 0){
+      exit(EXIT_FAILURE);
     }
   }
 
-  // Se comprueba que haya más de 2 argumentos (nombre del ejecutable, número de
-  // de productores y número de consumidores)
-  if(argc > 2){
-    // Se realiza un switch en función del primer carácter de la segunda cadena
-    numProductores = atoi(argv[1]);
-    numConsumidores = atoi(argv[2]);
+  // Número de argumentos posicionales restantes
+  numArgumentos = argc - optind;
+
+  // Se comprueba que se indiquen el número de productores y el de
+  // consumidores, salvo que se tomen del fichero de configuración
+  if((numArgumentos == 0 && fichero == NULL) || numArgumentos == 1 ||
+     numArgumentos > 3){
+    fprintf(stderr, "[!] Se deben indicar el número de productores y el de "
+                    "consumidores\nUtiliza %s -h para ver el modo de uso\n",
+            argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  if(numArgumentos >= 2 &&
+     (asignarConfiguracion(&configuracion, "productores", argv[optind]) != 0 ||
+      asignarConfiguracion(&configuracion, "consumidores",
+                           argv[optind + 1]) != 0)){
+    exit(EXIT_FAILURE);
+  }
 
+  // En caso de que no se indique la opción por defecto ni ninguno de los
+  // parámetros de los hilos, se pide al usuario que los indique. Las
+  // respuestas se validan igual que las opciones. Con un fichero de entrada
+  // los items son sus líneas, por lo que no se pregunta nada
+  if(numArgumentos <= 2 && fichero == NULL && !configuracion.parametrosHilos &&
+     configuracion.entrada[0] == '\0'){
+    preguntar(&configuracion, "[?] ¿Tiempo de producción? ",
+              "tiempo_produccion");
+    preguntar(&configuracion, "[?] ¿Tiempo de consumición? ",
+              "tiempo_consumicion");
+    preguntar(&configuracion, "[?] ¿Tiempo de post producción? ",
+              "post_produccion");
+    preguntar(&configuracion, "[?] ¿Tiempo de post consumición? ",
+              "post_consumicion");
+    preguntar(&configuracion, "[?] ¿Producciones a realizar por hilo? ",
+              "producciones");
+  }
+
+  // Sin trabajadores no se admiten más hilos de los que se pueden crear
+  if(comprobarConfiguracion(&configuracion) != 0){
+    exit(EXIT_FAILURE);
+  }
+
+  // Esta implementación no reparte la cola en fragmentos
+  if(configuracion.fragmentos != 1){
+    fprintf(stderr, "[!] Esta implementación no admite fragmentos\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Se aplica la configuración
+  numProductores = configuracion.numProductores;
+  numConsumidores = configuracion.numConsumidores;
+  lote = configuracion.lote;
+  usarFutex = configuracion.estrategia == ESTRATEGIA_FUTEX;
+  usarAvisos = configuracion.estrategia == ESTRATEGIA_EVENTFD;
+  maximoEspera = configuracion.pausas;
+  medir = configuracion.medir;
+  modoFibras = configuracion.trabajadores > 0;
+  modoLineas = configuracion.entrada[0] != '\0';
+
+  // Las fibras no pueden dormir en un futex o un descriptor ni esperar
+  // activamente sin bloquear a su trabajador, y la afinidad se asigna por hilo
+  if(modoFibras){
+    if(configuracion.estrategia != ESTRATEGIA_CONDICIONES ||
+       strcmp(configuracion.afinidad, "ninguna") != 0){
+      fprintf(stderr, "[!] Los trabajadores solo se pueden combinar con la "
+                      "estrategia 'condiciones' y sin afinidad\n");
+      exit(EXIT_FAILURE);
+    }
+    maximoEspera = 0;
+  }
+
+  // Se calcula la CPU de cada hilo antes de reservar los buffers, que se
+  // ubican en el nodo de los consumidores
+  if(crearAfinidad(&afinidad, configuracion.afinidad, numProductores) != 0){
+    exit(EXIT_FAILURE);
   }
 
   // Se reserva memoria para los productores y consumidores
@@ -201,28 +648,49 @@ int main(int argc, char *argv[]){
   consumidores = (HiloConsumidor*) malloc(sizeof(HiloConsumidor)*
                                           numConsumidores);
 
-  // En caso de que el número argumentos solo sean 3, se pide al usuario los
-  // parámetros para los hilos
-  if(argc <= 3){
-    printf("[?] ¿Tiempo de producción? ");
-    scanf("%d", &(productores[0].tiempo));
-    printf("[?] ¿Tiempo de consumición? ");
-    scanf("%d", &(consumidores[0].tiempo));
-    printf("[?] ¿Tiempo de post producción? ");
-    scanf("%d", &(productores[0].postProduccion));
-    printf("[?] ¿Tiempo de post consumición? ");
-    scanf("%d", &(consumidores[0].postConsumicion));
-    printf("[?] ¿Producciones a realizar por hilo? ");
-    scanf("%d", &(productores[0].numProducciones));
-  } else {
-    // En caso contrario se establecen los valores por defecto.
-    // Al establecer los tiempos a -1 se utilizarán tiempos aleatorios entre 0 y
-    // 4 segundos.
-    productores[0].tiempo = 2;
-    productores[0].postProduccion = -1;
-    consumidores[0].tiempo = 1;
-    consumidores[0].postConsumicion = -1;
-    productores[0].numProducciones = 10;
+  // Los parámetros del primer hilo de cada tipo se duplican para el resto. Al
+  // establecer los tiempos a -1 se utilizarán tiempos aleatorios entre 0 y 4
+  // segundos
+  productores[0].tiempo = configuracion.tiempoProduccion;
+  productores[0].postProduccion = configuracion.postProduccion;
+  consumidores[0].tiempo = configuracion.tiempoConsumicion;
+  consumidores[0].postConsumicion = configuracion.postConsumicion;
+  productores[0].numProducciones = configuracion.producciones;
+  if(modoLineas){
+    // Cada productor termina cuando se acaba su parte del fichero, y los
+    // tiempos aleatorios, que no se preguntan, no se utilizan
+    productores[0].numProducciones = INT_MAX;
+    if(productores[0].postProduccion < 0){
+      productores[0].postProduccion = 0;
+    }
+    if(consumidores[0].postConsumicion < 0){
+      consumidores[0].postConsumicion = 0;
+    }
+  }
+
+  // El tamaño del lote es el mismo para productores y consumidores
+  productores[0].lote = lote;
+  consumidores[0].lote = lote;
+
+  // Se utilizan las funciones de trabajo por defecto o, con la opción -i, las
+  // que reparten las líneas del fichero de entrada. La salida se abre con
+  // O_APPEND para que cada escritura agrupada se añada completa
+  productores[0].producir = producir;
+  consumidores[0].consumir = consumir;
+  if(modoLineas){
+    if(abrirFicheroLineas(&entrada, configuracion.entrada,
+                          numProductores) != 0){
+      exit(EXIT_FAILURE);
+    }
+    salida = open(configuracion.salida,
+                  O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if(salida < 0){
+      fprintf(stderr, "[!] No se puede abrir el fichero de salida '%s': %s\n",
+              configuracion.salida, strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+    productores[0].producir = producirLinea;
+    consumidores[0].consumir = consumirLinea;
   }
 
   // Se inicializan los mutexes a usar explicados en la cabecera del programa
@@ -232,27 +700,101 @@ int main(int argc, char *argv[]){
   // hilos
   pthread_cond_init(&condProductor, NULL);
   pthread_cond_init(&condConsumidor, NULL);
+  iniciarEvento(&eventoNoLlena);
+  iniciarEvento(&eventoNoVacia);
+  if(usarAvisos && (crearAviso(&avisoNoLlena) != 0 ||
+                    crearAviso(&avisoNoVacia) != 0)){
+    fprintf(stderr, "[!] No se han podido crear los avisos: %s\n",
+            strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+  iniciarCondicionFibra(&condFibraProductor);
+  iniciarCondicionFibra(&condFibraConsumidor);
+  if(modoFibras){
+    iniciarPlanificador(&planificador, configuracion.trabajadores,
+                        FIBRA_TAM_PILA);
+  }
 
   // Se llama a la función de crearBuffer para obtener un buffer del tamaño
   // indicado
-  buffer = crearBuffer(TAM_BUFFER);
+  buffer = crearBuffer(configuracion.tamBuffer);
+  ubicarMemoria(&afinidad, buffer.valores, sizeof(int)*buffer.tam,
+                cpuConsumidor(&afinidad, 0));
+
+  // Con un único productor y un único consumidor no es necesaria la exclusión
+  // mutua, por lo que se utiliza el buffer SPSC. Sus esperas bloquean al hilo,
+  // por lo que no se utiliza con fibras. El fin de la producción se señala
+  // cerrando el buffer principal, que no se utiliza para nada más
+  if(numProductores == 1 && numConsumidores == 1 && !modoFibras){
+    modoSPSC = 1;
+    bufferSPSC = crearBufferSPSC(configuracion.tamBuffer);
+    ubicarMemoria(&afinidad, bufferSPSC.valores, sizeof(int)*bufferSPSC.tam,
+                  cpuConsumidor(&afinidad, 0));
+  }
+
+  // Se deja constancia de la ubicación de los hilos junto con los resultados
+  if(afinidad.politica != AFINIDAD_NINGUNA){
+    imprimirAfinidad(&afinidad, numProductores, numConsumidores, stdout);
+  }
+
+  // Se inicia el hilo que escribe por pantalla los mensajes de los hilos
+  iniciarRegistro(configuracion.nivel, stdout);
 
   // Se crean los productores y consumidores, pasándole a estas funciones los
   // arrays con la información de los hilos correspondientes.
   //
   // El primer elemento de cada array contiene la información que deberá ser
   // duplicada para el resto de hilos
+  inicioLineas = instanteMonotono();
   crearProductores(productores, numProductores);
   crearConsumidores(consumidores, numConsumidores);
 
-  // Las funciones join realizan un pthread_join sobre todos los Hilos
-  // La función joinProductores realiza un join sobre los productores, que serán
-  // en gran parte de los casos los primeros en acabar.
-  joinProductores(productores, numProductores);
+  if(modoFibras){
+    // Los trabajadores ejecutan las fibras hasta que terminan todas
+    ejecutarPlanificador(&planificador);
+    destruirPlanificador(&planificador);
+  } else {
+    // Las funciones join realizan un pthread_join sobre todos los Hilos
+    // La función joinProductores realiza un join sobre los productores, que
+    // serán en gran parte de los casos los primeros en acabar.
+    joinProductores(productores, numProductores);
+
+    // La función joinConsumidores realiza un join sobre los consumidores, que
+    // serán, en la gran parte de los casos, los últimos en finalizar.
+    joinConsumidores(consumidores, numConsumidores);
+  }
+
+  // Con la opción -i se escriben las líneas que aún tiene cada consumidor, y
+  // el tiempo medido incluye la lectura y la escritura de todo el fichero
+  if(modoLineas){
+    for(i = 0; i < numConsumidores; i++){
+      if(vaciarEscritura(&consumidores[i].escritura) != 0){
+        fprintf(stderr, "[!] No se puede escribir en el fichero de salida: "
+                        "%s\n", strerror(errno));
+        exit(EXIT_FAILURE);
+      }
+      numLineas += consumidores[i].escritura.lineas;
+      bytesLineas += consumidores[i].escritura.bytes;
+    }
+    duracionLineas = instanteMonotono() - inicioLineas;
+  }
+
+  // Se escriben los mensajes pendientes y se finaliza el registro
+  finalizarRegistro();
 
-  // La función joinConsumidores realiza un join sobre los consumidores, que
-  // serán, en la gran parte de los casos, los últimos en finalizar.
-  joinConsumidores(consumidores, numConsumidores);
+  // Se imprimen las duraciones de las fases de todos los hilos
+  if(medir){
+    imprimirFases(productores, numProductores, consumidores, numConsumidores);
+  }
+
+  if(modoLineas){
+    printf("[i] Se han escrito %llu líneas (%llu bytes) en %.3f s: %.3f GB/s\n",
+           (unsigned long long) numLineas, (unsigned long long) bytesLineas,
+           duracionLineas / 1e9,
+           duracionLineas > 0 ? (double) bytesLineas / duracionLineas : 0.0);
+    close(salida);
+    cerrarFicheroLineas(&entrada);
+  }
 
   // Se destruyen los mutexes una vez finalizada su función
   pthread_mutex_destroy(&mutexRegion);
@@ -260,9 +802,18 @@ int main(int argc, char *argv[]){
   // Se destruye la variable de condición
   pthread_cond_destroy(&condProductor);
   pthread_cond_destroy(&condConsumidor);
+  if(usarAvisos){
+    destruirAviso(&avisoNoLlena);
+    destruirAviso(&avisoNoVacia);
+  }
 
   // Se destruye el buffer
   destruirBuffer(&buffer);
+  if(modoSPSC){
+    destruirBufferSPSC(&bufferSPSC);
+  }
+
+  destruirAfinidad(&afinidad);
 
   // El proceso finaliza
   exit(EXIT_SUCCESS);
@@ -272,6 +823,16 @@ void crearProductores(HiloProductor* hilos, unsigned int numProductores){
   // Contador
   int i;
 
+  // Resultado de la creación de cada hilo
+  int error;
+
+  // Atributos del hilo, con la CPU que le asigna la afinidad
+  pthread_attr_t atributos;
+
+  // Se registran todos los productores antes de crear el primero, de forma que
+  // el buffer no se pueda cerrar mientras quede alguno por terminar
+  registrarProductores(&buffer, numProductores);
+
   for(i = 0; i < numProductores; i++){
     // Se asigna el id correspondiente al hilo, en función del orden
     hilos[i].id = i;
@@ -282,21 +843,43 @@ void crearProductores(HiloProductor* hilos, unsigned int numProductores){
     hilos[i].numProducciones = hilos[0].numProducciones;
     hilos[i].postProduccion = hilos[0].postProduccion;
     hilos[i].tiempo = hilos[0].tiempo;
-
-    // Se incrementan el número de producciones en función de las que vaya a
-    // hacer el hilo correspondiente
-    incrementarProducciones(&buffer, hilos[i].numProducciones);
+    hilos[i].lote = hilos[0].lote;
+    hilos[i].producir = hilos[0].producir;
+    hilos[i].fases = crearFases();
 
     // Se crea el hilo, almacenando la información en su variable concreta.
     // El hilo ejecutará la función 'productor' que recibe como parámetro el
-    // puntero a la información del hilo correspondiente
-    pthread_create(&(hilos[i].tid), NULL, (void*)productor, hilos+i);
+    // puntero a la información del hilo correspondiente. Los atributos fijan
+    // la CPU que le asigna la afinidad
+    if(modoFibras){
+      // Con la opción -t se crea una fibra en lugar de un hilo
+      if(crearFibra(&planificador, (FuncionFibra) productor, hilos+i) != 0){
+        fprintf(stderr, "[!] No se ha podido crear la fibra del productor "
+                        "%d\n", i);
+        exit(EXIT_FAILURE);
+      }
+    } else {
+      pthread_attr_init(&atributos);
+      fijarAfinidad(&atributos, cpuProductor(&afinidad, i));
+      error = pthread_create(&(hilos[i].tid), &atributos,
+                             modoSPSC ? (void*)productorSPSC
+                                      : (void*)productor,
+                             hilos+i);
+      pthread_attr_destroy(&atributos);
+      if(error != 0){
+        fprintf(stderr, "[!] No se ha podido crear el hilo del productor %d: "
+                        "%s\n", i, strerror(error));
+        exit(EXIT_FAILURE);
+      }
+    }
   }
 
 }
 
 void crearConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
   int i;
+  int error;
+  pthread_attr_t atributos;
 
   for(i = 0; i < numConsumidores; i++){
     // Se asigna el id correspondiente al hilo, en función del orden
@@ -306,11 +889,38 @@ void crearConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
     // hilo
     hilos[i].tiempo = hilos[0].tiempo;
     hilos[i].postConsumicion = hilos[0].postConsumicion;
+    hilos[i].lote = hilos[0].lote;
+    hilos[i].consumir = hilos[0].consumir;
+    hilos[i].fases = crearFases();
+    if(modoLineas){
+      iniciarEscrituraLineas(&hilos[i].escritura, salida);
+    }
 
     // Se crea el hilo, almacenando la información en su variable concreta.
     // El hilo ejecutará la función 'consumidor' que recibe como parámetro el
-    // puntero a la información del hilo correspondiente
-    pthread_create(&(hilos[i].tid), NULL, (void*)consumidor, hilos+i);
+    // puntero a la información del hilo correspondiente. Los atributos fijan
+    // la CPU que le asigna la afinidad
+    if(modoFibras){
+      // Con la opción -t se crea una fibra en lugar de un hilo
+      if(crearFibra(&planificador, (FuncionFibra) consumidor, hilos+i) != 0){
+        fprintf(stderr, "[!] No se ha podido crear la fibra del consumidor "
+                        "%d\n", i);
+        exit(EXIT_FAILURE);
+      }
+    } else {
+      pthread_attr_init(&atributos);
+      fijarAfinidad(&atributos, cpuConsumidor(&afinidad, i));
+      error = pthread_create(&(hilos[i].tid), &atributos,
+                             modoSPSC ? (void*)consumidorSPSC
+                                      : (void*)consumidor,
+                             hilos+i);
+      pthread_attr_destroy(&atributos);
+      if(error != 0){
+        fprintf(stderr, "[!] No se ha podido crear el hilo del consumidor %d: "
+                        "%s\n", i, strerror(error));
+        exit(EXIT_FAILURE);
+      }
+    }
   }
 }
 
@@ -332,60 +942,215 @@ void joinConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
 
 
 void productor(HiloProductor* hilo){
-  int i;
-  int item;
+  int i, j;
 
-  // Se informa al usuario del número del productor
-  imprimirCabeceraProduc(*hilo, reset);
-  printf("[i] Soy el productor número %d\n", hilo->id);
+  // Items del lote actual, número de items del lote, items del lote ya
+  // insertados y items insertados en la última inserción
+  int items[MAX_LOTE];
+  int numItems, insertados, n;
 
-  // Se crean las producciones indicadas en la información del hilo
-  for(i = 0; i < hilo->numProducciones; i++){
-    // Se produce el item
-    item = producir();
+  // Indica si el productor no tiene más items que producir y si ha sido el
+  // último en terminar, cerrando el buffer
+  int terminado, ultimo;
 
-    imprimirCabeceraProduc(*hilo, tcyan);
-    printf("[*] Intentando acceder a la región crítica\n%s",
-            reset);
+  // Información obtenida dentro de la región crítica que se registra una vez
+  // liberada: veces que el productor se ha dormido, veces que ha despertado a
+  // los consumidores y elementos del buffer tras la inserción
+  int esperas, despertares, elementos;
 
-    // Se intenta acceder a la región crítica
-    pthread_mutex_lock(&mutexRegion);
+  // Instante de inicio de la fase que se está midiendo
+  uint64_t inicioFase;
 
-    // Se comprueba si la cola está llena, ya que en caso de que lo esté, será
-    // necesario dormir al productor esperando a que un consumidor lo despierte
-    while(colaLlena(buffer)){
+  // Con la opción -f, ticket de la espera en el evento e items insertados de
+  // los que aún no se ha notificado a los consumidores
+  uint32_t ticket;
+  int sinNotificar;
 
-      imprimirCabeceraProduc(*hilo, fpurple);
-      printf("[!] La cola está llena. Durmiendo...%s\n", reset);
+  // Indica si aún se puede esperar activamente antes de dormir
+  int girar;
 
-      // Se duerme al productor debido a que la cola está llena, liberando así
-      // la región crítica para que pueda entrar un consumidor a despertarlo
-      pthread_cond_wait(&condProductor, &mutexRegion);
+  // Se crea la cola de registro del hilo. Las fibras no tienen anillo propio
+  // y escriben en el del trabajador que las ejecuta
+  hilo->registro = modoFibras ? crearColaRegistroCompartida('P', hilo->id)
+                              : crearColaRegistro('P', hilo->id);
+  iniciarEsperaActiva(&hilo->espera, maximoEspera);
 
+  // Se informa al usuario del número del productor
+  registrar(hilo->registro, REGISTRO_EVENTOS, reset,
+            "[i] Soy el productor número %d\n", hilo->id, 0, 0, 0);
+
+  // Se crean las producciones indicadas en la información del hilo, en lotes
+  // de como mucho 'lote' items
+  for(i = 0; i < hilo->numProducciones; i += numItems){
+    // Se produce el lote de items antes de acceder a la región crítica, por lo
+    // que el tiempo de producción no bloquea al resto de hilos. El último lote
+    // puede ser menor si el número de producciones no es múltiplo del tamaño
+    // del lote
+    numItems = hilo->numProducciones - i;
+    if(numItems > hilo->lote){
+      numItems = hilo->lote;
+    }
+    for(j = 0; j < numItems; j++){
+      inicioFase = iniciarFase();
+      items[j] = hilo->producir(hilo);
+      finalizarFase(hilo->fases, FASE_TRABAJO, inicioFase);
+      if(items[j] < 0){
+        break;
+      }
     }
 
-    // Se inserta en el buffer, indicando el tiempo de producción que se tardará
-    insertarBufferTime(&buffer, item, hilo->tiempo);
-    imprimirCabeceraProduc(*hilo, tgreen);
-    printf("[%d / %d] He fabricado el valor: %d\n%s", i+1,
-            hilo->numProducciones, item, reset);
-    imprimirBuffer(buffer);
+    // Si la función de trabajo no tiene más items, el lote se queda con los
+    // producidos hasta entonces. Tanto en ese caso como en el del último lote,
+    // este es el último acceso del productor, que cierra el buffer sin
+    // realizar la espera post producción
+    terminado = j < numItems || i + j >= hilo->numProducciones;
+    numItems = j;
+
+    // Si la función de trabajo se ha agotado justo al empezar el lote, algo
+    // habitual al repartir las líneas de un fichero, no hay nada que insertar
+    // y se pasa directamente al cierre
+    if(numItems == 0 && terminado){
+      break;
+    }
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[*] Intentando acceder a la región crítica\n", 0, 0, 0, 0);
 
-    // En caso de que el número de elementos del buffer ahora sea 1, es porque
-    // la cola estaba vacía, por lo tanto se despierta al consumidor
-    if(numElementos(buffer) == 1){
-      imprimirCabeceraProduc(*hilo, tpurple);
-      printf("[!] Despertando al consumidor.\n%s", reset);
+    esperas = 0;
+    despertares = 0;
+    sinNotificar = 0;
 
-      // Se despierta al consumidor
-      pthread_cond_signal(&condConsumidor);
+    // Se intenta acceder a la región crítica
+    inicioFase = iniciarFase();
+    bloquearRegion();
+    finalizarFase(hilo->fases, FASE_REGION, inicioFase);
+
+    // Se insertan todos los items del lote. Si el buffer se llena a mitad del
+    // lote, el productor se duerme con la parte ya insertada visible para los
+    // consumidores
+    for(insertados = 0; insertados < numItems; insertados += n){
+
+      // Se comprueba si la cola está llena, ya que en caso de que lo esté, será
+      // necesario dormir al productor esperando a que un consumidor lo
+      // despierte
+      girar = esperaActivaHabilitada(&hilo->espera);
+      while(colaLlena(&buffer)){
+
+        // Antes de dormir se espera activamente, fuera de la región crítica, a
+        // que un consumidor libere alguna posición. Después se vuelve a
+        // comprobar la cola con la región crítica bloqueada
+        if(girar){
+          girar = 0;
+          pthread_mutex_unlock(&mutexRegion);
+          if(usarFutex && sinNotificar > 0 &&
+             notificarEvento(&eventoNoVacia, sinNotificar)){
+            despertares++;
+          }
+          if(usarAvisos && sinNotificar > 0 && avisar(&avisoNoVacia)){
+            despertares++;
+          }
+          sinNotificar = 0;
+          esperarActivamente(&hilo->espera, hayHueco, &buffer);
+          bloquearRegion();
+          continue;
+        }
+
+        // Se duerme al productor debido a que la cola está llena, liberando así
+        // la región crítica para que pueda entrar un consumidor a despertarlo
+        esperas++;
+        inicioFase = iniciarFase();
+        if(usarFutex){
+          // La espera se prepara antes de liberar la región crítica, por lo que
+          // la cola no puede cambiar entre la comprobación y la preparación.
+          // Antes de dormir se notifica a los consumidores de los items ya
+          // insertados del lote
+          ticket = prepararEspera(&eventoNoLlena);
+          pthread_mutex_unlock(&mutexRegion);
+          if(sinNotificar > 0 && notificarEvento(&eventoNoVacia, sinNotificar)){
+            despertares++;
+          }
+          sinNotificar = 0;
+          esperarEvento(&eventoNoLlena, ticket);
+          bloquearRegion();
+        } else if(usarAvisos){
+          // El aviso se limpia con la región crítica bloqueada, por lo que la
+          // cola no puede cambiar antes de limpiarlo y cualquier consumición
+          // posterior vuelve a hacer legible el descriptor
+          limpiarAviso(&avisoNoLlena);
+          pthread_mutex_unlock(&mutexRegion);
+          if(sinNotificar > 0 && avisar(&avisoNoVacia)){
+            despertares++;
+          }
+          sinNotificar = 0;
+          esperarAviso(&avisoNoLlena);
+          bloquearRegion();
+        } else {
+          productoresEsperando++;
+          esperarCondicion(&condProductor, &condFibraProductor);
+          productoresEsperando--;
+        }
+        finalizarFase(hilo->fases, FASE_CONDICION, inicioFase);
+
+      }
+
+      // Se insertan en el buffer tantos items del lote como quepan
+      n = insertarBufferN(&buffer, items + insertados, numItems - insertados);
+
+      // Con la opción -f se notifica a los consumidores fuera de la región
+      // crítica
+      sinNotificar += n;
+
+      // En caso de que haya consumidores dormidos se despierta a uno, o a todos
+      // ellos si se ha insertado más de un item
+      if(!usarFutex && !usarAvisos && consumidoresEsperando > 0){
+        despertares++;
+
+        // Se despierta al consumidor
+        despertar(&condConsumidor, &condFibraConsumidor, n > 1);
+      }
     }
 
+    elementos = numElementos(&buffer);
+
     // Se libera la región crítica
     pthread_mutex_unlock(&mutexRegion);
 
-    imprimirCabeceraProduc(*hilo, tcyan);
-    printf("[i] Región crítica liberada\n%s", reset);
+    if(usarFutex && sinNotificar > 0 &&
+       notificarEvento(&eventoNoVacia, sinNotificar)){
+      despertares++;
+    }
+    if(usarAvisos && sinNotificar > 0 && avisar(&avisoNoVacia)){
+      despertares++;
+    }
+
+    // Lo ocurrido dentro de la región crítica se registra una vez liberada
+    if(esperas > 0){
+      registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                "[!] La cola estaba llena. Me he dormido %d veces\n", esperas,
+                0, 0, 0);
+    }
+    if(numItems == 1){
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[%d / %d] He fabricado el valor: %d\n", i+1,
+                hilo->numProducciones, items[0], 0);
+    } else {
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[%d / %d] He fabricado %d valores\n", i+numItems,
+                hilo->numProducciones, numItems, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tyellow,
+              "[i] Elementos en el buffer: %d / %d\n", elementos,
+              tamano(&buffer), 0, 0);
+    if(despertares > 0){
+      registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+                "[!] Despertando al consumidor.\n", 0, 0, 0, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[i] Región crítica liberada\n", 0, 0, 0, 0);
+
+    if(terminado){
+      break;
+    }
 
     // Se realiza la post producción, en caso de que el tiempo indicado sea
     // negativo, se escoge un tiempo aleatorio entre 0 y 4
@@ -393,107 +1158,221 @@ void productor(HiloProductor* hilo){
       hilo->postProduccion = rand()%5;
     }
 
-    imprimirCabeceraProduc(*hilo, tpurple);
-    printf("[*] Realizando espera post producción de %d segundos\n%s",
-            hilo->postProduccion, reset);
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post producción de %d ms\n",
+              (int)(hilo->postProduccion * 1000), 0, 0, 0);
 
-    if(hilo->postProduccion > 0)
-      sleep(hilo->postProduccion);
+    dormir(hilo->postProduccion);
   }
 
-  imprimirCabeceraProduc(*hilo, tred);
-  printf("[!] He acabado de producir. Finalizando...\n%s", reset);
+  // El último productor en terminar cierra el buffer. Ninguna inserción
+  // volverá a despertar a los consumidores dormidos, por lo que los despierta
+  // a todos para que vean la cola cerrada y vacía. El cierre se realiza con la
+  // región crítica bloqueada, de forma que no pueda ocurrir entre la
+  // comprobación de un consumidor y su espera
+  bloquearRegion();
+  ultimo = terminarProductor(&buffer);
+  if(ultimo){
+    despertar(&condConsumidor, &condFibraConsumidor, 1);
+  }
+  pthread_mutex_unlock(&mutexRegion);
+
+  if(ultimo && usarFutex){
+    notificarTodos(&eventoNoVacia);
+  }
+  if(ultimo && usarAvisos){
+    avisar(&avisoNoVacia);
+  }
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+            "[!] He acabado de producir. Finalizando...\n", 0, 0, 0, 0);
 
   // El hilo finaliza correctamente
-  pthread_exit(EXIT_SUCCESS);
+  return;
 }
 
 void consumidor(HiloConsumidor* hilo){
   // Contador del número de consumiciones
   int i = 1;
-  int item;
 
-  // Bucle infinito hasta que el número de producciones llegue a 0
+  // Items sacados del buffer y número de items sacados
+  int items[MAX_LOTE];
+  int n, j;
+
+  // Información obtenida dentro de la región crítica que se registra una vez
+  // liberada: veces que el consumidor se ha dormido, si ha despertado a los
+  // productores y elementos del buffer tras sacar los items
+  int esperas, desperto, elementos;
+
+  // Instante de inicio de la fase que se está midiendo
+  uint64_t inicioFase;
+
+  // Con la opción -f, ticket de la espera en el evento
+  uint32_t ticket;
+
+  // Indica si aún se puede esperar activamente antes de dormir
+  int girar;
+
+  // Con la estrategia 'eventfd', bucle de 'epoll' del consumidor y suceso
+  // registrado en él
+  int bucle = -1;
+  struct epoll_event suceso;
+
+  // Se crea la cola de registro del hilo. Las fibras no tienen anillo propio
+  // y escriben en el del trabajador que las ejecuta
+  hilo->registro = modoFibras ? crearColaRegistroCompartida('C', hilo->id)
+                              : crearColaRegistro('C', hilo->id);
+  iniciarEsperaActiva(&hilo->espera, maximoEspera);
+
+  // El consumidor espera a que la cola no esté vacía en su propio bucle de
+  // eventos, en el que podría atender también otros descriptores. El aviso se
+  // registra por nivel, de forma que todos los consumidores despiertan mientras
+  // esté pendiente
+  if(usarAvisos){
+    suceso.events = EPOLLIN;
+    suceso.data.fd = descriptorAviso(&avisoNoVacia);
+    bucle = epoll_create1(EPOLL_CLOEXEC);
+    if(bucle < 0 ||
+       epoll_ctl(bucle, EPOLL_CTL_ADD, suceso.data.fd, &suceso) != 0){
+      fprintf(stderr, "[!] No se ha podido crear el bucle de eventos del "
+                      "consumidor %d: %s\n", hilo->id, strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // Bucle infinito hasta que el buffer esté cerrado y vacío
   while(1){
 
-    imprimirCabeceraConsum(*hilo, tcyan);
-    printf("[*] Intentando acceder a la región crítica...\n%s",
-            reset);
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[*] Intentando acceder a la región crítica...\n", 0, 0, 0, 0);
 
-    // Se intenta acceder a la región crítica del consumidor
-    pthread_mutex_lock(&mutexRegion);
-
-    // Se comprueba el número de producciones que aún no han sido consumidas. En
-    // caso de que sean 0 el consumidor finaliza su ejecución
-    if(obtenerProducciones(buffer) == 0){
-      imprimirCabeceraConsum(*hilo, tred);
-      printf("[!] No quedan producciones. Finalizando...\n%s", reset);
+    esperas = 0;
+    desperto = 0;
 
-      // Se realiza un broadcast a todos los consumidores, ya que como las
-      // producciones han llegado a 0 eso implica que no hay más productores y,
-      // por lo tanto, que puede que algunos consumidores se hayan quedado
-      // bloqueados en los pthread_cond_wait
-      pthread_cond_broadcast(&condConsumidor);
-      // Se libera la región crítica
-      pthread_mutex_unlock(&mutexRegion);
-      pthread_exit(EXIT_SUCCESS);
-    }
+    // Se intenta acceder a la región crítica del consumidor
+    inicioFase = iniciarFase();
+    bloquearRegion();
+    finalizarFase(hilo->fases, FASE_REGION, inicioFase);
 
     // Se comprueba que la cola no esté vacía, ya que en caso de que lo esté no
     // se podrá consumir y el consumidor deberá bloquearse
-    while(colaVacia(buffer)){
-      imprimirCabeceraConsum(*hilo, fpurple);
-      printf("[!] La cola está vacía. Durmiendo...%s\n", reset);
-
-      // Se ejecuta el pthread_cond_wait para que el consumidor se bloquee,
-      // liberando la región crítica para que pueda entrar un productor a
-      // desbloquearlo
-      pthread_cond_wait(&condConsumidor, &mutexRegion);
+    girar = esperaActivaHabilitada(&hilo->espera);
+    while(colaVacia(&buffer)){
+
+      // Si además el buffer está cerrado ya no se insertarán más items y el
+      // consumidor finaliza su ejecución. El último productor cierra el buffer
+      // con la región crítica bloqueada y despierta a todos los consumidores,
+      // por lo que ninguno se queda dormido
+      if(bufferCerrado(&buffer)){
+        pthread_mutex_unlock(&mutexRegion);
 
-      // Una vez se despierta al consumidor es necesario comprobar que el número
-      // de producciones no es cero
+        // El aviso ya no se vuelve a limpiar, por lo que el descriptor queda
+        // legible para el resto de consumidores
+        if(usarAvisos){
+          close(bucle);
+        }
 
-      if(obtenerProducciones(buffer) == 0){
-        imprimirCabeceraConsum(*hilo, tred);
-        printf("[!] No quedan producciones. Finalizando...\n%s", reset);
+        registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+                  "[!] No quedan producciones. Finalizando...\n", 0, 0, 0, 0);
+        return;
+      }
 
-        // Se libera la región crítica
+      if(girar){
+        // Antes de dormir se espera activamente, fuera de la región crítica, a
+        // que un productor inserte algún item
+        girar = 0;
         pthread_mutex_unlock(&mutexRegion);
-        pthread_exit(EXIT_SUCCESS);
+        esperarActivamente(&hilo->espera, hayElementos, &buffer);
+        bloquearRegion();
+      } else {
+        // Se ejecuta el pthread_cond_wait para que el consumidor se bloquee,
+        // liberando la región crítica para que pueda entrar un productor a
+        // desbloquearlo
+        esperas++;
+        inicioFase = iniciarFase();
+        if(usarFutex){
+          ticket = prepararEspera(&eventoNoVacia);
+          pthread_mutex_unlock(&mutexRegion);
+          esperarEvento(&eventoNoVacia, ticket);
+          bloquearRegion();
+        } else if(usarAvisos){
+          limpiarAviso(&avisoNoVacia);
+          pthread_mutex_unlock(&mutexRegion);
+          while(epoll_wait(bucle, &suceso, 1, -1) < 0 && errno == EINTR);
+          bloquearRegion();
+        } else {
+          consumidoresEsperando++;
+          esperarCondicion(&condConsumidor, &condFibraConsumidor);
+          consumidoresEsperando--;
+        }
+        finalizarFase(hilo->fases, FASE_CONDICION, inicioFase);
       }
     }
 
-    // Se saca el item del buffer, indicando el tiempo que se desea que dure la
-    // operación
-    item = sacarBufferTime(&buffer, hilo->tiempo);
+    // Se sacan del buffer como mucho 'lote' items. Su consumición se realiza
+    // una vez liberada la región crítica
+    n = sacarBufferN(&buffer, items, hilo->lote);
+    elementos = numElementos(&buffer);
 
-    // Se decrementa en 1 el número de producciones que quedan por consumir
-    incrementarProducciones(&buffer, -1);
-
-    imprimirCabeceraConsum(*hilo, tgreen);
-    printf("[Nª: %d] He consumido el valor: %d\n%s", i, item, reset);
-
-    imprimirCabeceraConsum(*hilo, tyellow);
-    printf("[i] Quedan por consumidor %d elementos\n%s",
-            obtenerProducciones(buffer), reset);
-
-    imprimirBuffer(buffer);
-
-    // Se comprueba que, en el caso de que la cola estuviese llena antes de
-    // sacar el elemento se despierte al productor
-    if(numElementos(buffer) == tamano(buffer) - 1){
-      imprimirCabeceraConsum(*hilo, tpurple);
-      printf("[!] Despertando al productor...\n%s", reset);
+    // En caso de que haya productores dormidos se despierta a uno, o a todos
+    // ellos si se ha liberado más de una posición. No basta con comprobar si la
+    // cola estaba llena, ya que con varios productores dormidos el resto no
+    // volvería a ser despertado
+    if(!usarFutex && !usarAvisos && productoresEsperando > 0){
+      desperto = 1;
 
       // Se lanza la señal para despertar al productor
-      pthread_cond_signal(&condProductor);
+      despertar(&condProductor, &condFibraProductor, n > 1);
     }
 
     // Se libera la región crítica
     pthread_mutex_unlock(&mutexRegion);
 
-    imprimirCabeceraConsum(*hilo, tcyan);
-    printf("[i] Región crítica liberada\n%s", reset);
+    if(usarFutex && notificarEvento(&eventoNoLlena, n)){
+      desperto = 1;
+    }
+    if(usarAvisos && avisar(&avisoNoLlena)){
+      desperto = 1;
+    }
+
+    // Lo ocurrido dentro de la región crítica se registra una vez liberada
+    if(esperas > 0){
+      registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                "[!] La cola estaba vacía. Me he dormido %d veces\n", esperas,
+                0, 0, 0);
+    }
+    if(n == 1){
+      registrar(hilo->registro, REGISTRO_DETALLE, tgreen,
+                "[Nª: %d] He sacado el valor: %d\n", i, items[0], 0, 0);
+    } else {
+      registrar(hilo->registro, REGISTRO_DETALLE, tgreen,
+                "[Nª: %d] He sacado %d valores\n", i, n, 0, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tyellow,
+              "[i] Elementos en el buffer: %d / %d\n", elementos,
+              tamano(&buffer), 0, 0);
+    if(desperto){
+      registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+                "[!] Despertando al productor...\n", 0, 0, 0, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[i] Región crítica liberada\n", 0, 0, 0, 0);
+
+    // Se consumen los items fuera de la región crítica, tardando el tiempo de
+    // consumición indicado
+    for(j = 0; j < n; j++){
+      inicioFase = iniciarFase();
+      hilo->consumir(hilo, items[j]);
+      finalizarFase(hilo->fases, FASE_TRABAJO, inicioFase);
+    }
+
+    if(n == 1){
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[Nª: %d] He consumido el valor: %d\n", i, items[0], 0, 0);
+    } else {
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[Nª: %d] He consumido %d valores\n", i, n, 0, 0);
+    }
 
     // Se realiza una espera de post consumición antes de volver a pedir la
     // región crítica.
@@ -501,39 +1380,289 @@ void consumidor(HiloConsumidor* hilo){
       hilo->postConsumicion = rand()%5;
     }
 
-    imprimirCabeceraConsum(*hilo, tpurple);
-    printf("[*] Realizando espera post consumición de %d segundos\n%s",
-            hilo->postConsumicion, reset);
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post consumición de %d ms\n",
+              (int)(hilo->postConsumicion * 1000), 0, 0, 0);
 
-    if(hilo->postConsumicion > 0)
-      sleep(hilo->postConsumicion);
+    dormir(hilo->postConsumicion);
 
     // Se incrementa el número de consumiciones
-    i++;
+    i += n;
+  }
+}
+
+void productorSPSC(HiloProductor* hilo){
+  int i;
+  int item;
+  unsigned int intentos;
+  uint64_t inicioFase;
+
+  hilo->registro = crearColaRegistro('P', hilo->id);
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, reset,
+            "[i] Soy el productor número %d (buffer SPSC)\n", hilo->id, 0, 0,
+            0);
+
+  for(i = 0; i < hilo->numProducciones; i++){
+    // Se produce el item. Al no existir región crítica, el tiempo de
+    // producción no bloquea al consumidor
+    inicioFase = iniciarFase();
+    item = hilo->producir(hilo);
+    finalizarFase(hilo->fases, FASE_TRABAJO, inicioFase);
+    if(item < 0){
+      break;
+    }
+
+    // Mientras la cola esté llena se espera a que el consumidor saque algún
+    // elemento
+    intentos = 0;
+    while(!insertarBufferSPSC(&bufferSPSC, item)){
+      if(intentos == 0){
+        registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                  "[!] La cola está llena. Esperando...\n", 0, 0, 0, 0);
+      }
+      esperarSPSC(&intentos);
+    }
+
+    registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+              "[%d / %d] He fabricado el valor: %d (elementos: %d)\n", i+1,
+              hilo->numProducciones, item, numElementosSPSC(&bufferSPSC));
+
+    if(hilo->postProduccion < 0){
+      hilo->postProduccion = rand()%5;
+    }
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post producción de %d ms\n",
+              (int)(hilo->postProduccion * 1000), 0, 0, 0);
+
+    dormir(hilo->postProduccion);
+  }
+
+  // Al ser el único productor, cierra el buffer principal. El cierre se publica
+  // después de la última inserción en el buffer SPSC
+  terminarProductor(&buffer);
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+            "[!] He acabado de producir. Finalizando...\n", 0, 0, 0, 0);
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidorSPSC(HiloConsumidor* hilo){
+  int i;
+  int item;
+  int sacado, cerrado;
+  unsigned int intentos;
+  uint64_t inicioFase;
+
+  hilo->registro = crearColaRegistro('C', hilo->id);
+
+  for(i = 1; ; i++){
+    // Mientras la cola esté vacía se espera a que el productor inserte algún
+    // elemento o cierre el buffer. Tras ver el buffer cerrado se vuelve a
+    // intentar sacar, ya que el productor pudo insertar antes de cerrarlo: si
+    // la cola sigue vacía ya no llegarán más items
+    intentos = 0;
+    cerrado = 0;
+    while(!(sacado = sacarBufferSPSC(&bufferSPSC, &item)) && !cerrado){
+      cerrado = bufferCerrado(&buffer);
+      if(!cerrado){
+        if(intentos == 0){
+          registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                    "[!] La cola está vacía. Esperando...\n", 0, 0, 0, 0);
+        }
+        esperarSPSC(&intentos);
+      }
+    }
+    if(!sacado){
+      break;
+    }
+
+    // El item se consume fuera del buffer, sin bloquear al productor
+    inicioFase = iniciarFase();
+    hilo->consumir(hilo, item);
+    finalizarFase(hilo->fases, FASE_TRABAJO, inicioFase);
+
+    registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+              "[Nª: %d] He consumido el valor: %d\n", i, item, 0, 0);
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tyellow,
+              "[i] Elementos en el buffer: %d\n",
+              numElementosSPSC(&bufferSPSC), 0, 0, 0);
+
+    if(hilo->postConsumicion < 0){
+      hilo->postConsumicion = rand()%5;
+    }
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post consumición de %d ms\n",
+              (int)(hilo->postConsumicion * 1000), 0, 0, 0);
+
+    dormir(hilo->postConsumicion);
   }
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+            "[!] No quedan producciones. Finalizando...\n", 0, 0, 0, 0);
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void esperarSPSC(unsigned int* intentos){
+  if(*intentos < INTENTOS_SPSC){
+    // Mientras el número de intentos sea bajo se cede la CPU, ya que es probable
+    // que el otro hilo cambie el estado del buffer en muy poco tiempo
+    sched_yield();
+    (*intentos)++;
+  } else {
+    usleep(ESPERA_SPSC);
+  }
+}
+
+uint64_t iniciarFase(){
+  return medir ? instanteMonotono() : 0;
+}
+
+void finalizarFase(Histograma* fases, int fase, uint64_t inicio){
+  if(medir){
+    registrarHistograma(&fases[fase], instanteMonotono() - inicio);
+  }
+}
+
+Histograma* crearFases(){
+  Histograma* fases;
+  int i;
+
+  if(!medir){
+    return NULL;
+  }
+
+  fases = (Histograma*) malloc(sizeof(Histograma)*NUM_FASES);
+  for(i = 0; i < NUM_FASES; i++){
+    iniciarHistograma(&fases[i]);
+  }
+
+  return fases;
 }
 
-int producir(){
+void imprimirFases(HiloProductor* productores, unsigned int numProductores,
+                   HiloConsumidor* consumidores, unsigned int numConsumidores){
+  Histograma total;
+  int i, j;
+
+  printf("[i] Duración de las fases de los productores (ns)\n");
+  for(j = 0; j < NUM_FASES; j++){
+    // Se combinan los histogramas de la fase de todos los productores
+    iniciarHistograma(&total);
+    for(i = 0; i < numProductores; i++){
+      combinarHistograma(&total, &productores[i].fases[j]);
+    }
+    imprimirHistograma(stdout, nombresFases[j], &total);
+  }
+
+  printf("[i] Duración de las fases de los consumidores (ns)\n");
+  for(j = 0; j < NUM_FASES; j++){
+    iniciarHistograma(&total);
+    for(i = 0; i < numConsumidores; i++){
+      combinarHistograma(&total, &consumidores[i].fases[j]);
+    }
+    imprimirHistograma(stdout, nombresFases[j], &total);
+  }
+}
+
+int producir(HiloProductor* hilo){
+  dormir(hilo->tiempo);
+
   return rand()%10;
 }
 
-void calcularHora(char* hora){
-  time_t t;
-  struct tm *tim;
+void consumir(HiloConsumidor* hilo, int item){
+  dormir(hilo->tiempo);
+}
+
+int producirLinea(HiloProductor* hilo){
+  return siguienteLinea(&entrada, hilo->id);
+}
+
+void consumirLinea(HiloConsumidor* hilo, int item){
+  const char* texto;
+  size_t longitud;
+
+  // La línea se escribe desde el propio fichero proyectado, sin copiarla
+  texto = textoLinea(&entrada, item, &longitud);
+  if(escribirLinea(&hilo->escritura, texto, longitud) != 0){
+    fprintf(stderr, "[!] No se puede escribir en el fichero de salida: %s\n",
+            strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+}
+
+void preguntar(Configuracion* configuracion, const char* pregunta,
+               const char* clave){
+  char respuesta[64];
+
+  do{
+    printf("%s", pregunta);
+    fflush(stdout);
+    if(scanf("%63s", respuesta) != 1){
+      fprintf(stderr, "\n[!] No se ha indicado el parámetro '%s'\n", clave);
+      exit(EXIT_FAILURE);
+    }
+  } while(asignarConfiguracion(configuracion, clave, respuesta) != 0);
+}
+
+void dormir(double segundos){
+  struct timespec espera;
+
+  if(segundos <= 0){
+    return;
+  }
+
+  if(modoFibras){
+    dormirFibra(segundos);
+    return;
+  }
+
+  espera.tv_sec = (time_t) segundos;
+  espera.tv_nsec = (long)((segundos - espera.tv_sec) * 1e9);
+
+  // Si una señal interrumpe la espera se continúa con el tiempo restante
+  while(nanosleep(&espera, &espera) == -1 && errno == EINTR);
+}
 
-  t = time(NULL);
-  tim = localtime(&t);
-  strftime(hora, TAM_HORA, "%H:%M:%S", tim);
+void bloquearRegion(){
+  if(modoFibras){
+    bloquearMutexFibra(&mutexRegion);
+  } else {
+    pthread_mutex_lock(&mutexRegion);
+  }
+}
+
+void esperarCondicion(pthread_cond_t* condicion,
+                      CondicionFibra* condicionFibra){
+  if(modoFibras){
+    esperarCondicionFibra(condicionFibra, &mutexRegion);
+  } else {
+    pthread_cond_wait(condicion, &mutexRegion);
+  }
+}
+
+void despertar(pthread_cond_t* condicion, CondicionFibra* condicionFibra,
+               int todos){
+  if(modoFibras){
+    notificarCondicionFibra(condicionFibra, todos ? INT_MAX : 1);
+  } else if(todos){
+    pthread_cond_broadcast(condicion);
+  } else {
+    pthread_cond_signal(condicion);
+  }
 }
 
-void imprimirCabeceraProduc(HiloProductor hilo, char* color){
-  char hora[TAM_HORA];
-  calcularHora(hora);
-  printf("%s{P: %d}(%s) │ ", color, hilo.id, hora);
+int hayHueco(const void* buffer){
+  return numElementos((const Buffer*) buffer) < tamano((const Buffer*) buffer);
 }
 
-void imprimirCabeceraConsum(HiloConsumidor hilo, char* color){
-  char hora[TAM_HORA];
-  calcularHora(hora);
-  printf("%s{C: %d}(%s) │ ", color, hilo.id, hora);
+int hayElementos(const void* buffer){
+  return numElementos((const Buffer*) buffer) > 0 ||
+         bufferCerrado((const Buffer*) buffer);
 }
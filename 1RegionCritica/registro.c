@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include "registro.h"
+
+// Número máximo de mensajes que el registrador saca de los anillos en cada
+// vuelta
+#define REGISTRO_LOTE 4096
+
+// Tamaño del bloque de texto que el registrador escribe de una vez
+#define REGISTRO_TAM_TEXTO 65536
+
+// Espacio reservado en el bloque de texto para un único mensaje
+#define REGISTRO_TAM_LINEA 512
+
+// Tiempo (en microsegundos) que duerme el registrador cuando no encuentra
+// mensajes pendientes
+#define REGISTRO_ESPERA 1000
+
+// Tamaño que ocupa el string de la hora
+#define TAM_HORA 9
+
+// Color por defecto de la salida
+#define REGISTRO_RESET "\E[m"
+
+// Nivel de registro actual. Solo se modifica antes de crear los hilos
+static int nivelRegistro = REGISTRO_DESACTIVADO;
+
+// Salida en la que el registrador escribe los mensajes
+static FILE* salidaRegistro;
+
+// Lista de anillos de los hilos. Los anillos se añaden al principio de la
+// lista y no se eliminan hasta finalizar el registro
+static _Atomic(AnilloRegistro*) anillos = NULL;
+
+// Lista de colas creadas, que solo se recorre para liberarlas
+static _Atomic(ColaRegistro*) colas = NULL;
+
+// Anillo del hilo actual en el que escriben las colas compartidas
+static _Thread_local AnilloRegistro* anilloHilo = NULL;
+
+// Indica al registrador que debe finalizar una vez vacíos los anillos
+static atomic_int terminar;
+
+// Hilo registrador
+static pthread_t registrador;
+
+// Mensajes pendientes de escribir y texto formateado del registrador. Solo son
+// utilizados por el hilo registrador
+static Mensaje pendientes[REGISTRO_LOTE];
+static char texto[REGISTRO_TAM_TEXTO];
+
+/*
+* Función de comparación de mensajes pendientes según su instante para qsort
+*/
+static int compararPendientes(const void* a, const void* b){
+	uint64_t x = ((const Mensaje*) a)->instante;
+	uint64_t y = ((const Mensaje*) b)->instante;
+
+	return (x > y) - (x < y);
+}
+
+/*
+* Función que saca de todos los anillos como mucho REGISTRO_LOTE mensajes y
+* devuelve el número de mensajes sacados
+*/
+static int vaciarAnillos(){
+	AnilloRegistro* anillo;
+	uint64_t inicio, final;
+	int n = 0;
+
+	for(anillo = atomic_load_explicit(&anillos, memory_order_acquire);
+			anillo != NULL; anillo = anillo->siguiente){
+		inicio = atomic_load_explicit(&anillo->inicio, memory_order_relaxed);
+		final = atomic_load_explicit(&anillo->final, memory_order_acquire);
+
+		for(; inicio != final && n < REGISTRO_LOTE; inicio++, n++){
+			pendientes[n] = anillo->mensajes[inicio & (REGISTRO_TAM_COLA - 1)];
+		}
+
+		// Se devuelven al hilo las posiciones de los mensajes ya copiados
+		atomic_store_explicit(&anillo->inicio, inicio, memory_order_release);
+	}
+
+	return n;
+}
+
+/*
+* Función que da formato a los mensajes pendientes indicados y los escribe en
+* la salida en bloques de REGISTRO_TAM_TEXTO bytes
+*/
+static void escribirPendientes(int n){
+	char hora[TAM_HORA];
+	time_t segundos, ultimo = (time_t) -1;
+	struct tm tim;
+	size_t usado = 0;
+	int escrito;
+	int i;
+	Mensaje* m;
+
+	// Los mensajes de los distintos anillos se escriben en el orden en que fueron
+	// registrados
+	qsort(pendientes, n, sizeof(Mensaje), compararPendientes);
+
+	for(i = 0; i < n; i++){
+		m = &pendientes[i];
+
+		// La hora solo se vuelve a calcular cuando cambia el segundo
+		segundos = (time_t)(m->instante / 1000000000ULL);
+		if(segundos != ultimo){
+			localtime_r(&segundos, &tim);
+			strftime(hora, TAM_HORA, "%H:%M:%S", &tim);
+			ultimo = segundos;
+		}
+
+		if(REGISTRO_TAM_TEXTO - usado < REGISTRO_TAM_LINEA){
+			fwrite(texto, 1, usado, salidaRegistro);
+			usado = 0;
+		}
+
+		escrito = snprintf(texto + usado, REGISTRO_TAM_LINEA, "%s{%c: %d}(%s) │ ",
+				m->color, m->tipo, m->id, hora);
+		escrito += snprintf(texto + usado + escrito, REGISTRO_TAM_LINEA - escrito,
+				m->formato, m->args[0], m->args[1], m->args[2], m->args[3]);
+		escrito += snprintf(texto + usado + escrito, REGISTRO_TAM_LINEA - escrito,
+				"%s", REGISTRO_RESET);
+
+		// En caso de que el mensaje no quepa en la línea se trunca
+		if(escrito >= REGISTRO_TAM_LINEA){
+			escrito = REGISTRO_TAM_LINEA - 1;
+		}
+		usado += escrito;
+	}
+
+	fwrite(texto, 1, usado, salidaRegistro);
+	fflush(salidaRegistro);
+}
+
+/*
+* Función asociada al hilo registrador
+*/
+static void* registradorHilo(void* arg){
+	int fin;
+	int n;
+
+	while(1){
+		// Se comprueba si hay que finalizar antes de vaciar los anillos, de forma
+		// que los mensajes registrados antes de la petición siempre se escriben
+		fin = atomic_load_explicit(&terminar, memory_order_acquire);
+
+		n = vaciarAnillos();
+		if(n > 0){
+			escribirPendientes(n);
+		} else if(fin){
+			break;
+		} else {
+			usleep(REGISTRO_ESPERA);
+		}
+	}
+
+	return NULL;
+}
+
+void iniciarRegistro(int nivel, FILE* salida){
+	nivelRegistro = nivel;
+	salidaRegistro = salida;
+	atomic_init(&terminar, 0);
+
+	if(nivelRegistro > REGISTRO_DESACTIVADO){
+		pthread_create(&registrador, NULL, registradorHilo, NULL);
+	}
+}
+
+/*
+* Función que crea un anillo vacío y lo añade a la lista del registrador
+*/
+static AnilloRegistro* crearAnillo(){
+	AnilloRegistro* anillo;
+
+	anillo = (AnilloRegistro*) malloc(sizeof(AnilloRegistro));
+	atomic_init(&anillo->inicio, 0);
+	atomic_init(&anillo->final, 0);
+
+	// Se añade el anillo al principio de la lista. El 'release' asegura que el
+	// registrador vea el anillo inicializado
+	anillo->siguiente = atomic_load_explicit(&anillos, memory_order_relaxed);
+	while(!atomic_compare_exchange_weak_explicit(&anillos, &anillo->siguiente,
+			anillo, memory_order_release, memory_order_relaxed));
+
+	return anillo;
+}
+
+/*
+* Función que crea una cola con el anillo indicado y la añade a la lista de
+* colas que se liberan al finalizar el registro
+*/
+static ColaRegistro* crearCola(char tipo, int id, AnilloRegistro* anillo){
+	ColaRegistro* cola;
+
+	cola = (ColaRegistro*) malloc(sizeof(ColaRegistro));
+	cola->tipo = tipo;
+	cola->id = id;
+	cola->anillo = anillo;
+
+	cola->siguiente = atomic_load_explicit(&colas, memory_order_relaxed);
+	while(!atomic_compare_exchange_weak_explicit(&colas, &cola->siguiente, cola,
+			memory_order_relaxed, memory_order_relaxed));
+
+	return cola;
+}
+
+void finalizarRegistro(){
+	AnilloRegistro* anillo;
+	AnilloRegistro* siguienteAnillo;
+	ColaRegistro* cola;
+	ColaRegistro* siguiente;
+
+	if(nivelRegistro == REGISTRO_DESACTIVADO){
+		return;
+	}
+
+	atomic_store_explicit(&terminar, 1, memory_order_release);
+	pthread_join(registrador, NULL);
+
+	for(anillo = atomic_load(&anillos); anillo != NULL;
+			anillo = siguienteAnillo){
+		siguienteAnillo = anillo->siguiente;
+		free(anillo);
+	}
+	atomic_store(&anillos, NULL);
+
+	for(cola = atomic_load(&colas); cola != NULL; cola = siguiente){
+		siguiente = cola->siguiente;
+		free(cola);
+	}
+	atomic_store(&colas, NULL);
+
+	// El anillo del hilo que finaliza el registro ya no existe. Los del resto
+	// de hilos no importan, ya que deben haber finalizado
+	anilloHilo = NULL;
+
+	nivelRegistro = REGISTRO_DESACTIVADO;
+}
+
+ColaRegistro* crearColaRegistro(char tipo, int id){
+	if(nivelRegistro == REGISTRO_DESACTIVADO){
+		return NULL;
+	}
+
+	return crearCola(tipo, id, crearAnillo());
+}
+
+ColaRegistro* crearColaRegistroCompartida(char tipo, int id){
+	if(nivelRegistro == REGISTRO_DESACTIVADO){
+		return NULL;
+	}
+
+	return crearCola(tipo, id, NULL);
+}
+
+void registrar(ColaRegistro* cola, int nivel, const char* color,
+		const char* formato, int a, int b, int c, int d){
+	AnilloRegistro* anillo;
+	uint64_t final, inicio;
+	struct timespec ts;
+	Mensaje* m;
+
+	if(cola == NULL || nivel > nivelRegistro){
+		return;
+	}
+
+	// Una cola compartida escribe en el anillo del hilo que la ejecuta
+	anillo = cola->anillo;
+	if(anillo == NULL){
+		if(anilloHilo == NULL){
+			anilloHilo = crearAnillo();
+		}
+		anillo = anilloHilo;
+	}
+
+	// El hilo es el único que modifica 'final'. 'inicio' se lee con 'acquire'
+	// para no sobrescribir un mensaje que el registrador aún no ha copiado
+	final = atomic_load_explicit(&anillo->final, memory_order_relaxed);
+	inicio = atomic_load_explicit(&anillo->inicio, memory_order_acquire);
+
+	// Si el anillo está lleno se cede la CPU hasta que el registrador lo vacíe
+	while(final - inicio == REGISTRO_TAM_COLA){
+		sched_yield();
+		inicio = atomic_load_explicit(&anillo->inicio, memory_order_acquire);
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+
+	m = &anillo->mensajes[final & (REGISTRO_TAM_COLA - 1)];
+	m->instante = (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	m->color = color;
+	m->formato = formato;
+	m->args[0] = a;
+	m->args[1] = b;
+	m->args[2] = c;
+	m->args[3] = d;
+	m->tipo = cola->tipo;
+	m->id = cola->id;
+
+	// Se publica el mensaje para el registrador
+	atomic_store_explicit(&anillo->final, final + 1, memory_order_release);
+}
@@ -0,0 +1,400 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <dirent.h>
+#include <pthread.h>
+#include "afinidad.h"
+
+// Directorio con la topología de las CPUs
+#define DIRECTORIO_CPUS "/sys/devices/system/cpu"
+
+/*
+* Posición de una CPU en la topología del sistema. 'hermano' es el número de
+* CPUs del mismo núcleo con menor identificador, y 'rangoNucleo' la posición
+* del núcleo entre los del mismo paquete
+*/
+typedef struct ST_CPU{
+	int cpu;
+	int nodo;
+	int paquete;
+	int nucleo;
+	int hermano;
+	int rangoNucleo;
+} Cpu;
+
+/*
+* Función que lee el entero del fichero de topología indicado de la CPU
+* indicada, devolviendo -1 si no existe
+*/
+static int leerTopologia(int cpu, const char* fichero){
+	char ruta[128];
+	FILE* f;
+	int valor;
+
+	snprintf(ruta, sizeof(ruta), DIRECTORIO_CPUS "/cpu%d/topology/%s", cpu,
+			fichero);
+	f = fopen(ruta, "r");
+	if(f == NULL){
+		return -1;
+	}
+	if(fscanf(f, "%d", &valor) != 1){
+		valor = -1;
+	}
+	fclose(f);
+
+	return valor;
+}
+
+/*
+* Función que devuelve el nodo NUMA de la CPU indicada, que aparece como un
+* directorio 'nodeN' dentro del de la CPU, o -1 si no se conoce
+*/
+static int leerNodo(int cpu){
+	char ruta[128];
+	DIR* directorio;
+	struct dirent* entrada;
+	int nodo = -1;
+
+	snprintf(ruta, sizeof(ruta), DIRECTORIO_CPUS "/cpu%d", cpu);
+	directorio = opendir(ruta);
+	if(directorio == NULL){
+		return -1;
+	}
+	while((entrada = readdir(directorio)) != NULL){
+		if(sscanf(entrada->d_name, "node%d", &nodo) == 1){
+			break;
+		}
+		nodo = -1;
+	}
+	closedir(directorio);
+
+	return nodo;
+}
+
+/*
+* Función que interpreta una lista de CPUs ("0,2,4-7") y guarda las CPUs en
+* 'cpus' si no es NULL. Devuelve el número de CPUs, o -1 si la lista no es
+* válida o tiene más de 'maximo' CPUs
+*/
+static int leerLista(const char* texto, int* cpus, int maximo){
+	const char* p = texto;
+	char* fin;
+	long primera, ultima, cpu;
+	int num = 0;
+
+	while(1){
+		errno = 0;
+		primera = strtol(p, &fin, 10);
+		if(fin == p || errno != 0 || primera < 0 || primera >= CPU_SETSIZE){
+			return -1;
+		}
+		ultima = primera;
+		p = fin;
+
+		if(*p == '-'){
+			p++;
+			ultima = strtol(p, &fin, 10);
+			if(fin == p || errno != 0 || ultima < primera ||
+					ultima >= CPU_SETSIZE){
+				return -1;
+			}
+			p = fin;
+		}
+
+		for(cpu = primera; cpu <= ultima; cpu++){
+			if(num == maximo){
+				return -1;
+			}
+			if(cpus != NULL){
+				cpus[num] = (int) cpu;
+			}
+			num++;
+		}
+
+		if(*p == '\0'){
+			return num;
+		}
+		if(*p != ','){
+			return -1;
+		}
+		p++;
+	}
+}
+
+// Orden compacto: nodo, paquete, núcleo y CPU
+static int compararCompacto(const void* a, const void* b){
+	const Cpu* x = (const Cpu*) a;
+	const Cpu* y = (const Cpu*) b;
+
+	if(x->nodo != y->nodo) return x->nodo - y->nodo;
+	if(x->paquete != y->paquete) return x->paquete - y->paquete;
+	if(x->nucleo != y->nucleo) return x->nucleo - y->nucleo;
+	return x->cpu - y->cpu;
+}
+
+// Orden disperso: primero un hilo de cada núcleo, alternando nodos y paquetes
+static int compararDisperso(const void* a, const void* b){
+	const Cpu* x = (const Cpu*) a;
+	const Cpu* y = (const Cpu*) b;
+
+	if(x->hermano != y->hermano) return x->hermano - y->hermano;
+	if(x->rangoNucleo != y->rangoNucleo){
+		return x->rangoNucleo - y->rangoNucleo;
+	}
+	if(x->nodo != y->nodo) return x->nodo - y->nodo;
+	if(x->paquete != y->paquete) return x->paquete - y->paquete;
+	return x->cpu - y->cpu;
+}
+
+/*
+* Función que devuelve la política del texto indicado, o -1 si no es ninguno
+* de los nombres
+*/
+static int leerPolitica(const char* texto){
+	if(strcmp(texto, "ninguna") == 0){
+		return AFINIDAD_NINGUNA;
+	} else if(strcmp(texto, "compacta") == 0){
+		return AFINIDAD_COMPACTA;
+	} else if(strcmp(texto, "dispersa") == 0){
+		return AFINIDAD_DISPERSA;
+	} else if(strcmp(texto, "parejas") == 0){
+		return AFINIDAD_PAREJAS;
+	}
+	return -1;
+}
+
+int comprobarAfinidad(const char* texto){
+	if(leerPolitica(texto) < 0 && leerLista(texto, NULL, CPU_SETSIZE) < 0){
+		fprintf(stderr, "[!] La afinidad debe ser 'ninguna', 'compacta', "
+				"'dispersa', 'parejas' o una lista de CPUs como '0,2,4-7' (se ha "
+				"indicado '%s')\n", texto);
+		return -1;
+	}
+	return 0;
+}
+
+int crearAfinidad(Afinidad* afinidad, const char* texto, int numProductores){
+	cpu_set_t disponibles;
+	Cpu* cpus;
+	int num = 0;
+	int i, j;
+
+	afinidad->orden = NULL;
+	afinidad->nodos = NULL;
+	afinidad->numCpus = 0;
+	afinidad->numProductores = numProductores;
+
+	if(comprobarAfinidad(texto) != 0){
+		return -1;
+	}
+	afinidad->politica = leerPolitica(texto);
+	if(afinidad->politica < 0){
+		afinidad->politica = AFINIDAD_LISTA;
+	}
+	if(afinidad->politica == AFINIDAD_NINGUNA){
+		return 0;
+	}
+
+	if(sched_getaffinity(0, sizeof(disponibles), &disponibles) != 0){
+		fprintf(stderr, "[!] No se pueden obtener las CPUs disponibles: %s\n",
+				strerror(errno));
+		return -1;
+	}
+
+	afinidad->orden = (int*) malloc(sizeof(int) * CPU_SETSIZE);
+	afinidad->nodos = (int*) malloc(sizeof(int) * CPU_SETSIZE);
+
+	if(afinidad->politica == AFINIDAD_LISTA){
+		// Las CPUs se utilizan en el orden indicado, pudiendo repetirse
+		num = leerLista(texto, afinidad->orden, CPU_SETSIZE);
+		for(i = 0; i < num; i++){
+			if(!CPU_ISSET(afinidad->orden[i], &disponibles)){
+				fprintf(stderr, "[!] La CPU %d no está disponible para el "
+						"proceso\n", afinidad->orden[i]);
+				destruirAfinidad(afinidad);
+				return -1;
+			}
+			afinidad->nodos[i] = leerNodo(afinidad->orden[i]);
+		}
+		afinidad->numCpus = num;
+		return 0;
+	}
+
+	// Se lee la topología de todas las CPUs disponibles
+	cpus = (Cpu*) malloc(sizeof(Cpu) * CPU_SETSIZE);
+	for(i = 0; i < CPU_SETSIZE; i++){
+		if(CPU_ISSET(i, &disponibles)){
+			cpus[num].cpu = i;
+			cpus[num].nodo = leerNodo(i);
+			cpus[num].paquete = leerTopologia(i, "physical_package_id");
+			cpus[num].nucleo = leerTopologia(i, "core_id");
+			num++;
+		}
+	}
+
+	// Si no se conoce el núcleo cada CPU se considera un núcleo distinto
+	for(i = 0; i < num; i++){
+		if(cpus[i].nucleo < 0){
+			cpus[i].nucleo = cpus[i].cpu;
+		}
+	}
+
+	// Las CPUs están ordenadas por identificador, por lo que el primer hermano
+	// de cada núcleo es el de menor identificador
+	for(i = 0; i < num; i++){
+		cpus[i].hermano = 0;
+		for(j = 0; j < i; j++){
+			if(cpus[j].paquete == cpus[i].paquete &&
+					cpus[j].nucleo == cpus[i].nucleo){
+				cpus[i].hermano++;
+			}
+		}
+	}
+
+	// La posición de cada núcleo se obtiene contando los primeros hermanos de
+	// los núcleos anteriores del mismo paquete
+	for(i = 0; i < num; i++){
+		cpus[i].rangoNucleo = 0;
+		for(j = 0; j < num; j++){
+			if(cpus[j].hermano == 0 && cpus[j].paquete == cpus[i].paquete &&
+					cpus[j].nucleo < cpus[i].nucleo){
+				cpus[i].rangoNucleo++;
+			}
+		}
+	}
+
+	qsort(cpus, num, sizeof(Cpu), afinidad->politica == AFINIDAD_DISPERSA ?
+			compararDisperso : compararCompacto);
+
+	for(i = 0; i < num; i++){
+		afinidad->orden[i] = cpus[i].cpu;
+		afinidad->nodos[i] = cpus[i].nodo;
+	}
+	afinidad->numCpus = num;
+
+	free(cpus);
+	return 0;
+}
+
+void destruirAfinidad(Afinidad* afinidad){
+	free(afinidad->orden);
+	free(afinidad->nodos);
+	afinidad->orden = NULL;
+	afinidad->nodos = NULL;
+	afinidad->numCpus = 0;
+}
+
+int cpuProductor(const Afinidad* afinidad, int id){
+	if(afinidad->politica == AFINIDAD_NINGUNA || afinidad->numCpus == 0){
+		return -1;
+	}
+	if(afinidad->politica == AFINIDAD_PAREJAS){
+		return afinidad->orden[(2 * id) % afinidad->numCpus];
+	}
+	return afinidad->orden[id % afinidad->numCpus];
+}
+
+int cpuConsumidor(const Afinidad* afinidad, int id){
+	if(afinidad->politica == AFINIDAD_NINGUNA || afinidad->numCpus == 0){
+		return -1;
+	}
+	if(afinidad->politica == AFINIDAD_PAREJAS){
+		return afinidad->orden[(2 * id + 1) % afinidad->numCpus];
+	}
+	return afinidad->orden[(afinidad->numProductores + id) %
+			afinidad->numCpus];
+}
+
+int fijarAfinidad(pthread_attr_t* atributos, int cpu){
+	cpu_set_t conjunto;
+
+	if(cpu < 0){
+		return 0;
+	}
+
+	CPU_ZERO(&conjunto);
+	CPU_SET(cpu, &conjunto);
+
+	return pthread_attr_setaffinity_np(atributos, sizeof(conjunto),
+			&conjunto) == 0 ? 0 : -1;
+}
+
+void ubicarMemoria(const Afinidad* afinidad, void* memoria, size_t tam,
+		int cpu){
+	cpu_set_t anterior, disponibles, nodo;
+	int nodoCpu;
+	int i;
+
+	if(afinidad->politica == AFINIDAD_NINGUNA || cpu < 0 || memoria == NULL){
+		return;
+	}
+
+	// Se utilizan todas las CPUs disponibles del nodo, o solo la indicada si
+	// no se conoce el nodo
+	CPU_ZERO(&nodo);
+	CPU_SET(cpu, &nodo);
+	nodoCpu = leerNodo(cpu);
+	if(nodoCpu >= 0 &&
+			sched_getaffinity(0, sizeof(disponibles), &disponibles) == 0){
+		for(i = 0; i < CPU_SETSIZE; i++){
+			if(CPU_ISSET(i, &disponibles) && leerNodo(i) == nodoCpu){
+				CPU_SET(i, &nodo);
+			}
+		}
+	}
+
+	if(pthread_getaffinity_np(pthread_self(), sizeof(anterior), &anterior) !=
+			0){
+		return;
+	}
+
+	// El núcleo reserva cada página en el nodo de la CPU que la escribe por
+	// primera vez
+	if(pthread_setaffinity_np(pthread_self(), sizeof(nodo), &nodo) == 0){
+		memset(memoria, 0, tam);
+		pthread_setaffinity_np(pthread_self(), sizeof(anterior), &anterior);
+	}
+}
+
+/*
+* Función que devuelve el nodo de una CPU del orden de la afinidad
+*/
+static int nodoAsignado(const Afinidad* afinidad, int cpu){
+	int i;
+
+	for(i = 0; i < afinidad->numCpus; i++){
+		if(afinidad->orden[i] == cpu){
+			return afinidad->nodos[i];
+		}
+	}
+	return -1;
+}
+
+void imprimirAfinidad(const Afinidad* afinidad, int numProductores,
+		int numConsumidores, FILE* salida){
+	static const char* nombres[] = {"ninguna", "compacta", "dispersa",
+			"parejas", "lista"};
+	int cpu;
+	int i;
+
+	fprintf(salida, "[i] Afinidad %s", nombres[afinidad->politica]);
+	if(afinidad->politica == AFINIDAD_NINGUNA){
+		fprintf(salida, "\n");
+		return;
+	}
+
+	fprintf(salida, ". Productores (CPU/nodo):");
+	for(i = 0; i < numProductores; i++){
+		cpu = cpuProductor(afinidad, i);
+		fprintf(salida, " %d/%d", cpu, nodoAsignado(afinidad, cpu));
+	}
+	fprintf(salida, ". Consumidores (CPU/nodo):");
+	for(i = 0; i < numConsumidores; i++){
+		cpu = cpuConsumidor(afinidad, i);
+		fprintf(salida, " %d/%d", cpu, nodoAsignado(afinidad, cpu));
+	}
+	fprintf(salida, "\n");
+}
@@ -0,0 +1,161 @@
+#ifndef AFINIDAD_H
+#define AFINIDAD_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Afinidad decide en qué CPU se ejecuta cada productor y cada consumidor,
+* de forma que la ubicación de los hilos sea reproducible entre ejecuciones en
+* lugar de depender del planificador. Las CPUs disponibles son las del proceso
+* (las que permita 'taskset' o el cgroup), y su topología (nodo NUMA, paquete,
+* núcleo e hilos hermanos del mismo núcleo) se lee de /sys.
+*
+* Las políticas de ubicación son:
+*		- ninguna: los hilos se crean sin afinidad
+*		- compacta: los hilos ocupan las CPUs en orden de nodo, paquete y núcleo,
+*								llenando cada núcleo (incluidos sus hermanos) antes del
+*								siguiente. Primero los productores y después los
+*								consumidores
+*		- dispersa: los hilos se reparten alternando paquetes y núcleos, y los
+*								hermanos de un núcleo solo se usan cuando todos los
+*								núcleos tienen ya un hilo
+*		- parejas: el productor i y el consumidor i se ubican en CPUs consecutivas
+*								del orden compacto, que son hermanas del mismo núcleo
+*								cuando el sistema las tiene
+*		- una lista de CPUs ("0,2,4-7"): los productores y después los
+*								consumidores ocupan las CPUs de la lista en orden
+*
+* Cuando hay más hilos que CPUs la asignación vuelve a empezar por la primera.
+*
+* La memoria de los buffers se ubica en el nodo NUMA de los consumidores
+* mediante la política de primer acceso del núcleo: el hilo que la reserva se
+* ejecuta temporalmente en las CPUs de ese nodo mientras la escribe por primera
+* vez, de forma que no es necesaria ninguna biblioteca de NUMA.
+*/
+
+// Políticas de ubicación
+#define AFINIDAD_NINGUNA 0
+#define AFINIDAD_COMPACTA 1
+#define AFINIDAD_DISPERSA 2
+#define AFINIDAD_PAREJAS 3
+#define AFINIDAD_LISTA 4
+
+// Longitud máxima del texto de una política
+#define MAX_TEXTO_AFINIDAD 128
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_AFINIDAD
+* Campos:
+*		- politica: política de ubicación
+*		- orden: CPUs en el orden en el que se asignan a los hilos
+*		- nodos: nodo NUMA de cada CPU de 'orden' (-1 si no se conoce)
+*		- numCpus: número de CPUs de 'orden'
+*		- numProductores: número de productores, que ocupan las primeras
+*							posiciones del orden en las políticas compacta, dispersa y
+*							de lista
+*/
+typedef struct ST_AFINIDAD{
+	int politica;
+	int* orden;
+	int* nodos;
+	int numCpus;
+	int numProductores;
+} Afinidad;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: comprobarAfinidad
+* Tipo: consulta
+* Función que comprueba que el texto indicado sea una política de ubicación
+* válida ("ninguna", "compacta", "dispersa", "parejas" o una lista de CPUs),
+* sin consultar las CPUs del sistema.
+*
+* Precondición : ninguna
+* Postcondición: se devuelve 0 si es válida y -1 en caso contrario, tras
+*								 escribir el motivo por la salida de error
+*/
+int comprobarAfinidad(const char* texto);
+
+/*
+* Nombre: crearAfinidad
+* Tipo: constructor
+* Función que calcula el orden de las CPUs para la política indicada y el
+* número de productores indicado. Las CPUs de una lista deben estar entre las
+* disponibles para el proceso.
+*
+* Precondición : ninguna
+* Postcondición: se devuelve 0 y la afinidad puede ser utilizada, o -1 tras
+*								 escribir el motivo por la salida de error
+*/
+int crearAfinidad(Afinidad* afinidad, const char* texto, int numProductores);
+
+/*
+* Nombre: destruirAfinidad
+* Tipo: destructor
+* Función que libera la memoria de la afinidad.
+*
+* Precondición : la afinidad debe haber sido creada con 'crearAfinidad'
+* Postcondición: la afinidad no puede volver a utilizarse
+*/
+void destruirAfinidad(Afinidad* afinidad);
+
+/*
+* Nombre: cpuProductor / cpuConsumidor
+* Tipo: consulta
+* Funciones que devuelven la CPU asignada al productor o al consumidor con el
+* identificador indicado.
+*
+* Precondición : la afinidad debe haber sido creada con 'crearAfinidad'
+* Postcondición: se devuelve la CPU, o -1 si la política es 'ninguna'
+*/
+int cpuProductor(const Afinidad* afinidad, int id);
+int cpuConsumidor(const Afinidad* afinidad, int id);
+
+/*
+* Nombre: fijarAfinidad
+* Tipo: modificador
+* Función que configura los atributos indicados para que el hilo que se cree
+* con ellos se ejecute únicamente en la CPU indicada. Si la CPU es -1 los
+* atributos no se modifican.
+*
+* Precondición : los atributos deben haber sido iniciados
+* Postcondición: se devuelve 0 si se han podido configurar y -1 en caso
+*								 contrario
+*/
+int fijarAfinidad(pthread_attr_t* atributos, int cpu);
+
+/*
+* Nombre: ubicarMemoria
+* Tipo: modificador
+* Función que escribe a cero la memoria indicada desde las CPUs del nodo NUMA
+* de la CPU indicada, de forma que sus páginas se reserven en ese nodo. Solo
+* tiene efecto sobre páginas que aún no se hayan escrito, y no hace nada si la
+* CPU es -1.
+*
+* Precondición : la afinidad debe haber sido creada con 'crearAfinidad'
+* Postcondición: la memoria está a cero y, si el sistema lo permite, ubicada
+*								 en el nodo de la CPU
+*/
+void ubicarMemoria(const Afinidad* afinidad, void* memoria, size_t tam,
+		int cpu);
+
+/*
+* Nombre: imprimirAfinidad
+* Tipo: consulta
+* Función que escribe la política y la CPU y el nodo de cada hilo, para que la
+* ubicación quede registrada junto con los resultados.
+*
+* Precondición : la afinidad debe haber sido creada con 'crearAfinidad'
+* Postcondición: se ha escrito la ubicación en el fichero indicado
+*/
+void imprimirAfinidad(const Afinidad* afinidad, int numProductores,
+		int numConsumidores, FILE* salida);
+
+#endif
@@ -3,10 +3,35 @@
 #include <sys/mman.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+/*
+* Función que devuelve la máscara a utilizar para un buffer del tamaño
+* indicado: 'tam - 1' si el tamaño es potencia de dos y 0 en otro caso
+*/
+static unsigned int calcularMascara(unsigned int tam){
+	if(tam > 0 && (tam & (tam - 1)) == 0){
+		return tam - 1;
+	}
+	return 0;
+}
+
+/*
+* Función que retorna la posición del array correspondiente al contador
+* indicado. Con tamaños potencia de dos se evita la división del módulo
+*/
+static inline unsigned int posicion(const Buffer* buffer, uint64_t contador){
+	if(buffer->mascara != 0){
+		return (unsigned int)(contador & buffer->mascara);
+	}
+	return (unsigned int)(contador % (unsigned int)buffer->tam);
+}
 
 Buffer crearBuffer(unsigned int tam){
 
@@ -16,20 +41,24 @@ Buffer crearBuffer(unsigned int tam){
 	// Se asigna al buffer el tamaño correspondiente
 	buf.tam = tam;
 
+	buf.mascara = calcularMascara(tam);
+
 	// Se reserva memoria para los componentes del buffer
 	buf.valores = (int*) malloc(sizeof(int) * tam);
 
-	// Se inicializa el número de elementos a 0
-	buf.numElementos = 0;
-
 	// El número de producciones inicial será 0
 	buf.producciones = 0;
 
-	// Se asignan los punteros final y inicio a la última posición del buffer,
-	// ya que "inicio" es la posición anterior al primer elemento de la cola, por
-	// lo tanto, cuando se añada un elemento está posición será el 0
-	buf.final = buf.tam-1;
-	buf.inicio = buf.tam-1;
+	// Los contadores empiezan en 0, por lo que el buffer está vacío y la primera
+	// inserción se realizará en la posición 0
+	atomic_init(&buf.final, 0);
+	atomic_init(&buf.inicio, 0);
+	buf.inicioCache = 0;
+	buf.finalCache = 0;
+
+	// El buffer empieza abierto y sin productores registrados
+	atomic_init(&buf.productoresActivos, 0);
+	atomic_init(&buf.cerrado, 0);
 
 	// Se retorna el buffer al usuario
 	return buf;
@@ -42,42 +71,79 @@ void destruirBuffer(Buffer* buf){
 			free(buf->valores);
 			buf->valores = NULL;
 
-			// Se ponen el resto de variables a -1
-			buf->inicio = -1;
-			buf->final = -1;
+			// Se ponen los contadores a 0 y el resto de variables a -1
+			buf->inicio = 0;
+			buf->final = 0;
+			buf->inicioCache = 0;
+			buf->finalCache = 0;
 			buf->producciones = -1;
-			buf->numElementos = -1;
 			buf->tam = -1;
+			buf->mascara = 0;
+	}
+}
+
+/*
+* Función que devuelve el número de posiciones libres según los productores.
+* Solo se lee la línea de caché de los consumidores si la copia de 'inicio'
+* indica que hay menos de 'necesarias' posiciones libres
+*/
+static inline int libresProductor(Buffer* buffer, int necesarias){
+	uint64_t final;
+	int libres;
+
+	// Solo los productores modifican 'final', por lo que se puede leer sin
+	// sincronización
+	final = atomic_load_explicit(&buffer->final, memory_order_relaxed);
+	libres = buffer->tam - (int)(final - buffer->inicioCache);
+
+	if(libres < necesarias){
+		// El 'acquire' asegura que las posiciones liberadas ya han sido leídas
+		// por los consumidores antes de sobrescribirlas
+		buffer->inicioCache = atomic_load_explicit(&buffer->inicio,
+				memory_order_acquire);
+		libres = buffer->tam - (int)(final - buffer->inicioCache);
 	}
+
+	return libres;
 }
 
 /*
-* Función que retorna la posición posterior de la cola circular del parámetro
-* indicado
+* Función que devuelve el número de elementos según los consumidores. Solo se
+* lee la línea de caché de los productores si la copia de 'final' indica que
+* hay menos de 'necesarios' elementos
 */
-int siguiente(Buffer buffer, int posicion){
+static inline int elementosConsumidor(Buffer* buffer, int necesarios){
+	uint64_t inicio;
+	int elementos;
+
+	inicio = atomic_load_explicit(&buffer->inicio, memory_order_relaxed);
+	elementos = (int)(buffer->finalCache - inicio);
+
+	if(elementos < necesarios){
+		// El 'acquire' asegura que los valores insertados son visibles
+		buffer->finalCache = atomic_load_explicit(&buffer->final,
+				memory_order_acquire);
+		elementos = (int)(buffer->finalCache - inicio);
+	}
 
-	// La posición se obtiene como el módulo entre la siguiente posición y el
-	// tamaño del buffer (cola circular)
-	return ((posicion + 1) % (buffer.tam));
+	return elementos;
 }
 
 /*
 * Función que devuelve 1 si la Cola está llena y un 0 en caso contrario
 */
-int colaLlena(Buffer buffer){
+int colaLlena(Buffer* buffer){
 
-	// La condición de ColaLlena es que el número de elementos del buffer sea
-	// igual al tamaño del buffer
-	return(buffer.numElementos == buffer.tam);
+	// La condición de ColaLlena es que no quede ninguna posición libre
+	return(libresProductor(buffer, 1) == 0);
 }
 
 /*
 * Función que devuelve 1 si la Cola está vacía y un 0 en caso contrario
 */
-int colaVacia(Buffer buffer){
+int colaVacia(Buffer* buffer){
 	// La condición de ColaVacía es que el número de elementos del buffer sea 0
-	return(buffer.numElementos == 0);
+	return(elementosConsumidor(buffer, 1) == 0);
 }
 
 void insertarBuffer(Buffer* buffer, int valor){
@@ -86,21 +152,17 @@ void insertarBuffer(Buffer* buffer, int valor){
 }
 
 void insertarBufferTime(Buffer* buffer, int valor, int tiempo){
-	int posicionInsercion;
+	uint64_t final;
 
 	if(buffer != NULL && buffer->valores != NULL){
-		if(!colaLlena(*buffer)){
-			// Se obtiene la posición de la siguiente inserción
-			posicionInsercion = siguiente(*buffer, buffer->final);
+		if(!colaLlena(buffer)){
+			final = atomic_load_explicit(&buffer->final, memory_order_relaxed);
 
-			// Se añade el valor en la posición correspondiente
-			buffer->valores[posicionInsercion] = valor;
+			// Se añade el valor en la posición correspondiente al contador final
+			buffer->valores[posicion(buffer, final)] = valor;
 
-			// Se actualiza la variable final a la nueva posición
-			buffer->final = posicionInsercion;
-
-			// Se incrementa el número de elementos
-			buffer->numElementos += 1;
+			// Se incrementa el contador de inserciones, publicando el valor
+			atomic_store_explicit(&buffer->final, final + 1, memory_order_release);
 
 			if(tiempo > 0)
 				sleep(tiempo);
@@ -116,24 +178,26 @@ int sacarBuffer(Buffer* buffer){
 
 int sacarBufferTime(Buffer* buffer, int tiempo){
 	int valor = -1;
+	unsigned int posicionInicio;
+	uint64_t inicio;
 
 	if(buffer != NULL && buffer->valores != NULL){
-		if(!colaVacia(*buffer)){
-			// Se actualiza la posición del principio (inicio apunta a la posición
-			// anterior del primer elemento)
+		if(!colaVacia(buffer)){
+			inicio = atomic_load_explicit(&buffer->inicio, memory_order_relaxed);
 
-			buffer->inicio = siguiente(*buffer, buffer->inicio);
+			// Se obtiene la posición del primer elemento de la cola
+			posicionInicio = posicion(buffer, inicio);
 
-			// Se obtiene el valor de la posición nueva
-			valor = buffer->valores[buffer->inicio];
+			// Se obtiene el valor de esa posición
+			valor = buffer->valores[posicionInicio];
 
 			// Se actualiza el valor a -1
-			buffer->valores[buffer->inicio] = -1;
+			buffer->valores[posicionInicio] = -1;
 
-			// Se decrementa el número de elementos
-			buffer->numElementos -= 1;
+			// Se incrementa el contador de extracciones, liberando la posición
+			atomic_store_explicit(&buffer->inicio, inicio + 1, memory_order_release);
 
-			if(tiempo > 1)
+			if(tiempo > 0)
 				sleep(tiempo);
 		}
 	}
@@ -142,40 +206,110 @@ int sacarBufferTime(Buffer* buffer, int tiempo){
 	return valor;
 }
 
-int tamano(Buffer buffer){
-	return buffer.tam;
+int insertarBufferN(Buffer* buffer, const int* valores, int n){
+	unsigned int posicionFinal, hastaFinal;
+	int libres;
+	uint64_t final;
+
+	if(buffer == NULL || buffer->valores == NULL || n <= 0){
+		return 0;
+	}
+
+	// Se insertan como mucho tantos valores como posiciones libres haya
+	libres = libresProductor(buffer, n);
+	if(n > libres){
+		n = libres;
+	}
+
+	// Se copia primero el bloque que cabe hasta el final del array y, si quedan
+	// valores, el resto desde la posición 0
+	final = atomic_load_explicit(&buffer->final, memory_order_relaxed);
+	posicionFinal = posicion(buffer, final);
+	hastaFinal = buffer->tam - posicionFinal;
+
+	if(n <= hastaFinal){
+		memcpy(buffer->valores + posicionFinal, valores, sizeof(int) * n);
+	} else {
+		memcpy(buffer->valores + posicionFinal, valores,
+				sizeof(int) * hastaFinal);
+		memcpy(buffer->valores, valores + hastaFinal,
+				sizeof(int) * (n - hastaFinal));
+	}
+
+	// Se incrementa el contador de inserciones, publicando los valores
+	atomic_store_explicit(&buffer->final, final + n, memory_order_release);
+
+	return n;
+}
+
+int sacarBufferN(Buffer* buffer, int* valores, int n){
+	unsigned int posicionInicio, hastaFinal;
+	int elementos;
+	uint64_t inicio;
+
+	if(buffer == NULL || buffer->valores == NULL || n <= 0){
+		return 0;
+	}
+
+	// Se sacan como mucho tantos valores como elementos haya
+	elementos = elementosConsumidor(buffer, n);
+	if(n > elementos){
+		n = elementos;
+	}
+
+	inicio = atomic_load_explicit(&buffer->inicio, memory_order_relaxed);
+	posicionInicio = posicion(buffer, inicio);
+	hastaFinal = buffer->tam - posicionInicio;
+
+	if(n <= hastaFinal){
+		memcpy(valores, buffer->valores + posicionInicio, sizeof(int) * n);
+	} else {
+		memcpy(valores, buffer->valores + posicionInicio,
+				sizeof(int) * hastaFinal);
+		memcpy(valores + hastaFinal, buffer->valores,
+				sizeof(int) * (n - hastaFinal));
+	}
+
+	// Se incrementa el contador de extracciones, liberando las posiciones
+	atomic_store_explicit(&buffer->inicio, inicio + n, memory_order_release);
+
+	return n;
+}
+
+int tamano(const Buffer* buffer){
+	return buffer->tam;
 }
 
-int* valores(Buffer buffer){
-	return buffer.valores;
+int* valores(const Buffer* buffer){
+	return buffer->valores;
 }
 
-int inicio(Buffer buffer){
+int inicio(const Buffer* buffer){
 	int count = -1;
 
 	// Se comprueba que el Buffer este inicializado
-	if(buffer.valores != NULL){
-		count = buffer.inicio;
+	if(buffer->valores != NULL){
+		count = posicion(buffer, atomic_load(&buffer->inicio));
 	}
 	return count;
 }
 
-int final(Buffer buffer){
+int final(const Buffer* buffer){
 	int count = -1;
 
 	// Se comprueba que el Buffer este inicializado
-	if(buffer.valores != NULL){
-		count = buffer.final;
+	if(buffer->valores != NULL){
+		count = posicion(buffer, atomic_load(&buffer->final));
 	}
 	return count;
 }
 
-int obtenerProducciones(Buffer buffer){
+int obtenerProducciones(const Buffer* buffer){
 	int producciones = -1;
 
 	// Se comprueba que el Buffer esté inicializado
-	if(buffer.valores != NULL){
-		producciones = buffer.producciones;
+	if(buffer->valores != NULL){
+		producciones = buffer->producciones;
 	}
 	return producciones;
 }
@@ -191,55 +325,87 @@ void incrementarProducciones(Buffer* buffer, int incremento){
 	}
 }
 
-int numElementos(Buffer buffer){
-	return buffer.numElementos;
+void registrarProductores(Buffer* buffer, int numProductores){
+	// Los productores se registran antes de empezar, por lo que el incremento
+	// no necesita ordenar ningún otro acceso
+	atomic_fetch_add_explicit(&buffer->productoresActivos, numProductores,
+			memory_order_relaxed);
 }
 
-void imprimirBuffer(Buffer buffer){
+int terminarProductor(Buffer* buffer){
+	// El decremento libera las inserciones del productor y adquiere las de los
+	// que terminaron antes, de forma que el cierre las publica todas
+	if(atomic_fetch_sub_explicit(&buffer->productoresActivos, 1,
+			memory_order_acq_rel) != 1){
+		return 0;
+	}
+
+	cerrarBuffer(buffer);
+	return 1;
+}
+
+void cerrarBuffer(Buffer* buffer){
+	atomic_store_explicit(&buffer->cerrado, 1, memory_order_release);
+}
+
+int bufferCerrado(const Buffer* buffer){
+	return atomic_load_explicit(&buffer->cerrado, memory_order_acquire);
+}
+
+int bufferAgotado(Buffer* buffer){
+	// El cierre se consulta antes que la cola: si se comprobara después, un
+	// productor podría insertar y cerrar entre ambas consultas
+	return bufferCerrado(buffer) && colaVacia(buffer);
+}
+
+int numElementos(const Buffer* buffer){
+	uint64_t inicio, final;
+
+	inicio = atomic_load_explicit(&buffer->inicio, memory_order_acquire);
+	final = atomic_load_explicit(&buffer->final, memory_order_acquire);
+
+	return (int)(final - inicio);
+}
+
+void imprimirBuffer(const Buffer* buffer){
 	int inicio, final;
+	int elementos;
 	int condicion;
 	int i;
 
-	inicio = buffer.inicio;
-	final = buffer.final;
+	inicio = posicion(buffer, atomic_load(&buffer->inicio));
+	final = posicion(buffer, atomic_load(&buffer->final));
+	elementos = numElementos(buffer);
 
-	for(i = 0; i < buffer.tam; i++){
+	for(i = 0; i < buffer->tam; i++){
 		if(i == 0){
 			printf("┌─");
-		} else if(i == buffer.tam - 1){
+		} else if(i == buffer->tam - 1){
 			printf("┬─┐\n");
 		} else {
 			printf("┬─");
 		}
 	}
-	for(i = 0; i < buffer.tam; i++){
-		if(inicio < final){
-			condicion = i > inicio && i <= final;
-		} else if (inicio > final){
-			condicion = i > inicio || i <= final;
-		} else {
-			if(buffer.numElementos == buffer.tam){
-				 condicion = 1;
-			} else {
-				 condicion = 0;
-			}
-		}
-		if(i == buffer.tam - 1){
+	for(i = 0; i < buffer->tam; i++){
+		// La posición está ocupada si su distancia al primer elemento de la cola
+		// es menor que el número de elementos
+		condicion = (i - inicio + buffer->tam) % buffer->tam < elementos;
+		if(i == buffer->tam - 1){
 			if(condicion){
-				if(buffer.valores[i] == -1){
+				if(buffer->valores[i] == -1){
 					printf("│▓│\n");
 				} else {
-					printf("│%d│\n", buffer.valores[i]);
+					printf("│%d│\n", buffer->valores[i]);
 				}
 			} else {
 				printf("│ │\n");
 			}
 		} else {
 			if(condicion){
-				if(buffer.valores[i] == -1){
+				if(buffer->valores[i] == -1){
 					printf("│▓");
 				} else {
-					printf("│%d", buffer.valores[i]);
+					printf("│%d", buffer->valores[i]);
 				}
 			} else{
 				printf("│ ");
@@ -247,15 +413,1282 @@ void imprimirBuffer(Buffer buffer){
 		}
 	}
 
-	for(i = 0; i < buffer.tam; i++){
+	for(i = 0; i < buffer->tam; i++){
 		if(i == 0){
 			printf("├─");
-		} else if(i == buffer.tam - 1){
+		} else if(i == buffer->tam - 1){
 			printf("┴─┘\n");
 		} else {
 			printf("┴─");
 		}
 	}
 
-	printf("└─> Tam: %d | Inicio: %d | Final: %d \n", buffer.tam, inicio, final);
+	printf("└─> Tam: %d | Inicio: %d | Final: %d \n", buffer->tam, inicio, final);
+}
+
+BufferSPSC crearBufferSPSC(unsigned int tam){
+	BufferSPSC buf;
+
+	buf.tam = tam;
+	buf.mascara = calcularMascara(tam);
+	buf.valores = (int*) malloc(sizeof(int) * tam);
+
+	// Ambos contadores empiezan en 0: el buffer está vacío cuando son iguales y
+	// lleno cuando se diferencian en 'tam'
+	atomic_init(&buf.inicio, 0);
+	atomic_init(&buf.final, 0);
+	buf.inicioCache = 0;
+	buf.finalCache = 0;
+
+	return buf;
+}
+
+void destruirBufferSPSC(BufferSPSC* buf){
+	if(buf != NULL && buf->valores != NULL){
+		free(buf->valores);
+		buf->valores = NULL;
+		buf->tam = 0;
+		buf->mascara = 0;
+	}
+}
+
+int insertarBufferSPSC(BufferSPSC* buffer, int valor){
+	uint64_t final, inicio;
+
+	// El productor es el único que modifica 'final', por lo que puede leerlo sin
+	// sincronización. Solo si según la copia de 'inicio' la cola está llena se
+	// lee el contador real, con 'acquire' para que la posición que libera el
+	// consumidor no se reutilice antes de que este la haya leído
+	final = atomic_load_explicit(&buffer->final, memory_order_relaxed);
+	if(final - buffer->inicioCache == buffer->tam){
+		inicio = atomic_load_explicit(&buffer->inicio, memory_order_acquire);
+		buffer->inicioCache = inicio;
+		if(final - inicio == buffer->tam){
+			return 0;
+		}
+	}
+
+	buffer->valores[buffer->mascara != 0 ? final & buffer->mascara :
+	                                       final % buffer->tam] = valor;
+
+	// Se publica el valor: el 'release' asegura que el consumidor que vea el
+	// nuevo 'final' vea también el valor escrito
+	atomic_store_explicit(&buffer->final, final + 1, memory_order_release);
+
+	return 1;
+}
+
+int sacarBufferSPSC(BufferSPSC* buffer, int* valor){
+	uint64_t final, inicio;
+
+	// Del mismo modo, el consumidor solo lee el 'final' real cuando según su
+	// copia la cola está vacía
+	inicio = atomic_load_explicit(&buffer->inicio, memory_order_relaxed);
+	if(buffer->finalCache == inicio){
+		final = atomic_load_explicit(&buffer->final, memory_order_acquire);
+		buffer->finalCache = final;
+		if(final == inicio){
+			return 0;
+		}
+	}
+
+	*valor = buffer->valores[buffer->mascara != 0 ? inicio & buffer->mascara :
+	                                                inicio % buffer->tam];
+
+	// Se libera la posición para el productor una vez leído el valor
+	atomic_store_explicit(&buffer->inicio, inicio + 1, memory_order_release);
+
+	return 1;
+}
+
+int numElementosSPSC(BufferSPSC* buffer){
+	uint64_t final, inicio;
+
+	inicio = atomic_load_explicit(&buffer->inicio, memory_order_acquire);
+	final = atomic_load_explicit(&buffer->final, memory_order_acquire);
+
+	return (int)(final - inicio);
+}
+
+// Estados de los huecos del buffer genérico
+#define HUECO_LIBRE 0
+#define HUECO_RESERVADO 1
+#define HUECO_CONFIRMADO 2
+#define HUECO_ADQUIRIDO 3
+#define HUECO_LIBERADO 4
+
+/*
+* Función que retorna la posición del array correspondiente al contador
+* indicado para el buffer genérico
+*/
+static inline unsigned int posicionGenerico(const BufferGenerico* buffer,
+		uint64_t contador){
+	if(buffer->mascara != 0){
+		return (unsigned int)(contador & buffer->mascara);
+	}
+	return (unsigned int)(contador % (unsigned int)buffer->tam);
+}
+
+/*
+* Función que retorna la posición del hueco apuntado por 'hueco'
+*/
+static inline unsigned int indiceHueco(const BufferGenerico* buffer,
+		void* hueco){
+	return (unsigned int)(((unsigned char*)hueco - buffer->datos) /
+			buffer->tamElemento);
+}
+
+BufferGenerico crearBufferGenerico(unsigned int tam, size_t tamElemento){
+	BufferGenerico buf;
+
+	buf.tam = tam;
+	buf.tamElemento = tamElemento;
+	buf.mascara = calcularMascara(tam);
+
+	// Se reserva memoria para los huecos y se marcan todos como libres
+	buf.datos = (unsigned char*) malloc(tamElemento * tam);
+	buf.estados = (unsigned char*) calloc(tam, sizeof(unsigned char));
+
+	buf.reservado = 0;
+	buf.publicado = 0;
+	buf.adquirido = 0;
+	buf.liberado = 0;
+
+	return buf;
+}
+
+void destruirBufferGenerico(BufferGenerico* buf){
+	if(buf != NULL && buf->datos != NULL){
+		free(buf->datos);
+		free(buf->estados);
+		buf->datos = NULL;
+		buf->estados = NULL;
+		buf->tam = -1;
+	}
+}
+
+void* reservarHueco(BufferGenerico* buffer){
+	unsigned int indice;
+
+	if(buffer == NULL || buffer->datos == NULL){
+		return NULL;
+	}
+
+	// Un hueco solo se puede reutilizar cuando ha sido liberado y todos los
+	// anteriores también, por lo que el límite lo marca 'liberado'
+	if(buffer->reservado - buffer->liberado == (uint64_t)buffer->tam){
+		return NULL;
+	}
+
+	indice = posicionGenerico(buffer, buffer->reservado);
+	buffer->estados[indice] = HUECO_RESERVADO;
+	buffer->reservado += 1;
+
+	return buffer->datos + (size_t)indice * buffer->tamElemento;
+}
+
+void confirmarHueco(BufferGenerico* buffer, void* hueco){
+	unsigned int indice;
+
+	buffer->estados[indiceHueco(buffer, hueco)] = HUECO_CONFIRMADO;
+
+	// Se publican todos los huecos confirmados consecutivos. Si un hueco
+	// anterior sigue reservado, este queda pendiente hasta que se confirme
+	while(buffer->publicado < buffer->reservado){
+		indice = posicionGenerico(buffer, buffer->publicado);
+		if(buffer->estados[indice] != HUECO_CONFIRMADO){
+			break;
+		}
+		buffer->publicado += 1;
+	}
+}
+
+void* adquirirHueco(BufferGenerico* buffer){
+	unsigned int indice;
+
+	if(buffer == NULL || buffer->datos == NULL){
+		return NULL;
+	}
+
+	if(buffer->adquirido == buffer->publicado){
+		return NULL;
+	}
+
+	indice = posicionGenerico(buffer, buffer->adquirido);
+	buffer->estados[indice] = HUECO_ADQUIRIDO;
+	buffer->adquirido += 1;
+
+	return buffer->datos + (size_t)indice * buffer->tamElemento;
+}
+
+void liberarHueco(BufferGenerico* buffer, void* hueco){
+	unsigned int indice;
+
+	buffer->estados[indiceHueco(buffer, hueco)] = HUECO_LIBERADO;
+
+	// Se devuelven a los productores todos los huecos liberados consecutivos
+	while(buffer->liberado < buffer->adquirido){
+		indice = posicionGenerico(buffer, buffer->liberado);
+		if(buffer->estados[indice] != HUECO_LIBERADO){
+			break;
+		}
+		buffer->estados[indice] = HUECO_LIBRE;
+		buffer->liberado += 1;
+	}
+}
+
+int numElementosGenerico(BufferGenerico* buffer){
+	return (int)(buffer->publicado - buffer->adquirido);
+}
+
+int huecosLibres(BufferGenerico* buffer){
+	return buffer->tam - (int)(buffer->reservado - buffer->liberado);
+}
+
+// Número mágico que identifica un segmento creado con 'crearBufferCompartido'.
+// Se cambia la versión cuando cambia la estructura del segmento
+#define MAGICO_COMPARTIDO 0x42554643
+#define VERSION_COMPARTIDO 1
+
+// Intentos y tiempo entre intentos (en microsegundos) con los que se espera a
+// que el creador termine de iniciar el segmento
+#define INTENTOS_COMPARTIDO 1000
+#define ESPERA_COMPARTIDO 1000
+
+/*
+* Estructura del segmento compartido. Los valores se almacenan a continuación
+* de la cabecera. Al igual que en el TAD Buffer, los contadores del productor y
+* del consumidor se encuentran en líneas de caché distintas
+*		- magico, version, tam, mascara: identificación y tamaño de la cola
+*		- iniciado: se pone a 1 con semántica 'release' una vez iniciados el resto
+*								de campos, y hasta entonces no se puede utilizar el segmento
+*		- mutex: mutex compartido entre procesos y robusto
+*		- condNoLlena y condNoVacia: variables de condición compartidas entre
+*																 procesos
+*		- productoresEsperando y consumidoresEsperando: procesos dormidos en cada
+*																										variable de condición
+*		- producciones: producciones pendientes de consumir
+*		- final e inicio: iguales que en el TAD Buffer
+*/
+typedef struct ST_CABECERACOMPARTIDA{
+	uint32_t magico;
+	uint32_t version;
+	int tam;
+	unsigned int mascara;
+	_Atomic int iniciado;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t condNoLlena;
+	pthread_cond_t condNoVacia;
+	int productoresEsperando;
+	int consumidoresEsperando;
+	int producciones;
+
+	ALINEACION_BUFFER _Atomic uint64_t final;
+	ALINEACION_BUFFER _Atomic uint64_t inicio;
+
+	ALINEACION_BUFFER int valores[];
+} CabeceraCompartida;
+
+/*
+* Función que retorna la posición del array correspondiente al contador
+* indicado para el buffer compartido
+*/
+static inline unsigned int posicionCompartido(const CabeceraCompartida* c,
+		uint64_t contador){
+	if(c->mascara != 0){
+		return (unsigned int)(contador & c->mascara);
+	}
+	return (unsigned int)(contador % (unsigned int)c->tam);
+}
+
+/*
+* Función que bloquea el mutex del segmento. Si el proceso que lo tenía
+* terminó sin liberarlo, se marca como consistente: los contadores solo se
+* modifican al final de cada operación, por lo que la cola sigue siendo válida
+*/
+static void bloquearCompartido(CabeceraCompartida* c){
+	if(pthread_mutex_lock(&c->mutex) == EOWNERDEAD){
+		pthread_mutex_consistent(&c->mutex);
+	}
+}
+
+BufferCompartido crearBufferCompartido(const char* nombre, unsigned int tam){
+	BufferCompartido buf = {NULL, 0};
+	CabeceraCompartida* c;
+	pthread_mutexattr_t atributosMutex;
+	pthread_condattr_t atributosCond;
+	size_t bytes;
+	void* mapeo;
+	int fd, error;
+
+	bytes = sizeof(CabeceraCompartida) + sizeof(int) * tam;
+
+	// O_EXCL evita iniciar de nuevo un segmento que otros procesos ya utilizan
+	fd = shm_open(nombre, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if(fd == -1){
+		return buf;
+	}
+
+	if(ftruncate(fd, bytes) == -1){
+		error = errno;
+		close(fd);
+		shm_unlink(nombre);
+		errno = error;
+		return buf;
+	}
+
+	mapeo = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	error = errno;
+	close(fd);
+	if(mapeo == MAP_FAILED){
+		shm_unlink(nombre);
+		errno = error;
+		return buf;
+	}
+
+	// ftruncate deja el segmento a 0, por lo que 'iniciado' vale 0 hasta que
+	// se termine de iniciar
+	c = (CabeceraCompartida*) mapeo;
+	c->magico = MAGICO_COMPARTIDO;
+	c->version = VERSION_COMPARTIDO;
+	c->tam = tam;
+	c->mascara = calcularMascara(tam);
+	c->productoresEsperando = 0;
+	c->consumidoresEsperando = 0;
+	c->producciones = 0;
+	atomic_init(&c->final, 0);
+	atomic_init(&c->inicio, 0);
+
+	pthread_mutexattr_init(&atributosMutex);
+	pthread_mutexattr_setpshared(&atributosMutex, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&atributosMutex, PTHREAD_MUTEX_ROBUST);
+	pthread_mutex_init(&c->mutex, &atributosMutex);
+	pthread_mutexattr_destroy(&atributosMutex);
+
+	pthread_condattr_init(&atributosCond);
+	pthread_condattr_setpshared(&atributosCond, PTHREAD_PROCESS_SHARED);
+	pthread_cond_init(&c->condNoLlena, &atributosCond);
+	pthread_cond_init(&c->condNoVacia, &atributosCond);
+	pthread_condattr_destroy(&atributosCond);
+
+	// Se publica el segmento para los procesos que lo estén abriendo
+	atomic_store_explicit(&c->iniciado, 1, memory_order_release);
+
+	buf.cabecera = c;
+	buf.tamMapeo = bytes;
+	return buf;
+}
+
+BufferCompartido abrirBufferCompartido(const char* nombre){
+	BufferCompartido buf = {NULL, 0};
+	CabeceraCompartida* c;
+	struct stat estado;
+	void* mapeo;
+	int fd, intentos;
+
+	fd = shm_open(nombre, O_RDWR, 0);
+	if(fd == -1){
+		return buf;
+	}
+
+	// El creador puede no haber fijado todavía el tamaño del segmento
+	for(intentos = 0; intentos < INTENTOS_COMPARTIDO; intentos++){
+		if(fstat(fd, &estado) == -1){
+			close(fd);
+			return buf;
+		}
+		if((size_t) estado.st_size >= sizeof(CabeceraCompartida)){
+			break;
+		}
+		usleep(ESPERA_COMPARTIDO);
+	}
+
+	if((size_t) estado.st_size < sizeof(CabeceraCompartida)){
+		close(fd);
+		errno = EINVAL;
+		return buf;
+	}
+
+	mapeo = mmap(NULL, estado.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+			0);
+	close(fd);
+	if(mapeo == MAP_FAILED){
+		return buf;
+	}
+	c = (CabeceraCompartida*) mapeo;
+
+	for(intentos = 0; intentos < INTENTOS_COMPARTIDO &&
+			!atomic_load_explicit(&c->iniciado, memory_order_acquire); intentos++){
+		usleep(ESPERA_COMPARTIDO);
+	}
+
+	if(!atomic_load_explicit(&c->iniciado, memory_order_acquire) ||
+			c->magico != MAGICO_COMPARTIDO || c->version != VERSION_COMPARTIDO ||
+			sizeof(CabeceraCompartida) + sizeof(int) * c->tam >
+			(size_t) estado.st_size){
+		munmap(mapeo, estado.st_size);
+		errno = EINVAL;
+		return buf;
+	}
+
+	buf.cabecera = c;
+	buf.tamMapeo = estado.st_size;
+	return buf;
+}
+
+void cerrarBufferCompartido(BufferCompartido* buf){
+	if(buf != NULL && buf->cabecera != NULL){
+		munmap(buf->cabecera, buf->tamMapeo);
+		buf->cabecera = NULL;
+		buf->tamMapeo = 0;
+	}
+}
+
+int eliminarBufferCompartido(const char* nombre){
+	return shm_unlink(nombre);
+}
+
+int insertarBufferCompartido(BufferCompartido* buffer, const int* valores,
+		int n){
+	CabeceraCompartida* c;
+	unsigned int posicionFinal, hastaFinal;
+	uint64_t final, inicio;
+	int libres;
+
+	if(buffer == NULL || buffer->cabecera == NULL || n <= 0){
+		return 0;
+	}
+	c = buffer->cabecera;
+
+	bloquearCompartido(c);
+
+	// Mientras el proceso duerme otros productores pueden insertar, por lo que
+	// ambos contadores se vuelven a leer al despertar
+	while(1){
+		final = atomic_load_explicit(&c->final, memory_order_relaxed);
+		inicio = atomic_load_explicit(&c->inicio, memory_order_relaxed);
+		libres = c->tam - (int)(final - inicio);
+		if(libres > 0){
+			break;
+		}
+
+		c->productoresEsperando++;
+		if(pthread_cond_wait(&c->condNoLlena, &c->mutex) == EOWNERDEAD){
+			pthread_mutex_consistent(&c->mutex);
+		}
+		c->productoresEsperando--;
+	}
+
+	if(n > libres){
+		n = libres;
+	}
+
+	// Igual que en 'insertarBufferN', la copia se realiza en como mucho dos
+	// bloques
+	posicionFinal = posicionCompartido(c, final);
+	hastaFinal = c->tam - posicionFinal;
+	if(n <= hastaFinal){
+		memcpy(c->valores + posicionFinal, valores, sizeof(int) * n);
+	} else {
+		memcpy(c->valores + posicionFinal, valores, sizeof(int) * hastaFinal);
+		memcpy(c->valores, valores + hastaFinal, sizeof(int) * (n - hastaFinal));
+	}
+
+	atomic_store_explicit(&c->final, final + n, memory_order_release);
+
+	if(c->consumidoresEsperando > 0){
+		if(n == 1){
+			pthread_cond_signal(&c->condNoVacia);
+		} else {
+			pthread_cond_broadcast(&c->condNoVacia);
+		}
+	}
+
+	pthread_mutex_unlock(&c->mutex);
+
+	return n;
+}
+
+int sacarBufferCompartido(BufferCompartido* buffer, int* valores, int n){
+	CabeceraCompartida* c;
+	unsigned int posicionInicio, hastaFinal;
+	uint64_t final, inicio;
+	int elementos;
+
+	if(buffer == NULL || buffer->cabecera == NULL || n <= 0){
+		return 0;
+	}
+	c = buffer->cabecera;
+
+	bloquearCompartido(c);
+
+	while(1){
+		inicio = atomic_load_explicit(&c->inicio, memory_order_relaxed);
+		final = atomic_load_explicit(&c->final, memory_order_relaxed);
+		elementos = (int)(final - inicio);
+		if(elementos > 0){
+			break;
+		}
+
+		// Sin producciones pendientes no se va a insertar nada más
+		if(c->producciones == 0){
+			pthread_mutex_unlock(&c->mutex);
+			return 0;
+		}
+
+		c->consumidoresEsperando++;
+		if(pthread_cond_wait(&c->condNoVacia, &c->mutex) == EOWNERDEAD){
+			pthread_mutex_consistent(&c->mutex);
+		}
+		c->consumidoresEsperando--;
+	}
+
+	if(n > elementos){
+		n = elementos;
+	}
+
+	posicionInicio = posicionCompartido(c, inicio);
+	hastaFinal = c->tam - posicionInicio;
+	if(n <= hastaFinal){
+		memcpy(valores, c->valores + posicionInicio, sizeof(int) * n);
+	} else {
+		memcpy(valores, c->valores + posicionInicio, sizeof(int) * hastaFinal);
+		memcpy(valores + hastaFinal, c->valores, sizeof(int) * (n - hastaFinal));
+	}
+
+	atomic_store_explicit(&c->inicio, inicio + n, memory_order_release);
+
+	c->producciones -= n;
+	if(c->producciones < 0){
+		c->producciones = 0;
+	}
+
+	if(c->productoresEsperando > 0){
+		if(n == 1){
+			pthread_cond_signal(&c->condNoLlena);
+		} else {
+			pthread_cond_broadcast(&c->condNoLlena);
+		}
+	}
+
+	// El último elemento despierta a los consumidores que quedan dormidos para
+	// que finalicen
+	if(c->producciones == 0 && c->consumidoresEsperando > 0){
+		pthread_cond_broadcast(&c->condNoVacia);
+	}
+
+	pthread_mutex_unlock(&c->mutex);
+
+	return n;
+}
+
+void incrementarProduccionesCompartido(BufferCompartido* buffer,
+		int incremento){
+	CabeceraCompartida* c = buffer->cabecera;
+
+	bloquearCompartido(c);
+	c->producciones += incremento;
+	if(c->producciones < 0){
+		c->producciones = 0;
+	}
+	pthread_mutex_unlock(&c->mutex);
+}
+
+int numElementosCompartido(const BufferCompartido* buffer){
+	uint64_t inicio, final;
+
+	inicio = atomic_load_explicit(&buffer->cabecera->inicio,
+			memory_order_acquire);
+	final = atomic_load_explicit(&buffer->cabecera->final, memory_order_acquire);
+
+	return (int)(final - inicio);
+}
+
+// Número mágico que identifica un fichero creado con 'abrirBufferPersistente'
+#define MAGICO_PERSISTENTE 0x42555050
+#define VERSION_PERSISTENTE 1
+
+/*
+* Registro de posición del buffer persistente. La suma de comprobación cubre
+* el resto de campos, por lo que un registro escrito a medias no es válido
+*/
+typedef struct ST_POSICIONPERSISTENTE{
+	uint64_t secuencia;
+	uint64_t inicio;
+	uint64_t final;
+	uint64_t suma;
+} PosicionPersistente;
+
+/*
+* Cabecera del fichero del buffer persistente. Los valores comienzan en
+* 'desplazamiento', que es múltiplo del tamaño de página para poder
+* sincronizarlos por separado
+*/
+typedef struct ST_CABECERAPERSISTENTE{
+	uint32_t magico;
+	uint32_t version;
+	uint32_t tam;
+	uint32_t desplazamiento;
+	PosicionPersistente posiciones[2];
+} CabeceraPersistente;
+
+/*
+* Función que calcula la suma de comprobación (FNV-1a) de un registro de
+* posición
+*/
+static uint64_t sumaPosicion(const PosicionPersistente* p){
+	const unsigned char* bytes = (const unsigned char*) p;
+	uint64_t suma = 0xcbf29ce484222325ULL;
+	size_t i;
+
+	for(i = 0; i < offsetof(PosicionPersistente, suma); i++){
+		suma = (suma ^ bytes[i]) * 0x100000001b3ULL;
+	}
+
+	return suma;
+}
+
+/*
+* Función que retorna la posición del array correspondiente al contador
+* indicado para el buffer persistente
+*/
+static inline unsigned int posicionPersistente(const BufferPersistente* buffer,
+		uint64_t contador){
+	if(buffer->mascara != 0){
+		return (unsigned int)(contador & buffer->mascara);
+	}
+	return (unsigned int)(contador % (unsigned int)buffer->tam);
+}
+
+/*
+* Función que lleva a disco las páginas que contienen los bytes indicados de
+* la proyección
+*/
+static int sincronizarBytes(void* direccion, size_t bytes){
+	uintptr_t pagina = (uintptr_t) sysconf(_SC_PAGESIZE);
+	uintptr_t desde = (uintptr_t) direccion & ~(pagina - 1);
+
+	return msync((void*) desde, (uintptr_t) direccion + bytes - desde, MS_SYNC);
+}
+
+BufferPersistente abrirBufferPersistente(const char* ruta, unsigned int tam,
+		unsigned int intervalo){
+	BufferPersistente buf;
+	CabeceraPersistente cabecera;
+	struct stat estado;
+	size_t pagina, desplazamiento;
+	void* mapeo;
+	int error;
+
+	memset(&buf, 0, sizeof(BufferPersistente));
+	buf.fd = open(ruta, O_RDWR | O_CREAT, 0600);
+	if(buf.fd == -1){
+		return buf;
+	}
+
+	if(fstat(buf.fd, &estado) == -1){
+		goto error;
+	}
+
+	if(estado.st_size == 0){
+		// Fichero nuevo: la cabecera ocupa la primera página y los valores
+		// empiezan en la siguiente
+		pagina = (size_t) sysconf(_SC_PAGESIZE);
+		desplazamiento = (sizeof(CabeceraPersistente) + pagina - 1) /
+				pagina * pagina;
+
+		memset(&cabecera, 0, sizeof(CabeceraPersistente));
+		cabecera.magico = MAGICO_PERSISTENTE;
+		cabecera.version = VERSION_PERSISTENTE;
+		cabecera.tam = tam;
+		cabecera.desplazamiento = desplazamiento;
+
+		// Se escribe la cabecera completa antes de que el fichero tenga su tamaño
+		// final, de forma que un fichero con valores siempre tiene cabecera
+		if(pwrite(buf.fd, &cabecera, sizeof(CabeceraPersistente), 0) !=
+				sizeof(CabeceraPersistente) ||
+				ftruncate(buf.fd, desplazamiento + sizeof(int) * tam) == -1 ||
+				fsync(buf.fd) == -1){
+			goto error;
+		}
+	} else if(pread(buf.fd, &cabecera, sizeof(CabeceraPersistente), 0) !=
+			sizeof(CabeceraPersistente) || cabecera.magico != MAGICO_PERSISTENTE ||
+			cabecera.version != VERSION_PERSISTENTE ||
+			(uint64_t) estado.st_size <
+			cabecera.desplazamiento + sizeof(int) * (uint64_t) cabecera.tam){
+		errno = EINVAL;
+		goto error;
+	}
+
+	buf.tamMapeo = cabecera.desplazamiento + sizeof(int) * cabecera.tam;
+	mapeo = mmap(NULL, buf.tamMapeo, PROT_READ | PROT_WRITE, MAP_SHARED,
+			buf.fd, 0);
+	if(mapeo == MAP_FAILED){
+		goto error;
+	}
+
+	buf.cabecera = (CabeceraPersistente*) mapeo;
+	buf.valores = (int*)((unsigned char*) mapeo + cabecera.desplazamiento);
+	buf.tam = cabecera.tam;
+	buf.mascara = calcularMascara(cabecera.tam);
+	buf.intervalo = intervalo;
+
+	recuperarBufferPersistente(&buf);
+
+	return buf;
+
+error:
+	error = errno;
+	close(buf.fd);
+	memset(&buf, 0, sizeof(BufferPersistente));
+	errno = error;
+	return buf;
+}
+
+int recuperarBufferPersistente(BufferPersistente* buf){
+	PosicionPersistente* elegida = NULL;
+	PosicionPersistente* p;
+	int i;
+
+	for(i = 0; i < 2; i++){
+		p = &buf->cabecera->posiciones[i];
+
+		// Un registro solo es válido si su suma coincide y describe una cola
+		// posible
+		if(p->suma != sumaPosicion(p) || p->final < p->inicio ||
+				p->final - p->inicio > (uint64_t) buf->tam){
+			continue;
+		}
+
+		if(elegida == NULL || p->secuencia > elegida->secuencia){
+			elegida = p;
+		}
+	}
+
+	buf->operaciones = 0;
+
+	if(elegida == NULL){
+		buf->inicio = 0;
+		buf->final = 0;
+		buf->inicioSincronizado = 0;
+		buf->finalSincronizado = 0;
+		buf->secuencia = 0;
+		return -1;
+	}
+
+	buf->inicio = elegida->inicio;
+	buf->final = elegida->final;
+	buf->inicioSincronizado = elegida->inicio;
+	buf->finalSincronizado = elegida->final;
+	buf->secuencia = elegida->secuencia;
+	return 0;
+}
+
+int sincronizarBufferPersistente(BufferPersistente* buf){
+	PosicionPersistente* p;
+	unsigned int desde, hasta;
+
+	// Primero se llevan a disco los valores insertados desde la última
+	// sincronización, en como mucho dos bloques
+	if(buf->final != buf->finalSincronizado){
+		desde = posicionPersistente(buf, buf->finalSincronizado);
+		hasta = posicionPersistente(buf, buf->final - 1);
+
+		if(buf->final - buf->finalSincronizado >= (uint64_t) buf->tam){
+			if(sincronizarBytes(buf->valores, sizeof(int) * buf->tam) == -1){
+				return -1;
+			}
+		} else if(desde <= hasta){
+			if(sincronizarBytes(buf->valores + desde,
+					sizeof(int) * (hasta - desde + 1)) == -1){
+				return -1;
+			}
+		} else if(sincronizarBytes(buf->valores + desde,
+				sizeof(int) * (buf->tam - desde)) == -1 ||
+				sincronizarBytes(buf->valores, sizeof(int) * (hasta + 1)) == -1){
+			return -1;
+		}
+	}
+
+	// Después se escribe la posición en el registro que no contiene la última,
+	// de forma que esta sigue siendo válida hasta que la nueva llega a disco
+	p = &buf->cabecera->posiciones[(buf->secuencia + 1) & 1];
+	p->secuencia = buf->secuencia + 1;
+	p->inicio = buf->inicio;
+	p->final = buf->final;
+	p->suma = sumaPosicion(p);
+
+	if(sincronizarBytes(p, sizeof(PosicionPersistente)) == -1){
+		return -1;
+	}
+
+	buf->secuencia++;
+	buf->inicioSincronizado = buf->inicio;
+	buf->finalSincronizado = buf->final;
+	buf->operaciones = 0;
+	return 0;
+}
+
+void cerrarBufferPersistente(BufferPersistente* buf){
+	if(buf != NULL && buf->cabecera != NULL){
+		sincronizarBufferPersistente(buf);
+		munmap(buf->cabecera, buf->tamMapeo);
+		close(buf->fd);
+		buf->cabecera = NULL;
+		buf->valores = NULL;
+		buf->fd = -1;
+	}
+}
+
+/*
+* Función que cuenta una operación sobre el buffer persistente y lo sincroniza
+* si se ha alcanzado el intervalo
+*/
+static inline void contarOperacion(BufferPersistente* buffer){
+	if(buffer->intervalo > 0 && ++buffer->operaciones >= buffer->intervalo){
+		sincronizarBufferPersistente(buffer);
+	}
+}
+
+int insertarBufferPersistenteN(BufferPersistente* buffer, const int* valores,
+		int n){
+	unsigned int posicionFinal, hastaFinal;
+	int libres;
+
+	if(buffer == NULL || buffer->cabecera == NULL || n <= 0){
+		return 0;
+	}
+
+	// Solo se pueden sobrescribir las posiciones liberadas antes de la última
+	// sincronización. Si hacen falta más y las hay, se sincroniza
+	libres = buffer->tam - (int)(buffer->final - buffer->inicioSincronizado);
+	if(libres < n && buffer->inicio != buffer->inicioSincronizado){
+		if(sincronizarBufferPersistente(buffer) == -1){
+			return 0;
+		}
+		libres = buffer->tam - (int)(buffer->final - buffer->inicioSincronizado);
+	}
+	if(n > libres){
+		n = libres;
+	}
+	if(n == 0){
+		return 0;
+	}
+
+	posicionFinal = posicionPersistente(buffer, buffer->final);
+	hastaFinal = buffer->tam - posicionFinal;
+	if(n <= hastaFinal){
+		memcpy(buffer->valores + posicionFinal, valores, sizeof(int) * n);
+	} else {
+		memcpy(buffer->valores + posicionFinal, valores,
+				sizeof(int) * hastaFinal);
+		memcpy(buffer->valores, valores + hastaFinal,
+				sizeof(int) * (n - hastaFinal));
+	}
+
+	buffer->final += n;
+	contarOperacion(buffer);
+
+	return n;
+}
+
+int sacarBufferPersistenteN(BufferPersistente* buffer, int* valores, int n){
+	unsigned int posicionInicio, hastaFinal;
+	int elementos;
+
+	if(buffer == NULL || buffer->cabecera == NULL || n <= 0){
+		return 0;
+	}
+
+	elementos = (int)(buffer->final - buffer->inicio);
+	if(n > elementos){
+		n = elementos;
+	}
+	if(n == 0){
+		return 0;
+	}
+
+	posicionInicio = posicionPersistente(buffer, buffer->inicio);
+	hastaFinal = buffer->tam - posicionInicio;
+	if(n <= hastaFinal){
+		memcpy(valores, buffer->valores + posicionInicio, sizeof(int) * n);
+	} else {
+		memcpy(valores, buffer->valores + posicionInicio,
+				sizeof(int) * hastaFinal);
+		memcpy(valores + hastaFinal, buffer->valores,
+				sizeof(int) * (n - hastaFinal));
+	}
+
+	buffer->inicio += n;
+	contarOperacion(buffer);
+
+	return n;
+}
+
+int numElementosPersistente(const BufferPersistente* buffer){
+	return (int)(buffer->final - buffer->inicio);
+}
+
+BufferPrioridad crearBufferPrioridad(unsigned int tam, int numNiveles){
+	BufferPrioridad buf;
+	int i;
+
+	if(numNiveles < 1){
+		numNiveles = 1;
+	} else if(numNiveles > BUFFER_MAX_NIVELES){
+		numNiveles = BUFFER_MAX_NIVELES;
+	}
+
+	// Cada nivel es un buffer independiente del tamaño indicado, por lo que los
+	// elementos poco prioritarios nunca ocupan las posiciones de los urgentes
+	buf.niveles = (Buffer*) malloc(sizeof(Buffer) * numNiveles);
+	buf.numNiveles = numNiveles;
+	for(i = 0; i < numNiveles; i++){
+		buf.niveles[i] = crearBuffer(tam);
+	}
+
+	atomic_init(&buf.ocupados, 0);
+	buf.producciones = 0;
+
+	return buf;
+}
+
+void destruirBufferPrioridad(BufferPrioridad* buf){
+	int i;
+
+	if(buf != NULL && buf->niveles != NULL){
+		for(i = 0; i < buf->numNiveles; i++){
+			destruirBuffer(&buf->niveles[i]);
+		}
+		free(buf->niveles);
+		buf->niveles = NULL;
+		buf->numNiveles = 0;
+		buf->producciones = -1;
+		atomic_store(&buf->ocupados, 0);
+	}
+}
+
+int insertarBufferPrioridadN(BufferPrioridad* buffer, const int* valores,
+		int n, int prioridad){
+	int insertados;
+
+	if(buffer == NULL || buffer->niveles == NULL || prioridad < 0 ||
+			prioridad >= buffer->numNiveles){
+		return 0;
+	}
+
+	insertados = insertarBufferN(&buffer->niveles[prioridad], valores, n);
+
+	// El bit se activa después de publicar los valores. El 'release' hace que
+	// el consumidor que lo desactive después vea la inserción al volver a
+	// comprobar el nivel
+	if(insertados > 0){
+		atomic_fetch_or_explicit(&buffer->ocupados, 1u << prioridad,
+				memory_order_release);
+	}
+
+	return insertados;
+}
+
+int insertarBufferPrioridad(BufferPrioridad* buffer, int valor, int prioridad){
+	return insertarBufferPrioridadN(buffer, &valor, 1, prioridad);
+}
+
+int sacarBufferPrioridadN(BufferPrioridad* buffer, int* valores, int n,
+		int* prioridad){
+	uint32_t ocupados, bit;
+	int nivel, sacados;
+
+	if(buffer == NULL || buffer->niveles == NULL || n <= 0){
+		return 0;
+	}
+
+	ocupados = atomic_load_explicit(&buffer->ocupados, memory_order_acquire);
+
+	while(ocupados != 0){
+		// El nivel más prioritario con elementos es el del bit activo más bajo
+		nivel = __builtin_ctz(ocupados);
+		bit = 1u << nivel;
+
+		sacados = sacarBufferN(&buffer->niveles[nivel], valores, n);
+		if(sacados > 0){
+			if(prioridad != NULL){
+				*prioridad = nivel;
+			}
+			return sacados;
+		}
+
+		// El nivel está vacío, por lo que se desactiva su bit y se vuelve a
+		// comprobar. Si un productor ha insertado entre ambas operaciones, o
+		// bien su bit se activa después de desactivarlo o bien la nueva
+		// comprobación ve la inserción
+		atomic_fetch_and_explicit(&buffer->ocupados, ~bit, memory_order_acq_rel);
+		if(!colaVacia(&buffer->niveles[nivel])){
+			atomic_fetch_or_explicit(&buffer->ocupados, bit, memory_order_relaxed);
+		} else {
+			ocupados &= ~bit;
+		}
+	}
+
+	return 0;
+}
+
+int colaLlenaPrioridad(BufferPrioridad* buffer, int prioridad){
+	return colaLlena(&buffer->niveles[prioridad]);
+}
+
+int colaVaciaPrioridad(BufferPrioridad* buffer){
+	uint32_t ocupados;
+	int nivel;
+
+	// Solo los niveles con el bit activo pueden tener elementos
+	ocupados = atomic_load_explicit(&buffer->ocupados, memory_order_acquire);
+	while(ocupados != 0){
+		nivel = __builtin_ctz(ocupados);
+		if(!colaVacia(&buffer->niveles[nivel])){
+			return 0;
+		}
+		ocupados &= ~(1u << nivel);
+	}
+
+	return 1;
+}
+
+int numElementosPrioridad(const BufferPrioridad* buffer){
+	int i, elementos = 0;
+
+	for(i = 0; i < buffer->numNiveles; i++){
+		elementos += numElementos(&buffer->niveles[i]);
+	}
+
+	return elementos;
+}
+
+int obtenerProduccionesPrioridad(const BufferPrioridad* buffer){
+	return buffer->niveles != NULL ? buffer->producciones : -1;
+}
+
+void incrementarProduccionesPrioridad(BufferPrioridad* buffer, int incremento){
+	buffer->producciones += incremento;
+	if(buffer->producciones < 0){
+		buffer->producciones = 0;
+	}
+}
+
+/*
+* Segmento del TAD BufferSegmentado. El campo 'siguiente' enlaza los segmentos
+* de la cola mientras el segmento está en uso y los de la reserva cuando está
+* libre
+*/
+typedef struct ST_SEGMENTO{
+	struct ST_SEGMENTO* siguiente;
+	int valores[BUFFER_TAM_SEGMENTO];
+} Segmento;
+
+/*
+* Función que obtiene un segmento vacío de la reserva o, si está vacía, de
+* memoria nueva. Solo la llaman los productores, en exclusión mutua, por lo que
+* hay un único hilo desapilando: un segmento no puede salir y volver a la cima
+* de la pila mientras se desapila, y la comparación no sufre el problema ABA
+*/
+static Segmento* obtenerSegmento(BufferSegmentado* buffer){
+	Segmento* segmento;
+
+	segmento = atomic_load_explicit(&buffer->libres, memory_order_acquire);
+	while(segmento != NULL && !atomic_compare_exchange_weak_explicit(
+			&buffer->libres, &segmento, segmento->siguiente,
+			memory_order_acquire, memory_order_acquire));
+
+	if(segmento == NULL){
+		segmento = (Segmento*) malloc(sizeof(Segmento));
+		if(segmento == NULL){
+			return NULL;
+		}
+		buffer->segmentos++;
+	}
+
+	segmento->siguiente = NULL;
+	return segmento;
+}
+
+/*
+* Función que apila en la reserva un segmento que los consumidores han
+* terminado de leer
+*/
+static void devolverSegmento(BufferSegmentado* buffer, Segmento* segmento){
+	Segmento* cima;
+
+	cima = atomic_load_explicit(&buffer->libres, memory_order_relaxed);
+	do{
+		segmento->siguiente = cima;
+	} while(!atomic_compare_exchange_weak_explicit(&buffer->libres, &cima,
+			segmento, memory_order_release, memory_order_relaxed));
+}
+
+BufferSegmentado crearBufferSegmentado(unsigned int limite){
+	BufferSegmentado buf;
+
+	atomic_init(&buf.libres, NULL);
+	atomic_init(&buf.final, 0);
+	atomic_init(&buf.inicio, 0);
+	buf.segmentos = 0;
+	buf.limite = limite;
+	buf.producciones = 0;
+
+	// Productores y consumidores empiezan en el mismo segmento
+	buf.cola = obtenerSegmento(&buf);
+	buf.cabeza = buf.cola;
+
+	return buf;
+}
+
+void destruirBufferSegmentado(BufferSegmentado* buf){
+	Segmento* segmento;
+	Segmento* siguiente;
+
+	if(buf == NULL || buf->cola == NULL){
+		return;
+	}
+
+	// Los segmentos en uso van de 'cabeza' a 'cola'
+	for(segmento = buf->cabeza; segmento != NULL; segmento = siguiente){
+		siguiente = segmento->siguiente;
+		free(segmento);
+	}
+
+	for(segmento = atomic_load(&buf->libres); segmento != NULL;
+			segmento = siguiente){
+		siguiente = segmento->siguiente;
+		free(segmento);
+	}
+
+	atomic_store(&buf->libres, NULL);
+	buf->cola = NULL;
+	buf->cabeza = NULL;
+	buf->segmentos = 0;
+	buf->producciones = -1;
+}
+
+int insertarBufferSegmentadoN(BufferSegmentado* buffer, const int* valores,
+		int n){
+	uint64_t final;
+	unsigned int pos, cabe;
+	int insertados = 0;
+	Segmento* nuevo;
+
+	if(buffer == NULL || buffer->cola == NULL || n <= 0){
+		return 0;
+	}
+
+	// Solo los productores modifican 'final'
+	final = atomic_load_explicit(&buffer->final, memory_order_relaxed);
+
+	while(insertados < n){
+		pos = (unsigned int)(final % BUFFER_TAM_SEGMENTO);
+
+		// Si el segmento actual está lleno se enlaza uno nuevo. Los consumidores
+		// solo siguen el enlace después de ver el nuevo 'final', que se publica
+		// al terminar
+		if(pos == 0 && final > 0){
+			nuevo = obtenerSegmento(buffer);
+			if(nuevo == NULL){
+				break;
+			}
+			buffer->cola->siguiente = nuevo;
+			buffer->cola = nuevo;
+		}
+
+		// Se copian tantos valores como quepan en el segmento
+		cabe = BUFFER_TAM_SEGMENTO - pos;
+		if(cabe > n - insertados){
+			cabe = n - insertados;
+		}
+		memcpy(buffer->cola->valores + pos, valores + insertados,
+				sizeof(int) * cabe);
+
+		insertados += cabe;
+		final += cabe;
+	}
+
+	// Se publican todos los valores insertados y los segmentos enlazados
+	atomic_store_explicit(&buffer->final, final, memory_order_release);
+
+	return insertados;
+}
+
+int sacarBufferSegmentadoN(BufferSegmentado* buffer, int* valores, int n){
+	uint64_t inicio, final;
+	unsigned int pos, quedan;
+	int sacados = 0;
+	Segmento* leido;
+
+	if(buffer == NULL || buffer->cabeza == NULL || n <= 0){
+		return 0;
+	}
+
+	// El 'acquire' asegura que los valores y los enlaces entre segmentos
+	// anteriores a 'final' son visibles
+	inicio = atomic_load_explicit(&buffer->inicio, memory_order_relaxed);
+	final = atomic_load_explicit(&buffer->final, memory_order_acquire);
+	if(n > (int)(final - inicio)){
+		n = (int)(final - inicio);
+	}
+
+	while(sacados < n){
+		pos = (unsigned int)(inicio % BUFFER_TAM_SEGMENTO);
+
+		// Al llegar al principio de un segmento el anterior ya se ha leído
+		// completo y los productores escriben en este o en uno posterior, por
+		// lo que se devuelve a la reserva
+		if(pos == 0 && inicio > 0){
+			leido = buffer->cabeza;
+			buffer->cabeza = leido->siguiente;
+			devolverSegmento(buffer, leido);
+		}
+
+		quedan = BUFFER_TAM_SEGMENTO - pos;
+		if(quedan > n - sacados){
+			quedan = n - sacados;
+		}
+		memcpy(valores + sacados, buffer->cabeza->valores + pos,
+				sizeof(int) * quedan);
+
+		sacados += quedan;
+		inicio += quedan;
+	}
+
+	atomic_store_explicit(&buffer->inicio, inicio, memory_order_release);
+
+	return sacados;
+}
+
+int colaLlenaSegmentado(const BufferSegmentado* buffer){
+	return buffer->limite > 0 &&
+			numElementosSegmentado(buffer) >= (int) buffer->limite;
+}
+
+int colaVaciaSegmentado(const BufferSegmentado* buffer){
+	return numElementosSegmentado(buffer) == 0;
+}
+
+int numElementosSegmentado(const BufferSegmentado* buffer){
+	uint64_t inicio, final;
+
+	inicio = atomic_load_explicit(&buffer->inicio, memory_order_acquire);
+	final = atomic_load_explicit(&buffer->final, memory_order_acquire);
+
+	return (int)(final - inicio);
+}
+
+int obtenerProduccionesSegmentado(const BufferSegmentado* buffer){
+	return buffer->cola != NULL ? buffer->producciones : -1;
+}
+
+void incrementarProduccionesSegmentado(BufferSegmentado* buffer,
+		int incremento){
+	buffer->producciones += incremento;
+	if(buffer->producciones < 0){
+		buffer->producciones = 0;
+	}
 }
@@ -1,6 +1,22 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Tamaño de una línea de caché
+#define TAM_LINEA_CACHE 64
+
+// Alineación de los grupos de campos del TAD Buffer. Compilando con
+// -DBUFFER_SIN_PADDING todos los campos comparten línea de caché, lo que
+// permite medir el efecto del falso compartimiento
+#ifdef BUFFER_SIN_PADDING
+#define ALINEACION_BUFFER
+#else
+#define ALINEACION_BUFFER _Alignas(TAM_LINEA_CACHE)
+#endif
+
 /*
 * -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
 * El TAD Buffer tiene a su disposición tantos elementos de tipo 'int' como se
@@ -15,28 +31,298 @@
 * Campos:
 *		- valores: variable que apunta al primer elemento del Buffer
 *		- tam: número de elementos que puede almacenar el buffer
-*		- inicio: posición anterior del primer elemento de la cola (donde empieza)
-*		- final: posición del último elemento de la cola
-*		- numElementos: número de elementos que hay actualmente en la cola
+*		- mascara: en caso de que 'tam' sea potencia de dos vale 'tam - 1', y la
+*							 posición de un contador dentro del array se obtiene con un
+*							 'and' a nivel de bits en lugar de con el módulo. En otro caso
+*							 vale 0
+*		- final: número de elementos insertados desde la creación del buffer. Su
+*						 posición en el array es la de la siguiente inserción
+*		- inicioCache: último valor de 'inicio' leído por los productores
+*		- inicio: número de elementos sacados desde la creación del buffer. Su
+*							posición en el array es la del primer elemento de la cola
+*		- productoresActivos: número de productores registrados que aún no han
+*													terminado
+*		- cerrado: 1 si el buffer se ha cerrado y ya no se van a insertar más
+*							 elementos
+*		- finalCache: último valor de 'final' leído por los consumidores
 *		- producciones: número de producciones que van a ser realizadas por los
 *										productores y que quedan por consumir
+*
+* Los contadores 'inicio' y 'final' nunca se reinician, por lo que el número de
+* elementos de la cola es su diferencia: la cola está vacía cuando son iguales
+* y llena cuando se diferencian en 'tam'.
+*
+* Los campos se agrupan en tres líneas de caché: la de los campos que no cambian
+* tras la creación, la de los campos que solo modifican los productores y la de
+* los que solo modifican los consumidores. Así un productor y un consumidor que
+* operan a la vez no se invalidan mutuamente la línea en cada operación. Cada
+* lado consulta la copia en caché del contador contrario y solo la vuelve a
+* leer cuando según ella la cola está llena (productores) o vacía
+* (consumidores). La copia nunca adelanta al contador real, por lo que como
+* mucho hace que la cola parezca más llena o más vacía de lo que está.
+*
+* 'productoresActivos' y 'cerrado' están en la línea de los productores, que
+* son quienes los modifican, una única vez cada uno. Los consumidores solo
+* consultan 'cerrado' cuando la cola les parece vacía, momento en el que ya
+* leen 'final' de esa misma línea.
 */
 typedef struct ST_BUFFER{
-	int* valores;
+	ALINEACION_BUFFER int* valores;
 	int tam;
-	int inicio;
-	int final;
-	int numElementos;
+	unsigned int mascara;
+
+	ALINEACION_BUFFER _Atomic uint64_t final;
+	uint64_t inicioCache;
+	atomic_int productoresActivos;
+	atomic_int cerrado;
+
+	ALINEACION_BUFFER _Atomic uint64_t inicio;
+	uint64_t finalCache;
 	int producciones;
 } Buffer;
 
+/*
+* Tipo de dato exportado: una estructura tipo ST_BUFFERSPSC
+* Cola circular para el caso de un único productor y un único consumidor, que
+* no necesita de mutexes ni variables de condición para su acceso.
+* Campos:
+*		- valores: variable que apunta al primer elemento del Buffer
+*		- tam: número de elementos que puede almacenar el buffer
+*		- mascara: igual que en el TAD Buffer, 'tam - 1' si 'tam' es potencia de
+*							 dos y 0 en otro caso
+*		- final: número de elementos insertados desde la creación del buffer. Solo
+*						 es modificado por el productor
+*		- inicioCache: último valor de 'inicio' leído por el productor
+*		- inicio: número de elementos sacados desde la creación del buffer. Solo
+*							es modificado por el consumidor
+*		- finalCache: último valor de 'final' leído por el consumidor
+*
+* Al igual que en el TAD Buffer, los contadores 'inicio' y 'final' nunca se
+* reinician y el número de elementos es la diferencia entre ambos. También los
+* campos se agrupan en tres líneas de caché (los que no cambian, los del
+* productor y los del consumidor), y cada hilo solo vuelve a leer el contador
+* del otro cuando según su copia la cola está llena o vacía.
+*/
+typedef struct ST_BUFFERSPSC{
+	ALINEACION_BUFFER int* valores;
+	unsigned int tam;
+	unsigned int mascara;
+
+	ALINEACION_BUFFER _Atomic uint64_t final;
+	uint64_t inicioCache;
+
+	ALINEACION_BUFFER _Atomic uint64_t inicio;
+	uint64_t finalCache;
+} BufferSPSC;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_BUFFERGENERICO
+* Cola circular cuyos elementos son bloques de 'tamElemento' bytes. En lugar de
+* copiar los elementos al insertar y al sacar, el productor reserva un hueco,
+* escribe en él directamente y lo confirma, y el consumidor adquiere un hueco
+* confirmado, lo lee directamente y lo libera. Las escrituras y lecturas del
+* contenido de los huecos no necesitan realizarse en exclusión mutua.
+* Campos:
+*		- datos: variable que apunta al primer hueco del buffer
+*		- estados: estado de cada uno de los huecos (libre, reservado, confirmado,
+*							 adquirido o liberado)
+*		- tam: número de huecos del buffer
+*		- tamElemento: número de bytes de cada hueco
+*		- mascara: igual que en el TAD Buffer
+*		- reservado: número de huecos reservados por los productores
+*		- publicado: número de huecos visibles para los consumidores. Todos los
+*								 huecos anteriores a este contador han sido confirmados
+*		- adquirido: número de huecos adquiridos por los consumidores
+*		- liberado: número de huecos devueltos a los productores. Todos los
+*								huecos anteriores a este contador han sido liberados
+*
+* Se cumple siempre liberado <= adquirido <= publicado <= reservado, y el
+* buffer está lleno cuando 'reservado' y 'liberado' se diferencian en 'tam'.
+*/
+typedef struct ST_BUFFERGENERICO{
+	unsigned char* datos;
+	unsigned char* estados;
+	int tam;
+	size_t tamElemento;
+	unsigned int mascara;
+	uint64_t reservado;
+	uint64_t publicado;
+	uint64_t adquirido;
+	uint64_t liberado;
+} BufferGenerico;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_BUFFERCOMPARTIDO
+* Cola circular situada en un segmento de memoria compartida POSIX con nombre,
+* de forma que procesos distintos puedan insertar y sacar elementos sin copias
+* adicionales ni llamadas al sistema mientras no tengan que dormir. El segmento
+* contiene los valores, los contadores 'inicio' y 'final', el número de
+* producciones pendientes y un mutex y dos variables de condición compartidos
+* entre procesos (ver 'buffer.c').
+* Campos:
+*		- cabecera: dirección en la que el proceso ha proyectado el segmento. Es
+*								distinta en cada proceso, por lo que el segmento no
+*								contiene ningún puntero
+*		- tamMapeo: número de bytes proyectados
+*/
+struct ST_CABECERACOMPARTIDA;
+
+typedef struct ST_BUFFERCOMPARTIDO{
+	struct ST_CABECERACOMPARTIDA* cabecera;
+	size_t tamMapeo;
+} BufferCompartido;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_BUFFERPERSISTENTE
+* Cola circular cuyos valores y contadores se encuentran en un fichero
+* proyectado en memoria, de forma que sobrevive a la terminación del proceso.
+* Las inserciones y extracciones solo escriben en la proyección, como en el TAD
+* Buffer, y el estado se hace persistente al sincronizar: primero se llevan a
+* disco los valores insertados desde la última sincronización y después se
+* escribe la nueva posición ('inicio' y 'final') en el registro de posición que
+* no contiene la última. La cabecera del fichero tiene dos registros de
+* posición con un número de secuencia y una suma de comprobación, por lo que si
+* el proceso termina a mitad de una escritura siempre queda al menos uno
+* válido, y al abrir el fichero se continúa desde el más reciente.
+*
+* Los elementos insertados después de la última sincronización se pierden, y
+* los sacados después de ella se vuelven a entregar (entrega como mínimo una
+* vez).
+* Campos:
+*		- cabecera: dirección de la cabecera proyectada del fichero
+*		- valores: dirección de los valores proyectados, a continuación de la
+*							 cabecera
+*		- tamMapeo: número de bytes proyectados
+*		- fd: descriptor del fichero
+*		- tam: número de elementos que puede almacenar el buffer
+*		- mascara: igual que en el TAD Buffer
+*		- inicio y final: contadores actuales, igual que en el TAD Buffer
+*		- inicioSincronizado: valor de 'inicio' en la última sincronización. Las
+*													posiciones liberadas después no se reutilizan hasta
+*													la siguiente sincronización, ya que tras una
+*													recuperación sus valores se vuelven a entregar
+*		- finalSincronizado: valor de 'final' en la última sincronización. Los
+*												 valores de las posiciones posteriores aún no han
+*												 sido llevados a disco
+*		- secuencia: número de secuencia del último registro de posición escrito
+*		- operaciones: inserciones y extracciones desde la última sincronización
+*		- intervalo: número de operaciones tras el cual se sincroniza
+*								 automáticamente. Con 0 solo se sincroniza con
+*								 'sincronizarBufferPersistente'
+*
+* El TAD no utiliza mutexes: al igual que el TAD Buffer, sus funciones se deben
+* llamar en exclusión mutua.
+*/
+struct ST_CABECERAPERSISTENTE;
+
+typedef struct ST_BUFFERPERSISTENTE{
+	struct ST_CABECERAPERSISTENTE* cabecera;
+	int* valores;
+	size_t tamMapeo;
+	int fd;
+	int tam;
+	unsigned int mascara;
+	uint64_t inicio;
+	uint64_t final;
+	uint64_t inicioSincronizado;
+	uint64_t finalSincronizado;
+	uint64_t secuencia;
+	unsigned int operaciones;
+	unsigned int intervalo;
+} BufferPersistente;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_BUFFERPRIORIDAD
+* Cola con varios niveles de prioridad, cada uno de ellos un TAD Buffer con su
+* propio tamaño. Los productores indican la prioridad de cada inserción (0 es
+* la más alta) y los consumidores sacan siempre del nivel más prioritario que
+* tenga elementos, de forma que los elementos urgentes no esperan detrás de los
+* de menor prioridad. Dentro de un mismo nivel el orden es FIFO.
+*
+* Para no recorrer todos los niveles en cada extracción, 'ocupados' tiene un
+* bit por nivel que el productor activa tras insertar en él. El consumidor
+* obtiene el nivel más prioritario con una única instrucción (contar los ceros
+* finales) y solo desactiva el bit cuando encuentra el nivel vacío, tras lo que
+* lo vuelve a comprobar: si un productor ha insertado mientras tanto, el bit se
+* activa de nuevo y el elemento no queda oculto.
+* Campos:
+*		- niveles: array de 'numNiveles' buffers, del más al menos prioritario
+*		- numNiveles: número de niveles de prioridad, entre 1 y
+*									BUFFER_MAX_NIVELES
+*		- ocupados: bit 'i' activo si el nivel 'i' puede tener elementos
+*		- producciones: igual que en el TAD Buffer
+*
+* Al igual que en el TAD Buffer, las inserciones se deben realizar en exclusión
+* mutua entre productores y las extracciones en exclusión mutua entre
+* consumidores.
+*/
+#define BUFFER_MAX_NIVELES 32
+
+typedef struct ST_BUFFERPRIORIDAD{
+	Buffer* niveles;
+	int numNiveles;
+	_Atomic uint32_t ocupados;
+	int producciones;
+} BufferPrioridad;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_BUFFERSEGMENTADO
+* Cola sin tamaño máximo formada por una lista enlazada de segmentos de
+* BUFFER_TAM_SEGMENTO elementos. Cuando el segmento en el que escriben los
+* productores se llena se enlaza uno nuevo a continuación, y cuando los
+* consumidores terminan de leer un segmento lo devuelven a una reserva de
+* segmentos libres de la que los productores toman los siguientes. Así la cola
+* crece sin copiar los elementos que ya contiene y, una vez alcanzado el tamaño
+* de trabajo, no se reserva más memoria.
+*
+* Opcionalmente se puede indicar un límite de elementos a partir del cual
+* 'colaLlenaSegmentado' indica que la cola está llena, de forma que los
+* productores que lo consulten esperen antes de insertar. El límite es
+* orientativo: las inserciones nunca fallan por él, por lo que un lote empezado
+* por debajo del límite se inserta completo aunque lo supere.
+* Campos:
+*		- cola: segmento en el que escriben los productores
+*		- final: número de elementos insertados desde la creación del buffer
+*		- segmentos: número de segmentos reservados
+*		- cabeza: segmento del que leen los consumidores
+*		- inicio: número de elementos sacados desde la creación del buffer
+*		- libres: pila de segmentos que los consumidores han terminado de leer.
+*							Los consumidores apilan y los productores desapilan sin
+*							mutexes
+*		- limite: número de elementos a partir del cual la cola se considera
+*							llena. Con 0 no hay límite
+*		- producciones: igual que en el TAD Buffer
+*
+* El elemento número 'k' se encuentra en la posición 'k % BUFFER_TAM_SEGMENTO'
+* de su segmento, y los productores y consumidores cambian de segmento cuando
+* su contador es múltiplo del tamaño del segmento. Al igual que en el TAD
+* Buffer, las inserciones se deben realizar en exclusión mutua entre
+* productores y las extracciones en exclusión mutua entre consumidores.
+*/
+#define BUFFER_TAM_SEGMENTO 256
+
+struct ST_SEGMENTO;
+
+typedef struct ST_BUFFERSEGMENTADO{
+	ALINEACION_BUFFER struct ST_SEGMENTO* cola;
+	_Atomic uint64_t final;
+	int segmentos;
+
+	ALINEACION_BUFFER struct ST_SEGMENTO* cabeza;
+	_Atomic uint64_t inicio;
+
+	ALINEACION_BUFFER struct ST_SEGMENTO* _Atomic libres;
+	unsigned int limite;
+	int producciones;
+} BufferSegmentado;
+
 /*
 * ---------------------------MODIFICACIÓN DE VARIABLES--------------------------
-*	- Variable  inicio: el entero apuntado por 'inicio' puede verse modificado en
-*											la función 'sacarBuffer'
+*	- Variable  inicio: el contador 'inicio' se incrementa en la función
+*											'sacarBuffer'
 *
-*	- Variable   final: el entero apuntado por 'final' puede verse modificado en
-*											la función 'insertarBuffer'
+*	- Variable   final: el contador 'final' se incrementa en la función
+*											'insertarBuffer'
 *
 *	- Array de valores: los enteros del array pueden ser modificados mediante
 *											las funciones 'insertarBuffer' y 'sacarBuffer', pudiendo
@@ -45,9 +331,6 @@ typedef struct ST_BUFFER{
 *	- Producciones    : el número de producciones que quedan por consumir se
 *											puede modificar con la función 'incrementarProducciones'
 *											indicando un incremento en concreto.
-*
-* - numElementos    : el número de elementos del buffer se modifica en las
-*											funciones 'sacarBuffer' e 'insertarBuffer'
 */
 
 
@@ -56,6 +339,9 @@ typedef struct ST_BUFFER{
 * Tipo: constructor
 * Constructor del buffer a partir del tamaño de este.
 *
+* Si el tamaño es potencia de dos, las posiciones se calculan con una máscara
+* en lugar de con una división, por lo que es el tamaño recomendado.
+*
 * Precondición : el tamaño indicado debe ser mayor a 0
 * Postcondición: el usuario recibe una variable tipo Buffer del tamaño indicado
 *								 cuyos valores están vacíos.
@@ -69,8 +355,8 @@ Buffer crearBuffer(unsigned int tam);
 *
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
 * Postcondición: la memoria reservada para los valores del Buffer es liberada.
-*								 La variable 'valores' se pone a NULL, el resto de variables del
-*								 buffer quedan establecidas a -1.
+*								 La variable 'valores' se pone a NULL, los contadores a 0 y el
+*								 resto de variables del buffer quedan establecidas a -1.
 */
 void destruirBuffer(Buffer* buf);
 
@@ -102,6 +388,9 @@ void insertarBuffer(Buffer* buffer, int valor);
 *
 * Tiempo añadido de inserción: MAX(0, tiempo)
 *
+* Si se llama dentro de una región crítica, el tiempo se añade a la misma. Es
+* preferible realizar el trabajo antes de insertar o después de sacar.
+*
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
 *	Postcondición: se pueden dar los siguientes escenarios principales:
 *					- Se inserta el valor en la primera posición libre del Buffer y la
@@ -142,6 +431,9 @@ int sacarBuffer(Buffer* buffer);
 *
 * Tiempo añadido de eliminación: MAX(0, tiempo)
 *
+* Si se llama dentro de una región crítica, el tiempo se añade a la misma. Es
+* preferible realizar el trabajo antes de insertar o después de sacar.
+*
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
 *								 El buffer no se encuentra vacío.
 * Postcondición: se pueden dar los siguientes escenarios princiales:
@@ -152,6 +444,41 @@ int sacarBuffer(Buffer* buffer);
 */
 int sacarBufferTime(Buffer* buffer, int tiempo);
 
+/*
+* Nombre: insertarBufferN
+* Tipo: modificador
+* Función que inserta en el buffer, en orden, los 'n' valores del array
+* indicado, o tantos como quepan en caso de que no haya sitio para todos. La
+* copia se realiza en como mucho dos bloques, partiendo el array en el punto en
+* el que la cola circular vuelve a la posición 0.
+*
+* Tiempo añadido de inserción: 0
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
+*								 El array 'valores' tiene al menos 'n' elementos.
+*	Postcondición: se devuelve el número de valores insertados, entre 0 y 'n',
+*								 y la variable 'final' se ve incrementada en ese número.
+*/
+int insertarBufferN(Buffer* buffer, const int* valores, int n);
+
+/*
+* Nombre: sacarBufferN
+* Tipo: modificador
+* Función que saca del buffer hasta 'n' elementos, en el orden en el que fueron
+* insertados, y los copia en el array indicado. Al igual que en la inserción,
+* la copia se realiza en como mucho dos bloques.
+*
+* A diferencia de 'sacarBuffer', las posiciones liberadas no se marcan con -1.
+*
+* Tiempo añadido de eliminación: 0
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
+*								 El array 'valores' tiene sitio para al menos 'n' elementos.
+* Postcondición: se devuelve el número de valores sacados, entre 0 y 'n', y la
+*								 variable 'inicio' se ve incrementada en ese número.
+*/
+int sacarBufferN(Buffer* buffer, int* valores, int n);
+
 /*
 * Nombre: tamano
 * Tipo: consulta
@@ -160,7 +487,7 @@ int sacarBufferTime(Buffer* buffer, int tiempo);
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
 * Postcondición: le es devuelto al usuario el tamaño del buffer.
 */
-int tamano(Buffer buffer);
+int tamano(const Buffer* buffer);
 
 /*
 * Nombre: valores
@@ -170,7 +497,7 @@ int tamano(Buffer buffer);
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
 * Postcondición: le es devuelto al usuario el array de valores del buffer.
 */
-int* valores(Buffer buffer);
+int* valores(const Buffer* buffer);
 
 /*
 * Nombre: obtenerProducciones
@@ -182,7 +509,7 @@ int* valores(Buffer buffer);
 * Postcondición: le es devuelto al usuario el número de producciones que quedan
 *								 por consumir
 */
-int obtenerProducciones(Buffer buffer);
+int obtenerProducciones(const Buffer* buffer);
 
 /*
 * Nombre: incrementarProducciones
@@ -200,6 +527,73 @@ int obtenerProducciones(Buffer buffer);
 */
 void incrementarProducciones(Buffer* buffer, int incremento);
 
+/*
+* Nombre: registrarProductores
+* Tipo: modificador
+* Función que añade el número indicado de productores a los que el buffer debe
+* esperar antes de cerrarse. Cada productor registrado debe llamar una vez a
+* 'terminarProductor' cuando haya insertado todos sus elementos.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+*								 y ninguno de los productores registrados puede haber empezado
+*								 a insertar
+* Postcondición: el número de productores activos se ve incrementado en
+*								 'numProductores'
+*/
+void registrarProductores(Buffer* buffer, int numProductores);
+
+/*
+* Nombre: terminarProductor
+* Tipo: modificador
+* Función que indica que uno de los productores registrados ya ha insertado
+* todos sus elementos. El último productor en terminar cierra el buffer, y es
+* quien debe despertar a todos los consumidores que esperan, ya que ninguna
+* inserción posterior lo hará.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+*								 y el productor debe estar registrado
+* Postcondición: se devuelve 1 si era el último productor activo y el buffer ha
+*								 quedado cerrado, y 0 en caso contrario
+*/
+int terminarProductor(Buffer* buffer);
+
+/*
+* Nombre: cerrarBuffer
+* Tipo: modificador
+* Función que cierra el buffer sin esperar a los productores, por ejemplo para
+* detener el programa. Los elementos ya insertados se pueden seguir sacando.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+* Postcondición: el buffer queda cerrado
+*/
+void cerrarBuffer(Buffer* buffer);
+
+/*
+* Nombre: bufferCerrado
+* Tipo: consulta
+* Función que devuelve un 1 si el buffer está cerrado y un 0 en caso contrario.
+*
+* Todas las inserciones anteriores al cierre son visibles para el hilo que ve
+* el buffer cerrado, por lo que si después lo ve vacío ya no quedan elementos.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+* Postcondición: el valor devuelto es un 1 si el buffer está cerrado
+*/
+int bufferCerrado(const Buffer* buffer);
+
+/*
+* Nombre: bufferAgotado
+* Tipo: consulta
+* Función que devuelve un 1 si el buffer está cerrado y vacío, es decir, si un
+* consumidor ya no va a poder sacar ningún elemento, y un 0 en caso contrario.
+*
+* Solo debe ser llamada por los consumidores, ya que utiliza 'colaVacia'.
+*
+* Precondición : el buffer debe haber sido creado con la función 'crearBuffer'
+* Postcondición: el valor devuelto es un 1 si el buffer está cerrado y vacío
+*/
+int bufferAgotado(Buffer* buffer);
+
 /*
 * Nombre: imprimirBuffer
 * Tipo: consulta
@@ -211,7 +605,7 @@ void incrementarProducciones(Buffer* buffer, int incremento);
 *								 ocurrencia de carreras críticas en esta función.
 * Postcondición: se imprime por pantalla los valores insertados en el buffer.
 */
-void imprimirBuffer(Buffer buffer);
+void imprimirBuffer(const Buffer* buffer);
 
 /*
 * Nombre: colaVacia
@@ -219,11 +613,14 @@ void imprimirBuffer(Buffer buffer);
 * Función que devuelve un 1 en caso de que el buffer pasado por parámetro se
 * encuentre vacío y un 0 en caso contrario.
 *
+* Solo debe ser llamada por los consumidores, ya que actualiza su copia del
+* contador 'final' cuando el buffer parece vacío.
+*
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
 * Postcondición: el valor devuelto es un 1 si el buffer está vacío, en caso
 *								 contrario, el valor de retorno es 0.
 */
-int colaVacia(Buffer buffer);
+int colaVacia(Buffer* buffer);
 
 /*
 * Nombre: colaLlena
@@ -231,11 +628,14 @@ int colaVacia(Buffer buffer);
 * Función que devuelve un 1 en caso de que el buffer pasado por parámetro se
 * encuentre lleno y un 0 en caso contrario.
 *
+* Solo debe ser llamada por los productores, ya que actualiza su copia del
+* contador 'inicio' cuando el buffer parece lleno.
+*
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
 * Postcondición: el valor devuelto es un 1 si el buffer está lleno, en caso
 *								 contrario, el valor de retorno es 0.
 */
-int colaLlena(Buffer buffer);
+int colaLlena(Buffer* buffer);
 
 /*
 * Nombre: numElementos
@@ -245,6 +645,577 @@ int colaLlena(Buffer buffer);
 * Precondición : el buffer debe haber sido creado con la función 'crearBuffer'.
 * Postcondición: se devuelve el número de elementos del buffer
 */
-int numElementos(Buffer buffer);
+int numElementos(const Buffer* buffer);
+
+/*
+* Nombre: crearBufferSPSC
+* Tipo: constructor
+* Constructor del buffer de un único productor y un único consumidor a partir
+* del tamaño de este.
+*
+* Precondición : el tamaño indicado debe ser mayor a 0
+* Postcondición: el usuario recibe una variable tipo BufferSPSC del tamaño
+*								 indicado cuyos valores están vacíos.
+*/
+BufferSPSC crearBufferSPSC(unsigned int tam);
+
+/*
+* Nombre: destruirBufferSPSC
+* Tipo: destructor
+* Destructor del buffer SPSC, liberando los recursos correspondientes
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSPSC' y
+*								 ningún hilo debe estar usándolo.
+* Postcondición: la memoria reservada para los valores del buffer es liberada y
+*								 la variable 'valores' se pone a NULL.
+*/
+void destruirBufferSPSC(BufferSPSC* buf);
+
+/*
+* Nombre: insertarBufferSPSC
+* Tipo: modificador
+* Función que inserta el valor indicado al final del buffer sin utilizar
+* ningún mutex. La publicación del valor se hace con semántica 'release', por
+* lo que el consumidor que lo observe verá también el valor escrito.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSPSC'. Solo
+*								 un hilo (el productor) puede llamar a esta función.
+* Postcondición: se devuelve un 1 si el valor ha sido insertado y un 0 en caso
+*								 de que el buffer estuviese lleno, descartándose la inserción.
+*/
+int insertarBufferSPSC(BufferSPSC* buffer, int valor);
+
+/*
+* Nombre: sacarBufferSPSC
+* Tipo: modificador
+* Función que saca el primer elemento del buffer sin utilizar ningún mutex,
+* almacenándolo en la variable apuntada por 'valor'.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSPSC'. Solo
+*								 un hilo (el consumidor) puede llamar a esta función.
+* Postcondición: se devuelve un 1 si se ha sacado un valor y un 0 en caso de
+*								 que el buffer estuviese vacío, sin modificar 'valor'.
+*/
+int sacarBufferSPSC(BufferSPSC* buffer, int* valor);
+
+/*
+* Nombre: numElementosSPSC
+* Tipo: consulta
+* Función que devuelve el número de elementos que actualmente están en el
+* buffer SPSC. Al consultarse sin exclusión mutua, el valor es orientativo si
+* el productor o el consumidor están operando a la vez.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSPSC'.
+* Postcondición: se devuelve el número de elementos del buffer
+*/
+int numElementosSPSC(BufferSPSC* buffer);
+
+/*
+* ------------------------------TAD BUFFER GENÉRICO-----------------------------
+* Las funciones 'reservarHueco', 'confirmarHueco', 'adquirirHueco' y
+* 'liberarHueco' deben llamarse en exclusión mutua, igual que las del TAD
+* Buffer, pero el contenido del hueco se escribe o se lee fuera de ella:
+*
+*		lock; hueco = reservarHueco(&buf); unlock;
+*		escribir el elemento en 'hueco';
+*		lock; confirmarHueco(&buf, hueco); unlock;
+*
+* Los huecos se entregan a los consumidores en el orden en el que fueron
+* reservados, aunque se confirmen en otro orden.
+*/
+
+/*
+* Nombre: crearBufferGenerico
+* Tipo: constructor
+* Constructor del buffer genérico a partir del número de huecos y del tamaño en
+* bytes de cada uno de ellos.
+*
+* Precondición : el número de huecos y el tamaño deben ser mayores a 0
+* Postcondición: el usuario recibe una variable tipo BufferGenerico con todos
+*								 sus huecos libres.
+*/
+BufferGenerico crearBufferGenerico(unsigned int tam, size_t tamElemento);
+
+/*
+* Nombre: destruirBufferGenerico
+* Tipo: destructor
+* Destructor del buffer genérico, liberando los recursos correspondientes
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferGenerico' y
+*								 ningún hilo debe estar usando sus huecos.
+* Postcondición: la memoria reservada para los huecos es liberada y las
+*								 variables 'datos' y 'estados' se ponen a NULL.
+*/
+void destruirBufferGenerico(BufferGenerico* buf);
+
+/*
+* Nombre: reservarHueco
+* Tipo: modificador
+* Función que reserva el siguiente hueco libre del buffer para que el productor
+* escriba en él un elemento.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferGenerico'.
+* Postcondición: se devuelve un puntero a los 'tamElemento' bytes del hueco
+*								 reservado, o NULL en caso de que el buffer esté lleno.
+*/
+void* reservarHueco(BufferGenerico* buffer);
+
+/*
+* Nombre: confirmarHueco
+* Tipo: modificador
+* Función que marca como escrito un hueco reservado, haciéndolo visible para
+* los consumidores junto con el resto de huecos confirmados que lo siguen.
+*
+* Precondición : 'hueco' ha sido devuelto por 'reservarHueco' sobre el mismo
+*								 buffer y no ha sido confirmado todavía.
+* Postcondición: el hueco queda confirmado y el contador 'publicado' avanza
+*								 sobre todos los huecos confirmados consecutivos.
+*/
+void confirmarHueco(BufferGenerico* buffer, void* hueco);
+
+/*
+* Nombre: adquirirHueco
+* Tipo: modificador
+* Función que entrega al consumidor el primer hueco confirmado que no haya sido
+* adquirido todavía, para que lea el elemento directamente de él.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferGenerico'.
+* Postcondición: se devuelve un puntero al hueco adquirido, o NULL en caso de
+*								 que no haya huecos confirmados pendientes.
+*/
+void* adquirirHueco(BufferGenerico* buffer);
+
+/*
+* Nombre: liberarHueco
+* Tipo: modificador
+* Función que devuelve a los productores un hueco adquirido una vez que el
+* consumidor ha terminado de leerlo.
+*
+* Precondición : 'hueco' ha sido devuelto por 'adquirirHueco' sobre el mismo
+*								 buffer y no ha sido liberado todavía.
+* Postcondición: el hueco queda liberado y el contador 'liberado' avanza sobre
+*								 todos los huecos liberados consecutivos.
+*/
+void liberarHueco(BufferGenerico* buffer, void* hueco);
+
+/*
+* Nombre: numElementosGenerico
+* Tipo: consulta
+* Función que devuelve el número de huecos confirmados que todavía no han sido
+* adquiridos por ningún consumidor.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferGenerico'.
+* Postcondición: se devuelve el número de elementos disponibles
+*/
+int numElementosGenerico(BufferGenerico* buffer);
+
+/*
+* Nombre: huecosLibres
+* Tipo: consulta
+* Función que devuelve el número de huecos que se pueden reservar.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferGenerico'.
+* Postcondición: se devuelve el número de huecos libres
+*/
+int huecosLibres(BufferGenerico* buffer);
+
+/*
+* ----------------------------TAD BUFFER COMPARTIDO-----------------------------
+* Un proceso crea el segmento con 'crearBufferCompartido' y el resto se unen a
+* él con 'abrirBufferCompartido' indicando el mismo nombre. Las inserciones y
+* extracciones bloquean al proceso mientras la cola esté llena o vacía, y se
+* realizan en exclusión mutua con el mutex del segmento, que es robusto: si un
+* proceso termina con el mutex bloqueado, el siguiente que lo obtiene lo
+* recupera, ya que los contadores solo se actualizan al final de cada
+* operación.
+*/
+
+/*
+* Nombre: crearBufferCompartido
+* Tipo: constructor
+* Constructor del buffer compartido a partir del nombre del segmento (por
+* ejemplo "/buffer") y del tamaño de la cola.
+*
+* Precondición : el tamaño indicado debe ser mayor a 0 y no debe existir otro
+*								 segmento con el mismo nombre
+* Postcondición: el usuario recibe un BufferCompartido vacío y sin producciones
+*								 pendientes, o con 'cabecera' a NULL en caso de error (en
+*								 'errno' queda la causa)
+*/
+BufferCompartido crearBufferCompartido(const char* nombre, unsigned int tam);
+
+/*
+* Nombre: abrirBufferCompartido
+* Tipo: constructor
+* Función que proyecta en el proceso un buffer compartido ya creado, esperando
+* a que el proceso que lo crea termine de iniciarlo.
+*
+* Precondición : ninguna
+* Postcondición: el usuario recibe el BufferCompartido con el nombre indicado,
+*								 o con 'cabecera' a NULL en caso de que no exista o no haya
+*								 sido creado con 'crearBufferCompartido'
+*/
+BufferCompartido abrirBufferCompartido(const char* nombre);
+
+/*
+* Nombre: cerrarBufferCompartido
+* Tipo: destructor
+* Función que elimina la proyección del buffer compartido en el proceso. El
+* segmento sigue existiendo para el resto de procesos.
+*
+* Precondición : ningún hilo del proceso está utilizando el buffer
+* Postcondición: 'cabecera' se pone a NULL
+*/
+void cerrarBufferCompartido(BufferCompartido* buf);
+
+/*
+* Nombre: eliminarBufferCompartido
+* Tipo: destructor
+* Función que elimina el nombre del segmento. Los procesos que lo tienen
+* proyectado pueden seguir usándolo, y la memoria se libera cuando lo cierra
+* el último de ellos.
+*
+* Precondición : ninguna
+* Postcondición: se devuelve 0 si el segmento se ha eliminado y -1 en caso
+*								 contrario
+*/
+int eliminarBufferCompartido(const char* nombre);
+
+/*
+* Nombre: insertarBufferCompartido
+* Tipo: modificador
+* Función que inserta en orden los 'n' valores del array indicado, o tantos
+* como quepan, durmiendo al proceso mientras la cola esté llena.
+*
+* Precondición : el buffer debe haber sido creado o abierto. El array 'valores'
+*								 tiene al menos 'n' elementos
+* Postcondición: se devuelve el número de valores insertados, entre 1 y 'n'
+*								 (0 si 'n' no es positivo)
+*/
+int insertarBufferCompartido(BufferCompartido* buffer, const int* valores,
+		int n);
+
+/*
+* Nombre: sacarBufferCompartido
+* Tipo: modificador
+* Función que saca hasta 'n' elementos en el orden en el que fueron insertados
+* y los copia en el array indicado, durmiendo al proceso mientras la cola esté
+* vacía. Los elementos sacados se descuentan de las producciones pendientes, y
+* cuando estas llegan a 0 se despierta al resto de consumidores.
+*
+* Precondición : el buffer debe haber sido creado o abierto. El array 'valores'
+*								 tiene sitio para al menos 'n' elementos
+* Postcondición: se devuelve el número de valores sacados, entre 1 y 'n', o 0
+*								 en caso de que no queden producciones pendientes
+*/
+int sacarBufferCompartido(BufferCompartido* buffer, int* valores, int n);
+
+/*
+* Nombre: incrementarProduccionesCompartido
+* Tipo: modificador
+* Función que incrementa el número de producciones pendientes del buffer
+* compartido, igual que 'incrementarProducciones'. Se debe llamar antes de
+* que los consumidores empiecen a sacar elementos.
+*
+* Precondición : el buffer debe haber sido creado o abierto
+* Postcondición: el número de producciones se ve incrementado, sin bajar de 0
+*/
+void incrementarProduccionesCompartido(BufferCompartido* buffer,
+		int incremento);
+
+/*
+* Nombre: numElementosCompartido
+* Tipo: consulta
+* Función que devuelve el número de elementos que actualmente están en el
+* buffer compartido. El valor es orientativo si otros procesos están operando
+* a la vez.
+*
+* Precondición : el buffer debe haber sido creado o abierto
+* Postcondición: se devuelve el número de elementos del buffer
+*/
+int numElementosCompartido(const BufferCompartido* buffer);
+
+/*
+* ----------------------------TAD BUFFER PERSISTENTE----------------------------
+*/
+
+/*
+* Nombre: abrirBufferPersistente
+* Tipo: constructor
+* Función que proyecta el fichero indicado como buffer persistente. Si el
+* fichero no existe se crea con el tamaño indicado; si existe se recupera con
+* 'recuperarBufferPersistente' y se utiliza el tamaño con el que fue creado.
+*
+* Precondición : el tamaño indicado debe ser mayor a 0. Ningún otro proceso
+*								 tiene abierto el fichero
+* Postcondición: el usuario recibe el BufferPersistente, o con 'cabecera' a
+*								 NULL en caso de error (en 'errno' queda la causa)
+*/
+BufferPersistente abrirBufferPersistente(const char* ruta, unsigned int tam,
+		unsigned int intervalo);
+
+/*
+* Nombre: recuperarBufferPersistente
+* Tipo: modificador
+* Función que devuelve el buffer a la última posición sincronizada: se elige el
+* registro de posición válido con mayor número de secuencia y se descartan las
+* inserciones y extracciones posteriores.
+*
+* Precondición : el buffer debe haber sido abierto con 'abrirBufferPersistente'
+* Postcondición: se devuelve 0 si se ha encontrado un registro válido y -1 si
+*								 no, en cuyo caso el buffer queda vacío
+*/
+int recuperarBufferPersistente(BufferPersistente* buf);
+
+/*
+* Nombre: sincronizarBufferPersistente
+* Tipo: modificador
+* Función que lleva a disco los valores insertados y la posición actual del
+* buffer, en ese orden.
+*
+* Precondición : el buffer debe haber sido abierto con 'abrirBufferPersistente'
+* Postcondición: se devuelve 0 si el estado actual es persistente y -1 en caso
+*								 de error
+*/
+int sincronizarBufferPersistente(BufferPersistente* buf);
+
+/*
+* Nombre: cerrarBufferPersistente
+* Tipo: destructor
+* Función que sincroniza el buffer y elimina su proyección.
+*
+* Precondición : el buffer debe haber sido abierto con 'abrirBufferPersistente'
+* Postcondición: 'cabecera' y 'valores' se ponen a NULL
+*/
+void cerrarBufferPersistente(BufferPersistente* buf);
+
+/*
+* Nombre: insertarBufferPersistenteN
+* Tipo: modificador
+* Función que inserta en orden los 'n' valores del array indicado, o tantos
+* como quepan, igual que 'insertarBufferN'. Si para ello es necesario reutilizar
+* posiciones liberadas después de la última sincronización, primero se
+* sincroniza el buffer.
+*
+* Precondición : el buffer debe haber sido abierto con 'abrirBufferPersistente'
+* Postcondición: se devuelve el número de valores insertados, entre 0 y 'n'
+*/
+int insertarBufferPersistenteN(BufferPersistente* buffer, const int* valores,
+		int n);
+
+/*
+* Nombre: sacarBufferPersistenteN
+* Tipo: modificador
+* Función que saca hasta 'n' elementos y los copia en el array indicado, igual
+* que 'sacarBufferN'.
+*
+* Precondición : el buffer debe haber sido abierto con 'abrirBufferPersistente'
+* Postcondición: se devuelve el número de valores sacados, entre 0 y 'n'
+*/
+int sacarBufferPersistenteN(BufferPersistente* buffer, int* valores, int n);
+
+/*
+* Nombre: numElementosPersistente
+* Tipo: consulta
+* Función que devuelve el número de elementos del buffer persistente.
+*
+* Precondición : el buffer debe haber sido abierto con 'abrirBufferPersistente'
+* Postcondición: se devuelve el número de elementos del buffer
+*/
+int numElementosPersistente(const BufferPersistente* buffer);
+
+/*
+* Nombre: crearBufferPrioridad
+* Tipo: constructor
+* Constructor del buffer con prioridades a partir del número de niveles y del
+* tamaño de cada uno de ellos.
+*
+* Precondición : el tamaño indicado debe ser mayor a 0 y el número de niveles
+*								 debe estar entre 1 y BUFFER_MAX_NIVELES
+* Postcondición: el usuario recibe una variable tipo BufferPrioridad con todos
+*								 sus niveles vacíos
+*/
+BufferPrioridad crearBufferPrioridad(unsigned int tam, int numNiveles);
+
+/*
+* Nombre: destruirBufferPrioridad
+* Tipo: destructor
+* Función que libera los buffers de todos los niveles.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferPrioridad'
+* Postcondición: 'niveles' se pone a NULL y 'numNiveles' a 0
+*/
+void destruirBufferPrioridad(BufferPrioridad* buf);
+
+/*
+* Nombre: insertarBufferPrioridadN
+* Tipo: modificador
+* Función que inserta en orden en el nivel de la prioridad indicada los 'n'
+* valores del array, o tantos como quepan en ese nivel, igual que
+* 'insertarBufferN'.
+*
+* Precondición : la prioridad debe estar entre 0 y 'numNiveles - 1'
+* Postcondición: se devuelve el número de valores insertados, entre 0 y 'n'
+*/
+int insertarBufferPrioridadN(BufferPrioridad* buffer, const int* valores,
+		int n, int prioridad);
+
+/*
+* Nombre: insertarBufferPrioridad
+* Tipo: modificador
+* Función que inserta un único valor con la prioridad indicada.
+*
+* Precondición : la prioridad debe estar entre 0 y 'numNiveles - 1'
+* Postcondición: se devuelve 1 si el valor se ha insertado y 0 si el nivel de
+*								 esa prioridad está lleno
+*/
+int insertarBufferPrioridad(BufferPrioridad* buffer, int valor, int prioridad);
+
+/*
+* Nombre: sacarBufferPrioridadN
+* Tipo: modificador
+* Función que saca hasta 'n' elementos del nivel más prioritario que tenga
+* elementos y los copia en el array indicado. Todos los elementos sacados en
+* una llamada tienen la misma prioridad, por lo que un lote nunca adelanta
+* elementos menos prioritarios a otros más prioritarios.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferPrioridad'
+* Postcondición: se devuelve el número de valores sacados, entre 0 y 'n'. Si
+*								 'prioridad' no es NULL, en ella se devuelve la prioridad
+*								 de los valores sacados
+*/
+int sacarBufferPrioridadN(BufferPrioridad* buffer, int* valores, int n,
+		int* prioridad);
+
+/*
+* Nombre: colaLlenaPrioridad
+* Tipo: consulta
+* Función que indica si el nivel de la prioridad indicada está lleno.
+*
+* Precondición : la prioridad debe estar entre 0 y 'numNiveles - 1'
+* Postcondición: se devuelve 1 si está lleno y 0 en caso contrario
+*/
+int colaLlenaPrioridad(BufferPrioridad* buffer, int prioridad);
+
+/*
+* Nombre: colaVaciaPrioridad
+* Tipo: consulta
+* Función que indica si todos los niveles del buffer están vacíos.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferPrioridad'
+* Postcondición: se devuelve 1 si están vacíos y 0 en caso contrario
+*/
+int colaVaciaPrioridad(BufferPrioridad* buffer);
+
+/*
+* Nombre: numElementosPrioridad
+* Tipo: consulta
+* Función que devuelve el número total de elementos de todos los niveles.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferPrioridad'
+* Postcondición: se devuelve el número de elementos del buffer
+*/
+int numElementosPrioridad(const BufferPrioridad* buffer);
+
+/*
+* Nombre: obtenerProduccionesPrioridad e incrementarProduccionesPrioridad
+* Tipo: consulta y modificador
+* Funciones equivalentes a 'obtenerProducciones' e 'incrementarProducciones'.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferPrioridad'
+* Postcondición: se devuelve o se modifica el número de producciones pendientes
+*/
+int obtenerProduccionesPrioridad(const BufferPrioridad* buffer);
+void incrementarProduccionesPrioridad(BufferPrioridad* buffer, int incremento);
+
+/*
+* Nombre: crearBufferSegmentado
+* Tipo: constructor
+* Constructor del buffer segmentado, con un único segmento vacío y el límite
+* orientativo indicado (0 si no se desea límite).
+*
+* Precondición : ninguna
+* Postcondición: el usuario recibe una variable tipo BufferSegmentado vacía, o
+*								 con 'cola' a NULL si no se ha podido reservar memoria
+*/
+BufferSegmentado crearBufferSegmentado(unsigned int limite);
+
+/*
+* Nombre: destruirBufferSegmentado
+* Tipo: destructor
+* Función que libera todos los segmentos del buffer, incluidos los de la
+* reserva.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSegmentado'
+* Postcondición: 'cola' y 'cabeza' se ponen a NULL
+*/
+void destruirBufferSegmentado(BufferSegmentado* buf);
+
+/*
+* Nombre: insertarBufferSegmentadoN
+* Tipo: modificador
+* Función que inserta en orden los 'n' valores del array indicado, enlazando
+* los segmentos que sean necesarios. No tiene en cuenta el límite.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSegmentado'
+* Postcondición: se devuelve el número de valores insertados, que solo es menor
+*								 que 'n' si no se ha podido reservar un segmento
+*/
+int insertarBufferSegmentadoN(BufferSegmentado* buffer, const int* valores,
+		int n);
+
+/*
+* Nombre: sacarBufferSegmentadoN
+* Tipo: modificador
+* Función que saca hasta 'n' elementos y los copia en el array indicado,
+* devolviendo a la reserva los segmentos que termina de leer.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSegmentado'
+* Postcondición: se devuelve el número de valores sacados, entre 0 y 'n'
+*/
+int sacarBufferSegmentadoN(BufferSegmentado* buffer, int* valores, int n);
+
+/*
+* Nombre: colaLlenaSegmentado
+* Tipo: consulta
+* Función que indica si la cola ha alcanzado su límite orientativo.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSegmentado'
+* Postcondición: se devuelve 1 si hay límite y el número de elementos lo
+*								 alcanza, y 0 en caso contrario
+*/
+int colaLlenaSegmentado(const BufferSegmentado* buffer);
+
+/*
+* Nombre: colaVaciaSegmentado
+* Tipo: consulta
+* Función que indica si la cola está vacía.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSegmentado'
+* Postcondición: se devuelve 1 si está vacía y 0 en caso contrario
+*/
+int colaVaciaSegmentado(const BufferSegmentado* buffer);
+
+/*
+* Nombre: numElementosSegmentado
+* Tipo: consulta
+* Función que devuelve el número de elementos de la cola.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSegmentado'
+* Postcondición: se devuelve el número de elementos del buffer
+*/
+int numElementosSegmentado(const BufferSegmentado* buffer);
+
+/*
+* Nombre: obtenerProduccionesSegmentado e incrementarProduccionesSegmentado
+* Tipo: consulta y modificador
+* Funciones equivalentes a 'obtenerProducciones' e 'incrementarProducciones'.
+*
+* Precondición : el buffer debe haber sido creado con 'crearBufferSegmentado'
+* Postcondición: se devuelve o se modifica el número de producciones pendientes
+*/
+int obtenerProduccionesSegmentado(const BufferSegmentado* buffer);
+void incrementarProduccionesSegmentado(BufferSegmentado* buffer,
+		int incremento);
 
 #endif
@@ -0,0 +1,119 @@
+#ifndef HISTOGRAMA_H
+#define HISTOGRAMA_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Histograma acumula duraciones en nanosegundos en cubetas de tamaño
+* logarítmico: cada potencia de dos se divide en HISTOGRAMA_SUBCUBETAS cubetas
+* iguales, por lo que el error relativo de los percentiles es menor de
+* 1 / HISTOGRAMA_SUBCUBETAS. Registrar una duración solo incrementa contadores,
+* sin reservar memoria ni utilizar mutexes, por lo que cada hilo debe utilizar
+* sus propios histogramas y combinarlos al finalizar.
+*/
+
+// Número de cubetas en las que se divide cada potencia de dos. Debe ser
+// potencia de dos
+#define HISTOGRAMA_BITS_SUBCUBETA 3
+#define HISTOGRAMA_SUBCUBETAS (1 << HISTOGRAMA_BITS_SUBCUBETA)
+
+// Número total de cubetas necesarias para cualquier duración de 64 bits
+#define HISTOGRAMA_CUBETAS ((64 - HISTOGRAMA_BITS_SUBCUBETA + 1) * \
+		HISTOGRAMA_SUBCUBETAS)
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_HISTOGRAMA
+* Campos:
+*		- cubetas: número de duraciones registradas en cada cubeta
+*		- total: número de duraciones registradas
+*		- suma: suma de todas las duraciones registradas
+*		- maximo: mayor duración registrada
+*/
+typedef struct ST_HISTOGRAMA{
+	uint64_t cubetas[HISTOGRAMA_CUBETAS];
+	uint64_t total;
+	uint64_t suma;
+	uint64_t maximo;
+} Histograma;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: iniciarHistograma
+* Tipo: constructor
+* Función que deja el histograma indicado sin ninguna duración registrada.
+*
+* Precondición : ninguna
+* Postcondición: el histograma está vacío
+*/
+void iniciarHistograma(Histograma* histograma);
+
+/*
+* Nombre: registrarHistograma
+* Tipo: modificador
+* Función que añade la duración indicada, en nanosegundos, al histograma.
+*
+* Precondición : el histograma debe haber sido iniciado con
+*								 'iniciarHistograma' y no puede ser modificado a la vez por
+*								 otro hilo
+* Postcondición: la duración queda registrada en su cubeta
+*/
+void registrarHistograma(Histograma* histograma, uint64_t duracion);
+
+/*
+* Nombre: combinarHistograma
+* Tipo: modificador
+* Función que añade al histograma destino todas las duraciones registradas en
+* el histograma origen.
+*
+* Precondición : ambos histogramas deben haber sido iniciados
+* Postcondición: el destino contiene las duraciones de ambos histogramas
+*/
+void combinarHistograma(Histograma* destino, const Histograma* origen);
+
+/*
+* Nombre: percentilHistograma
+* Tipo: consulta
+* Función que devuelve el percentil indicado (entre 0 y 100) de las duraciones
+* registradas. Se devuelve el límite superior de la cubeta en la que se
+* encuentra, sin superar la duración máxima.
+*
+* Precondición : el histograma debe haber sido iniciado
+* Postcondición: se devuelve el percentil en nanosegundos, o 0 si el histograma
+*								 está vacío
+*/
+uint64_t percentilHistograma(const Histograma* histograma, double percentil);
+
+/*
+* Nombre: imprimirHistograma
+* Tipo: consulta
+* Función que escribe en la salida indicada una línea con el nombre, el número
+* de duraciones, la media, los percentiles 50, 99 y 99.9 y el máximo del
+* histograma, en nanosegundos.
+*
+* Precondición : el histograma debe haber sido iniciado
+* Postcondición: se escribe el resumen del histograma
+*/
+void imprimirHistograma(FILE* salida, const char* nombre,
+		const Histograma* histograma);
+
+/*
+* Nombre: instanteMonotono
+* Tipo: consulta
+* Función que devuelve el instante actual del reloj monótono en nanosegundos,
+* para medir las duraciones a registrar.
+*/
+static inline uint64_t instanteMonotono(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#endif
@@ -3,8 +3,16 @@
 #include <pthread.h>
 #include <time.h>
 #include <string.h>
+#include <errno.h>
 #include <unistd.h>
+#include <sched.h>
 #include "buffer.h"
+#include "registro.h"
+#include "histograma.h"
+#include "evento.h"
+#include "espera.h"
+#include "configuracion.h"
+#include "afinidad.h"
 
 // Colores
 #define tblack "\E[30m" // Texto color negro
@@ -17,11 +25,78 @@
 #define reset "\E[m" // Texto color blanco
 #define fpurple "\E[45m" // Fondo color morado
 
-// Tamaño que ocupa el string de la hora
-#define TAM_HORA 9
-
-// Tamaño del Buffer
-#define TAM_BUFFER 10
+// Opciones de la línea de comandos
+#define OPCIONES "a:b:c:e:fhF:k:l:mn:p:r:s:C:P:"
+
+// Número de intentos fallidos consecutivos sobre el buffer SPSC a partir de los
+// cuales el hilo deja de ceder la CPU y pasa a dormir brevemente
+#define INTENTOS_SPSC 64
+
+// Tiempo (en microsegundos) que duerme un hilo sobre el buffer SPSC una vez
+// superados los INTENTOS_SPSC
+#define ESPERA_SPSC 100
+
+// Fases de los hilos cuya duración se mide con la opción -m
+#define FASE_REGION 0 // Espera del mutex de productores o de consumidores
+#define FASE_DESPERTAR 1 // Espera del mutex común 'mutexDespertar'
+#define FASE_CONDICION 2 // Espera en la variable de condición
+#define FASE_TRABAJO 3 // Producción o consumición de un item
+#define NUM_FASES 4
+
+struct ST_HILOPROD;
+struct ST_HILOCONS;
+
+// Tipo de las funciones de trabajo de los productores. Reciben la información
+// del hilo y devuelven el item producido. Se ejecutan fuera de la región
+// crítica, antes de reservar la posición del buffer
+typedef int (*FuncionProduccion)(struct ST_HILOPROD* hilo);
+
+// Tipo de las funciones de trabajo de los consumidores. Reciben la información
+// del hilo y el item a consumir. Se ejecutan fuera de la región crítica,
+// después de haber liberado la posición del buffer
+typedef void (*FuncionConsumicion)(struct ST_HILOCONS* hilo, int item);
+
+// Fragmento de la cola: un buffer con sus propias regiones críticas. Los hilos
+// de distintos fragmentos no compiten por ningún mutex
+typedef struct ST_FRAGMENTO{
+  // Buffer que hace la labor de cola, donde los productores del fragmento
+  // añaden sus producciones y de donde los consumidores obtienen sus
+  // consumiciones
+  Buffer buffer;
+
+  // Mutex para el acceso a la región crítica de los consumidores
+  pthread_mutex_t mutexConsum;
+
+  // Mutex para el acceso a la región crítica de los productores
+  pthread_mutex_t mutexProd;
+
+  // Mutex para las operaciones pthread_cond_wait y pthread_cond_signal, común a
+  // los dos tipos de hilos (productores y consumidores)
+  pthread_mutex_t mutexDespertar;
+
+  // Variables de condición asociadas al mutexDespertar. En 'condNoLlena'
+  // duermen los productores que encuentran la cola llena y en 'condNoVacia' los
+  // consumidores que la encuentran vacía, de forma que una señal nunca
+  // despierta a un hilo del mismo tipo que el que la envía
+  pthread_cond_t condNoLlena;
+  pthread_cond_t condNoVacia;
+
+  // Número de productores y de consumidores dormidos en sus variables de
+  // condición. Solo se modifican y consultan con el mutexDespertar bloqueado,
+  // por lo que si un hilo ve el contador a 0 no hay nadie a quien despertar y
+  // la señal se omite. Como cada hilo duerme sin liberar el mutex de su región
+  // crítica, como mucho hay un productor y un consumidor dormidos
+  int productoresEsperando;
+  int consumidoresEsperando;
+
+  // Eventos utilizados en lugar del mutexDespertar y de las variables de
+  // condición con la opción -f. En 'eventoNoLlena' esperan los productores que
+  // encuentran la cola llena y en 'eventoNoVacia' los consumidores que la
+  // encuentran vacía. Las comprobaciones de la cola y las notificaciones se
+  // realizan sin el mutexDespertar
+  Evento eventoNoLlena;
+  Evento eventoNoVacia;
+} Fragmento;
 
 // Estructura utilizada para guardar la información de los Hilos Productores.
 typedef struct ST_HILOPROD{
@@ -31,15 +106,34 @@ typedef struct ST_HILOPROD{
   // Número de hilo, autoincremental
   unsigned int id;
 
-  // Tiempo que el hilo va a tardar en realizar la producción
-  int tiempo;
+  // Tiempo (en segundos) que el hilo va a tardar en realizar la producción
+  double tiempo;
 
-  // Tiempo que esperará el hilo al salir de la región crítica. En caso de ser
-  // negativo se escogerá un aleatorio entre 0 y 4
-  int postProduccion;
+  // Tiempo (en segundos) que esperará el hilo al salir de la región crítica.
+  // En caso de ser negativo se escogerá un aleatorio entre 0 y 4
+  double postProduccion;
 
   // Número de producciones que va a realizar el hilo
   unsigned int numProducciones;
+
+  // Número máximo de producciones que el hilo inserta en el buffer en cada
+  // acceso a la región crítica
+  unsigned int lote;
+
+  // Función que produce cada uno de los items
+  FuncionProduccion producir;
+
+  // Cola en la que el hilo registra sus mensajes
+  ColaRegistro* registro;
+
+  // Duración de cada una de las fases del hilo
+  Histograma fases[NUM_FASES];
+
+  // Espera activa que realiza el hilo antes de dormir
+  EsperaActiva espera;
+
+  // Fragmento de la cola en el que el hilo inserta sus producciones
+  Fragmento* fragmento;
 } HiloProductor;
 
 // Estructura utilizada para guardar la información de los Hilos Consumidores.
@@ -50,38 +144,71 @@ typedef struct ST_HILOCONS{
   // Número de hilo, autoincremental
   unsigned int id;
 
-  // Tiempo que el hilo va a tardar en realizar la consumición
-  int tiempo;
+  // Tiempo (en segundos) que el hilo va a tardar en realizar la consumición
+  double tiempo;
+
+  // Tiempo (en segundos) que esperará el hilo al salir de la región crítica.
+  // En caso de ser negativo se escogerá un aleatorio entre 0 y 4
+  double postConsumicion;
+
+  // Número máximo de elementos que el hilo saca del buffer en cada acceso a la
+  // región crítica
+  unsigned int lote;
+
+  // Función que consume cada uno de los items
+  FuncionConsumicion consumir;
 
-  // Tiempo que esperará el hilo al salir de la región crítica. En caso de ser
-  // negativo se escogerá un aleatorio entre 0 y 4
-  int postConsumicion;
+  // Cola en la que el hilo registra sus mensajes
+  ColaRegistro* registro;
+
+  // Duración de cada una de las fases del hilo
+  Histograma fases[NUM_FASES];
+
+  // Espera activa que realiza el hilo antes de dormir
+  EsperaActiva espera;
+
+  // Fragmento de la cola del que el hilo saca sus consumiciones. Cuando lo
+  // encuentra vacío intenta robarlas de los demás fragmentos
+  Fragmento* fragmento;
 } HiloConsumidor;
 
-// Variable Buffer que hará la labor de cola, donde los productores añadirán sus
-// producciones y donde los consumidores obtendrán sus consumiciones.
-Buffer buffer;
+// Fragmentos de la cola. Con la opción -k la cola se reparte en varios
+// fragmentos y cada productor y cada consumidor tiene asignado uno propio. Sin
+// ella hay un único fragmento común a todos los hilos
+Fragmento* fragmentos;
+unsigned int numFragmentos = 1;
+
+// Buffer utilizado cuando solo hay un productor y un consumidor. En ese caso no
+// se utilizan ni el mutex ni las variables de condición
+BufferSPSC bufferSPSC;
+
+// Indica si se está utilizando el buffer SPSC en lugar de los fragmentos
+int modoSPSC = 0;
 
-// Mutex para el acceso a la región crítica de los consumidores
-pthread_mutex_t mutexConsum;
+// Indica si se mide la duración de las fases de los hilos, y nombre de cada
+// una de las fases
+int medir = 0;
+const char* nombresFases[NUM_FASES] = {"region", "despertar", "condicion",
+                                       "trabajo"};
 
-// Mutex para el acceso a la región crítica de los productores
-pthread_mutex_t mutexProd;
+// Con la opción -f los hilos duermen en los eventos de su fragmento en lugar de
+// en sus variables de condición
+int usarFutex = 0;
 
-// Mutex para las operaciones pthread_cond_wait y pthread_cond_signal, común a
-// los dos tipos de hilos (productores y consumidores)
-pthread_mutex_t mutexDespertar;
+// Número máximo de pausas que los hilos esperan activamente a que cambie el
+// estado de la cola antes de dormir. Con 0 duermen directamente
+unsigned int maximoEspera = ESPERA_MAX_DEFECTO;
 
-// Variable de condición asociada al mutexDespertar, utilizada para dormir o
-// despertar a los productores y consumidores
-pthread_cond_t condDespertar;
+// CPU en la que se ejecuta cada hilo y en cuyo nodo se ubican los buffers
+Afinidad afinidad;
 
 /*
 * Función que crea los hilos productores correspondientes a partir de la
 * información pasada por parámetro.
 *
 * La variable numProductores indica el número de productores que componen el
-* array 'hilos'
+* array 'hilos'. A cada productor se le asigna un fragmento de la cola de forma
+* rotatoria
 */
 void crearProductores(HiloProductor* hilos, unsigned int numProductores);
 
@@ -90,7 +217,8 @@ void crearProductores(HiloProductor* hilos, unsigned int numProductores);
 * información pasada por parámetro.
 *
 * La variable numConsumidores indica el número de consumidores que componen el
-* array 'hilos'
+* array 'hilos'. A cada consumidor se le asigna un fragmento de la cola de forma
+* rotatoria, por lo que todos los fragmentos tienen al menos un consumidor
 */
 void crearConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores);
 
@@ -110,6 +238,49 @@ void joinProductores(HiloProductor* hilos, unsigned int numProductores);
 */
 void joinConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores);
 
+/*
+* Función que inicia los mutexes, las variables de condición, los eventos y el
+* buffer del tamaño indicado de un fragmento
+*/
+void iniciarFragmento(Fragmento* fragmento, int tam);
+
+/*
+* Función que destruye los mutexes, las variables de condición y el buffer de
+* un fragmento una vez finalizados todos los hilos
+*/
+void destruirFragmento(Fragmento* fragmento);
+
+/*
+* Funciones que despiertan a los productores o a los consumidores dormidos en
+* el fragmento indicado después de sacar o insertar 'n' items, midiendo la
+* espera del mutexDespertar en la fase indicada. Devuelven 1 si había algún
+* hilo dormido y 0 en caso contrario
+*/
+int despertarProductores(Fragmento* fragmento, int n, Histograma* fase);
+int despertarConsumidores(Fragmento* fragmento, int n, Histograma* fase);
+
+/*
+* Función a la que llama cada productor al terminar. El último productor del
+* fragmento cierra su buffer y despierta a todos los consumidores dormidos en
+* él, ya que ninguna inserción posterior lo hará. Devuelve 1 si ha cerrado el
+* fragmento y 0 en caso contrario
+*/
+int terminarFragmento(Fragmento* fragmento);
+
+/*
+* Función con la que un consumidor que encuentra vacío su fragmento intenta
+* sacar items de los demás. Los fragmentos se recorren empezando por el
+* siguiente al propio, y solo se accede a aquellos cuya región crítica de
+* consumidores está libre (pthread_mutex_trylock), de forma que el consumidor
+* nunca espera un mutex ajeno ni mantiene dos a la vez.
+*
+* Devuelve el número de items sacados (0 si no había nada que robar) y, en
+* 'origen', 'elementos' y 'desperto', el fragmento del que se han sacado, los
+* elementos de su buffer y si se ha despertado a alguno de sus productores
+*/
+int robar(HiloConsumidor* hilo, int* items, Fragmento** origen,
+          int* elementos, int* desperto);
+
 /*
 * Función asociada a los hilos de tipo productor
 */
@@ -121,29 +292,78 @@ void productor(HiloProductor* hilo);
 void consumidor(HiloConsumidor* hilo);
 
 /*
-* Función de producción para los hilos productores. Devuelve un entero aleatorio
-* entre 0 y 9.
+* Función asociada al hilo productor cuando solo existe un productor y un
+* consumidor. Utiliza el buffer SPSC, por lo que no accede a ninguna región
+* crítica.
+*/
+void productorSPSC(HiloProductor* hilo);
+
+/*
+* Función asociada al hilo consumidor cuando solo existe un productor y un
+* consumidor. Utiliza el buffer SPSC, por lo que no accede a ninguna región
+* crítica.
+*/
+void consumidorSPSC(HiloConsumidor* hilo);
+
+/*
+* Función de espera para los hilos que operan sobre el buffer SPSC y lo han
+* encontrado lleno o vacío. Durante los primeros INTENTOS_SPSC intentos se cede
+* la CPU, y a partir de ahí se duerme ESPERA_SPSC microsegundos.
+*/
+void esperarSPSC(unsigned int* intentos);
+
+/*
+* Función que devuelve el instante en el que empieza una fase, o 0 si no se
+* están midiendo las fases de los hilos
 */
-int producir();
+uint64_t iniciarFase();
 
 /*
-* Función que modifica la cadena de caracteres pasada por argumento añadiéndole
-* la hora actual. La cadena de caracteres tiene que tener como mínimo 'TAM_HORA'
-* caracteres.
+* Función que registra en el histograma indicado la duración de la fase que
+* empezó en el instante indicado, en caso de que se estén midiendo las fases
 */
-void calcularHora(char* hora);
+void finalizarFase(Histograma* fase, uint64_t inicio);
 
 /*
-* Función para imprimir la cabecera del hilo productor indicado en un color
-* determinado.
+* Función que combina los histogramas de todos los productores y de todos los
+* consumidores e imprime los percentiles de cada fase
 */
-void imprimirCabeceraProduc(HiloProductor hilo, char* color);
+void imprimirFases(HiloProductor* productores, unsigned int numProductores,
+                   HiloConsumidor* consumidores, unsigned int numConsumidores);
 
 /*
-* Función para imprimir la cabecera del hilo consumidor indicado en un color
-* determinado.
+* Condiciones de la espera activa de productores y consumidores. Se comprueban
+* sin el mutexDespertar, por lo que solo consultan los índices atómicos del
+* buffer. Los consumidores también dejan de esperar si el buffer se cierra
 */
-void imprimirCabeceraConsum(HiloConsumidor hilo, char* color);
+int hayHueco(const void* buffer);
+int hayElementos(const void* buffer);
+
+/*
+* Función de producción por defecto para los hilos productores. Tarda el tiempo
+* de producción del hilo y devuelve un entero aleatorio entre 0 y 9.
+*/
+int producir(HiloProductor* hilo);
+
+/*
+* Función de consumición por defecto para los hilos consumidores. Tarda el
+* tiempo de consumición del hilo.
+*/
+void consumir(HiloConsumidor* hilo, int item);
+
+/*
+* Función que muestra la pregunta indicada y asigna la respuesta del usuario al
+* parámetro de la clave indicada, validándola. Si la respuesta no es válida se
+* vuelve a preguntar, y si la entrada se termina el programa finaliza
+*/
+void preguntar(Configuracion* configuracion, const char* pregunta,
+               const char* clave);
+
+/*
+* Función que duerme al hilo el número de segundos indicado, que puede tener
+* decimales. Con un tiempo no positivo vuelve inmediatamente
+*/
+void dormir(double segundos);
 
 int main(int argc, char *argv[]){
 
@@ -152,95 +372,325 @@ int main(int argc, char *argv[]){
   HiloProductor* productores;
   HiloConsumidor* consumidores;
 
+  // Parámetros de la ejecución. Se parte de los valores por defecto, que se
+  // sustituyen por los del fichero de configuración y después por los de la
+  // línea de comandos
+  Configuracion configuracion;
+
   // Variables que indican el número de productores y consumidores que se
-  // crearán, que por defecto será de 1
-  int numProductores = 1, numConsumidores = 1;
+  // crearán
+  int numProductores, numConsumidores;
+
+  // Número de elementos que se insertan o sacan en cada acceso a la región
+  // crítica
+  int lote;
+
+  // Opción procesada, resultado de su validación, número de argumentos
+  // posicionales y fichero de configuración indicado
+  int opcion;
+  int valido = 0;
+  int numArgumentos;
+  char* fichero = NULL;
+
+  // Contador
+  int i;
 
   srand(time(NULL));
 
-  // En caso de que el número de argumentos sea dos, se comprueba si lo que se
-  // está indicando es la opción de ayuda
-  if(argc == 2){
-    switch(argv[1][0]){
-      case '-':
-      // En caso de que lleve la terminación '-' se comprueba si está ejecutando
-      // el modo de ayuda
-      // Se comprueba que haya un segundo carácter en la cadena de caracteres
-      if(strlen(argv[1]) >= 2){
-        switch(argv[1][1]){
-          case 'h':
-
-          // Se imprime la ayuda al usuario y se sale de forma exitosa
-          // Se imprime la ayuda al usuario y se sale de forma exitosa
-          printf("Modo de uso: %s <numProductores> <numConsumidores> "
-                 "<defecto>\n"
-                 "\t-> defecto: se utilizan los parámetros por defecto para los"
-                      " hilos:\n"
-                      "\t\t-> Tiempo de producción: 2\n"
-                      "\t\t-> Tiempo de consumición: 1\n"
-                      "\t\t-> Tiempo de postProducción: aleatorio entre 0 y 4\n"
-                      "\t\t-> Tiempo de postConsumición: aleatorio entre 0 y 4"
-                      "\n\t\t-> Número de producciones: 10 por hilo\n"
-                      , argv[0]);
-
-          exit(EXIT_SUCCESS);
-          break;
-        }
+  iniciarConfiguracion(&configuracion);
+
+  // En una primera pasada solo se lee el fichero de configuración, de forma
+  // que el resto de opciones prevalezcan sobre él sea cual sea su orden
+  opterr = 0;
+  while((opcion = getopt(argc, argv, OPCIONES)) != -1){
+    if(opcion == 'F'){
+      fichero = optarg;
+      if(leerConfiguracion(&configuracion, fichero) != 0){
+        exit(EXIT_FAILURE);
       }
+    }
+  }
+  opterr = 1;
+  optind = 1;
+
+  // Se procesan las opciones indicadas antes de los argumentos posicionales.
+  // Todas se validan con 'asignarConfiguracion', igual que las del fichero
+  while((opcion = getopt(argc, argv, OPCIONES)) != -1){
+    switch(opcion){
+      case 'h':
+      // Se imprime la ayuda al usuario y se sale de forma exitosa
+      printf("Modo de uso: %s [-F fichero] [-a afinidad] [-b tam] "
+             "[-n producciones] [-p segundos] [-c segundos] [-P segundos] "
+             "[-C segundos] [-e estrategia] [-f] [-m] [-k fragmentos] "
+             "[-l lote] [-r nivel] [-s pausas] <numProductores> "
+             "<numConsumidores> <defecto>\n"
+             "\t-> defecto: se utilizan los parámetros por defecto para los"
+                  " hilos:\n"
+                  "\t\t-> Tiempo de producción: 2\n"
+                  "\t\t-> Tiempo de consumición: 1\n"
+                  "\t\t-> Tiempo de postProducción: aleatorio entre 0 y 4\n"
+                  "\t\t-> Tiempo de postConsumición: aleatorio entre 0 y 4"
+                  "\n\t\t-> Número de producciones: 10 por hilo\n"
+             "\t   Si no se indica, ni se indica ningún tiempo, el número de "
+                  "producciones o un fichero de configuración, se pregunta por "
+                  "ellos\n"
+             "\t-> F: fichero de configuración con una asignación 'clave = "
+                  "valor' por línea. Claves: productores, consumidores, "
+                  "tam_buffer, producciones, tiempo_produccion, "
+                  "tiempo_consumicion, post_produccion, post_consumicion, "
+                  "lote, nivel, estrategia, pausas, medir, fragmentos, "
+                  "afinidad y trabajadores. Las opciones de la línea de "
+                  "comandos prevalecen sobre el fichero\n"
+             "\t-> afinidad: CPU en la que se ejecuta cada hilo: 'ninguna' "
+                  "(por defecto), 'compacta' (llenando núcleos), 'dispersa' "
+                  "(alternando paquetes y núcleos), 'parejas' (cada productor "
+                  "junto a su consumidor) o una lista de CPUs como '0,2,4-7'. "
+                  "Los buffers se ubican en el nodo NUMA de los consumidores\n"
+             "\t-> tam: número de posiciones del buffer (por defecto 10)\n"
+             "\t-> producciones: producciones a realizar por cada productor\n"
+             "\t-> p, c, P, C: tiempos de producción, consumición, post "
+                  "producción y post consumición en segundos. Admiten "
+                  "decimales y 'aleatorio' (entre 0 y 4 segundos)\n"
+             "\t-> estrategia: 'condiciones' (por defecto) o 'futex'\n"
+             "\t-> lote: número máximo de elementos que productores y "
+                  "consumidores insertan o sacan en cada acceso a la región "
+                  "crítica (entre 1 y %d, por defecto 1)\n"
+             "\t-> nivel: mensajes que muestran los hilos (0: ninguno, 1: "
+                  "producciones y consumiciones, 2: todos, por defecto 2). Los "
+                  "mensajes se escriben desde un hilo dedicado, fuera de las "
+                  "regiones críticas\n"
+             "\t-> pausas: número máximo de pausas que los hilos esperan "
+                  "activamente a que cambie la cola antes de dormir (0 la "
+                  "desactiva, por defecto %d). El número se adapta según el "
+                  "éxito de las esperas anteriores\n"
+             "\t-> fragmentos: número de fragmentos en los que se reparte la "
+                  "cola, cada uno con su propio buffer y sus propias regiones "
+                  "críticas. Cada hilo tiene asignado un fragmento, y los "
+                  "consumidores que encuentran vacío el suyo sacan items de "
+                  "los demás. Se limita al menor entre el número de "
+                  "productores y el de consumidores (por defecto 1)\n"
+             "\t-> f: equivale a '-e futex'\n"
+             "\t-> m: se mide la duración de la espera de los mutexes, de "
+                  "las variables de condición y de cada producción y "
+                  "consumición, y se imprimen sus percentiles al finalizar\n"
+             "\tLos tiempos de producción y consumición se realizan fuera de "
+                  "las regiones críticas\n"
+             "\tCon un único productor y un único consumidor se utiliza un"
+                  " buffer SPSC sin mutexes ni variables de condición, en el "
+                  "que no se utilizan lotes\n"
+                  , argv[0], MAX_LOTE, ESPERA_MAX_DEFECTO);
+
+      exit(EXIT_SUCCESS);
+      break;
+
+      case 'F':
+      // El fichero ya se ha leído en la primera pasada
+      break;
+
+      case 'a':
+      valido = asignarConfiguracion(&configuracion, "afinidad", optarg);
+      break;
+
+      case 'b':
+      valido = asignarConfiguracion(&configuracion, "tam_buffer", optarg);
+      break;
+
+      case 'n':
+      valido = asignarConfiguracion(&configuracion, "producciones", optarg);
+      break;
+
+      case 'p':
+      valido = asignarConfiguracion(&configuracion, "tiempo_produccion",
+                                    optarg);
       break;
+
+      case 'c':
+      valido = asignarConfiguracion(&configuracion, "tiempo_consumicion",
+                                    optarg);
+      break;
+
+      case 'P':
+      valido = asignarConfiguracion(&configuracion, "post_produccion", optarg);
+      break;
+
+      case 'C':
+      valido = asignarConfiguracion(&configuracion, "post_consumicion",
+                                    optarg);
+      break;
+
+      case 'e':
+      valido = asignarConfiguracion(&configuracion, "estrategia", optarg);
+      break;
+
+      case 'k':
+      valido = asignarConfiguracion(&configuracion, "fragmentos", optarg);
+      break;
+
+      case 'l':
+      valido = asignarConfiguracion(&configuracion, "lote", optarg);
+      break;
+
+      case 'f':
+      configuracion.estrategia = ESTRATEGIA_FUTEX;
+      break;
+
+      case 'm':
+      configuracion.medir = 1;
+      break;
+
+      case 'r':
+      valido = asignarConfiguracion(&configuracion, "nivel", optarg);
+      break;
+
+      case 's':
+      valido = asignarConfiguracion(&configuracion, "pausas", optarg);
+      break;
+
+      default:
+      fprintf(stderr, "Utiliza %s -h para ver el modo de uso\n", argv[0]);
+      exit(EXIT_FAILURE);
     }
+
+    if(valido != 0){
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // Número de argumentos posicionales restantes
+  numArgumentos = argc - optind;
+
+  // Se comprueba que se indiquen el número de productores y el de
+  // consumidores, salvo que se tomen del fichero de configuración
+  if((numArgumentos == 0 && fichero == NULL) || numArgumentos == 1 ||
+     numArgumentos > 3){
+    fprintf(stderr, "[!] Se deben indicar el número de productores y el de "
+                    "consumidores\nUtiliza %s -h para ver el modo de uso\n",
+            argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  if(numArgumentos >= 2 &&
+     (asignarConfiguracion(&configuracion, "productores", argv[optind]) != 0 ||
+      asignarConfiguracion(&configuracion, "consumidores",
+                           argv[optind + 1]) != 0)){
+    exit(EXIT_FAILURE);
+  }
+
+  // En caso de que no se indique la opción por defecto ni ninguno de los
+  // parámetros de los hilos, se pide al usuario que los indique. Las
+  // respuestas se validan igual que las opciones
+  if(numArgumentos <= 2 && fichero == NULL && !configuracion.parametrosHilos){
+    preguntar(&configuracion, "[?] ¿Tiempo de producción? ",
+              "tiempo_produccion");
+    preguntar(&configuracion, "[?] ¿Tiempo de consumición? ",
+              "tiempo_consumicion");
+    preguntar(&configuracion, "[?] ¿Tiempo de post producción? ",
+              "post_produccion");
+    preguntar(&configuracion, "[?] ¿Tiempo de post consumición? ",
+              "post_consumicion");
+    preguntar(&configuracion, "[?] ¿Producciones a realizar por hilo? ",
+              "producciones");
   }
 
-  // Se comprueba que haya más de 2 argumentos (nombre del ejecutable, número de
-  // de productores y número de consumidores)
-  if(argc > 2){
-    // Se realiza un switch en función del primer carácter de la segunda cadena
-    numProductores = atoi(argv[1]);
-    numConsumidores = atoi(argv[2]);
+  // Sin trabajadores no se admiten más hilos de los que se pueden crear
+  if(comprobarConfiguracion(&configuracion) != 0){
+    exit(EXIT_FAILURE);
+  }
+
+  // Esta implementación no ejecuta los hilos como fibras
+  if(configuracion.trabajadores != 0){
+    fprintf(stderr, "[!] Esta implementación no admite trabajadores\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Los avisos sobre descriptores solo existen en la implementación de una
+  // región crítica
+  if(configuracion.estrategia == ESTRATEGIA_EVENTFD){
+    fprintf(stderr, "[!] Esta implementación no admite la estrategia "
+                    "'eventfd'\n");
+    exit(EXIT_FAILURE);
+  }
 
+  // Ni el reparto de las líneas de un fichero de entrada
+  if(configuracion.entrada[0] != '\0'){
+    fprintf(stderr, "[!] Esta implementación no admite fichero de entrada\n");
+    exit(EXIT_FAILURE);
   }
 
+  // Se aplica la configuración
+  numProductores = configuracion.numProductores;
+  numConsumidores = configuracion.numConsumidores;
+  lote = configuracion.lote;
+  usarFutex = configuracion.estrategia == ESTRATEGIA_FUTEX;
+  maximoEspera = configuracion.pausas;
+  medir = configuracion.medir;
+
+  // Se calcula la CPU de cada hilo antes de reservar los buffers, que se
+  // ubican en el nodo de los consumidores
+  if(crearAfinidad(&afinidad, configuracion.afinidad, numProductores) != 0){
+    exit(EXIT_FAILURE);
+  }
+  numFragmentos = configuracion.fragmentos;
+
   // Se reserva memoria para los productores y consumidores
   productores = (HiloProductor*)  malloc(sizeof(HiloProductor)*numProductores);
   consumidores = (HiloConsumidor*) malloc(sizeof(HiloConsumidor)*
                                           numConsumidores);
 
-  // En caso de que el número argumentos solo sean 3, se pide al usuario los
-  // parámetros para los hilos
-  if(argc <= 3){
-    printf("[?] ¿Tiempo de producción? ");
-    scanf("%d", &(productores[0].tiempo));
-    printf("[?] ¿Tiempo de consumición? ");
-    scanf("%d", &(consumidores[0].tiempo));
-    printf("[?] ¿Tiempo de post producción? ");
-    scanf("%d", &(productores[0].postProduccion));
-    printf("[?] ¿Tiempo de post consumición? ");
-    scanf("%d", &(consumidores[0].postConsumicion));
-    printf("[?] ¿Producciones a realizar por hilo? ");
-    scanf("%d", &(productores[0].numProducciones));
-  } else {
-    // En caso contrario se establecen los valores por defecto.
-    // Al establecer los tiempos a -1 se utilizarán tiempos aleatorios entre 0 y
-    // 4 segundos.
-    productores[0].tiempo = 2;
-    productores[0].postProduccion = -1;
-    consumidores[0].tiempo = 1;
-    consumidores[0].postConsumicion = -1;
-    productores[0].numProducciones = 10;
+  // Los parámetros del primer hilo de cada tipo se duplican para el resto. Al
+  // establecer los tiempos a -1 se utilizarán tiempos aleatorios entre 0 y 4
+  // segundos
+  productores[0].tiempo = configuracion.tiempoProduccion;
+  productores[0].postProduccion = configuracion.postProduccion;
+  consumidores[0].tiempo = configuracion.tiempoConsumicion;
+  consumidores[0].postConsumicion = configuracion.postConsumicion;
+  productores[0].numProducciones = configuracion.producciones;
+
+  // El tamaño del lote es el mismo para productores y consumidores
+  productores[0].lote = lote;
+  consumidores[0].lote = lote;
+
+  // Se utilizan las funciones de trabajo por defecto
+  productores[0].producir = producir;
+  consumidores[0].consumir = consumir;
+
+  // Cada fragmento debe tener al menos un productor y un consumidor propios.
+  // Así el fragmento se cierra cuando terminan sus productores, y un consumidor
+  // puede finalizar cuando el suyo está cerrado y vacío, ya que los items de
+  // los demás los consumirán sus propios consumidores
+  if(numFragmentos > numProductores){
+    numFragmentos = numProductores;
+  }
+  if(numFragmentos > numConsumidores){
+    numFragmentos = numConsumidores;
   }
 
-  // Se inicializan los mutexes a usar explicados en la cabecera del programa
-  pthread_mutex_init(&mutexConsum, NULL);
-  pthread_mutex_init(&mutexProd, NULL);
-  pthread_mutex_init(&mutexDespertar, NULL);
+  // Se inicializan los mutexes, las variables de condición y el buffer de cada
+  // fragmento. El buffer se ubica en el nodo de su primer consumidor, el de su
+  // mismo identificador
+  fragmentos = (Fragmento*) malloc(sizeof(Fragmento)*numFragmentos);
+  for(i = 0; i < numFragmentos; i++){
+    iniciarFragmento(&fragmentos[i], configuracion.tamBuffer);
+    ubicarMemoria(&afinidad, fragmentos[i].buffer.valores,
+                  sizeof(int)*fragmentos[i].buffer.tam,
+                  cpuConsumidor(&afinidad, i));
+  }
 
-  // Inicialización de la variable de condición utilizada para despertar a los
-  // hilos
-  pthread_cond_init(&condDespertar, NULL);
+  // Con un único productor y un único consumidor no es necesaria la exclusión
+  // mutua, por lo que se utiliza el buffer SPSC
+  if(numProductores == 1 && numConsumidores == 1){
+    modoSPSC = 1;
+    bufferSPSC = crearBufferSPSC(configuracion.tamBuffer);
+    ubicarMemoria(&afinidad, bufferSPSC.valores, sizeof(int)*bufferSPSC.tam,
+                  cpuConsumidor(&afinidad, 0));
+  }
 
-  // Se llama a la función de crearBuffer para obtener un buffer del tamaño
-  // indicado
-  buffer = crearBuffer(TAM_BUFFER);
+  // Se deja constancia de la ubicación de los hilos junto con los resultados
+  if(afinidad.politica != AFINIDAD_NINGUNA){
+    imprimirAfinidad(&afinidad, numProductores, numConsumidores, stdout);
+  }
+
+  // Se inicia el hilo que escribe por pantalla los mensajes de los hilos
+  iniciarRegistro(configuracion.nivel, stdout);
 
   // Se crean los productores y consumidores, pasándole a estas funciones los
   // arrays con la información de los hilos correspondientes.
@@ -259,24 +709,45 @@ int main(int argc, char *argv[]){
   // serán, en la gran parte de los casos, los últimos en finalizar.
   joinConsumidores(consumidores, numConsumidores);
 
-  // Se destruyen los mutexes una vez finalizada su función
-  pthread_mutex_destroy(&mutexConsum);
-  pthread_mutex_destroy(&mutexProd);
-  pthread_mutex_destroy(&mutexDespertar);
+  // Se escriben los mensajes pendientes y se finaliza el registro
+  finalizarRegistro();
 
-  // Se destruye la variable de condición
-  pthread_cond_destroy(&condDespertar);
+  // Se imprimen las duraciones de las fases de todos los hilos
+  if(medir){
+    imprimirFases(productores, numProductores, consumidores, numConsumidores);
+  }
 
-  // Se destruye el buffer
-  destruirBuffer(&buffer);
+  // Se destruyen los fragmentos una vez finalizada su función
+  for(i = 0; i < numFragmentos; i++){
+    destruirFragmento(&fragmentos[i]);
+  }
+  free(fragmentos);
+  if(modoSPSC){
+    destruirBufferSPSC(&bufferSPSC);
+  }
+
+  destruirAfinidad(&afinidad);
 
   // El proceso finaliza
   exit(EXIT_SUCCESS);
 }
 
 void crearProductores(HiloProductor* hilos, unsigned int numProductores){
-  // Contador
-  int i;
+  // Contadores
+  int i, j;
+
+  // Resultado de la creación de cada hilo
+  int error;
+
+  // Atributos del hilo, con la CPU que le asigna la afinidad
+  pthread_attr_t atributos;
+
+  // Se registran todos los productores en sus fragmentos antes de crear el
+  // primero, de forma que ningún fragmento se pueda cerrar mientras quede
+  // alguno de sus productores por terminar
+  for(i = 0; i < numProductores; i++){
+    registrarProductores(&fragmentos[i % numFragmentos].buffer, 1);
+  }
 
   for(i = 0; i < numProductores; i++){
     // Se asigna el id correspondiente al hilo, en función del orden
@@ -288,21 +759,38 @@ void crearProductores(HiloProductor* hilos, unsigned int numProductores){
     hilos[i].numProducciones = hilos[0].numProducciones;
     hilos[i].postProduccion = hilos[0].postProduccion;
     hilos[i].tiempo = hilos[0].tiempo;
+    hilos[i].lote = hilos[0].lote;
+    hilos[i].producir = hilos[0].producir;
+    for(j = 0; j < NUM_FASES; j++){
+      iniciarHistograma(&hilos[i].fases[j]);
+    }
 
-    // Se incrementan el número de producciones en función de las que vaya a
-    // hacer el hilo correspondiente
-    incrementarProducciones(&buffer, hilos[i].numProducciones);
+    // Se asigna el fragmento del hilo, en el que ya está registrado
+    hilos[i].fragmento = &fragmentos[i % numFragmentos];
 
     // Se crea el hilo, almacenando la información en su variable concreta.
     // El hilo ejecutará la función 'productor' que recibe como parámetro el
-    // puntero a la información del hilo correspondiente
-    pthread_create(&(hilos[i].tid), NULL, (void*)productor, hilos+i);
+    // puntero a la información del hilo correspondiente. Los atributos fijan
+    // la CPU que le asigna la afinidad
+    pthread_attr_init(&atributos);
+    fijarAfinidad(&atributos, cpuProductor(&afinidad, i));
+    error = pthread_create(&(hilos[i].tid), &atributos,
+                           modoSPSC ? (void*)productorSPSC : (void*)productor,
+                           hilos+i);
+    pthread_attr_destroy(&atributos);
+    if(error != 0){
+      fprintf(stderr, "[!] No se ha podido crear el hilo del productor %d: "
+                      "%s\n", i, strerror(error));
+      exit(EXIT_FAILURE);
+    }
   }
 
 }
 
 void crearConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
-  int i;
+  int i, j;
+  int error;
+  pthread_attr_t atributos;
 
   for(i = 0; i < numConsumidores; i++){
     // Se asigna el id correspondiente al hilo, en función del orden
@@ -312,11 +800,29 @@ void crearConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
     // hilo
     hilos[i].tiempo = hilos[0].tiempo;
     hilos[i].postConsumicion = hilos[0].postConsumicion;
+    hilos[i].lote = hilos[0].lote;
+    hilos[i].consumir = hilos[0].consumir;
+    hilos[i].fragmento = &fragmentos[i % numFragmentos];
+    for(j = 0; j < NUM_FASES; j++){
+      iniciarHistograma(&hilos[i].fases[j]);
+    }
 
     // Se crea el hilo, almacenando la información en su variable concreta.
     // El hilo ejecutará la función 'consumidor' que recibe como parámetro el
-    // puntero a la información del hilo correspondiente
-    pthread_create(&(hilos[i].tid), NULL, (void*)consumidor, hilos+i);
+    // puntero a la información del hilo correspondiente. Los atributos fijan
+    // la CPU que le asigna la afinidad
+    pthread_attr_init(&atributos);
+    fijarAfinidad(&atributos, cpuConsumidor(&afinidad, i));
+    error = pthread_create(&(hilos[i].tid), &atributos,
+                           modoSPSC ? (void*)consumidorSPSC
+                                    : (void*)consumidor,
+                           hilos+i);
+    pthread_attr_destroy(&atributos);
+    if(error != 0){
+      fprintf(stderr, "[!] No se ha podido crear el hilo del consumidor %d: "
+                      "%s\n", i, strerror(error));
+      exit(EXIT_FAILURE);
+    }
   }
 }
 
@@ -337,76 +843,324 @@ void joinConsumidores(HiloConsumidor* hilos, unsigned int numConsumidores){
 }
 
 
-void productor(HiloProductor* hilo){
-  int i;
-  int item;
+void iniciarFragmento(Fragmento* fragmento, int tam){
+  // Se inicializan los mutexes a usar explicados en la cabecera del programa
+  pthread_mutex_init(&fragmento->mutexConsum, NULL);
+  pthread_mutex_init(&fragmento->mutexProd, NULL);
+  pthread_mutex_init(&fragmento->mutexDespertar, NULL);
+
+  // Inicialización de las variables de condición utilizadas para despertar a
+  // los hilos
+  pthread_cond_init(&fragmento->condNoLlena, NULL);
+  pthread_cond_init(&fragmento->condNoVacia, NULL);
+  fragmento->productoresEsperando = 0;
+  fragmento->consumidoresEsperando = 0;
+  iniciarEvento(&fragmento->eventoNoLlena);
+  iniciarEvento(&fragmento->eventoNoVacia);
 
-  // Se informa al usuario del número del productor
-  imprimirCabeceraProduc(*hilo, reset);
-  printf("[i] Soy el productor número %d\n", hilo->id);
+  // Se llama a la función de crearBuffer para obtener un buffer del tamaño
+  // indicado
+  fragmento->buffer = crearBuffer(tam);
+}
 
-  // Se crean las producciones indicadas en la información del hilo
-  for(i = 0; i < hilo->numProducciones; i++){
-    // Se produce el item
-    item = producir();
+void destruirFragmento(Fragmento* fragmento){
+  // Se destruyen los mutexes una vez finalizada su función
+  pthread_mutex_destroy(&fragmento->mutexConsum);
+  pthread_mutex_destroy(&fragmento->mutexProd);
+  pthread_mutex_destroy(&fragmento->mutexDespertar);
 
-    imprimirCabeceraProduc(*hilo, tcyan);
-    printf("[*] Intentando acceder a la región crítica de productores\n%s",
-            reset);
+  // Se destruyen las variables de condición
+  pthread_cond_destroy(&fragmento->condNoLlena);
+  pthread_cond_destroy(&fragmento->condNoVacia);
 
-    // Se intenta acceder a la región crítica del productor
-    pthread_mutex_lock(&mutexProd);
+  // Se destruye el buffer
+  destruirBuffer(&fragmento->buffer);
+}
+
+int despertarProductores(Fragmento* fragmento, int n, Histograma* fase){
+  int desperto = 0;
+  uint64_t inicioFase;
+
+  // Con la opción -f se notifica a los productores sin obtener el
+  // mutexDespertar. Solo se realiza una llamada al sistema si hay un productor
+  // esperando
+  if(usarFutex){
+    return notificarEvento(&fragmento->eventoNoLlena, n);
+  }
+
+  // Se accede a la región crítica común para despertar al productor en caso de
+  // que haya uno dormido esperando a que se liberen posiciones
+  inicioFase = iniciarFase();
+  pthread_mutex_lock(&fragmento->mutexDespertar);
+  finalizarFase(fase, inicioFase);
+  if(fragmento->productoresEsperando > 0){
+    desperto = 1;
 
-    // Se bloquea la región crítica utilizada para los pthread_cond_wait
-    // y pthread_cond_signal y para las comprobaciones de colaLlena y colaVacia
-    pthread_mutex_lock(&mutexDespertar);
+    // Se lanza la señal para despertar al productor
+    pthread_cond_signal(&fragmento->condNoLlena);
+  }
+
+  // Se libera la región crítica común
+  pthread_mutex_unlock(&fragmento->mutexDespertar);
 
-    // Se comprueba si la cola está llena, ya que en caso de que lo esté, será
-    // necesario dormir al productor esperando a que un consumidor lo despierte
-    while(colaLlena(buffer)){
+  return desperto;
+}
 
-      imprimirCabeceraProduc(*hilo, fpurple);
-      printf("[!] La cola está llena. Durmiendo...%s\n", reset);
+int despertarConsumidores(Fragmento* fragmento, int n, Histograma* fase){
+  int desperto = 0;
+  uint64_t inicioFase;
+
+  // Con la opción -f se notifica a los consumidores sin obtener el
+  // mutexDespertar. Solo se realiza una llamada al sistema si hay un
+  // consumidor esperando
+  if(usarFutex){
+    return notificarEvento(&fragmento->eventoNoVacia, n);
+  }
 
-      // Se duerme el productor, dejando libre la región crítica asociada al
-      // mutexDespertar para que otro consumidor lo pueda despertar, pero no la
-      // región crítica asociada al productor, ya que no aporta nada que otro
-      // productor pueda entrar, debido a que se va a quedar bloqueado.
-      pthread_cond_wait(&condDespertar, &mutexDespertar);
+  // Se bloquea el mutex utilizado para la comunicación entre consumidores y
+  // productores
+  inicioFase = iniciarFase();
+  pthread_mutex_lock(&fragmento->mutexDespertar);
+  finalizarFase(fase, inicioFase);
+
+  // En caso de que haya un consumidor dormido se le despierta. Como el
+  // consumidor comprueba si la cola está vacía con este mismo mutex bloqueado,
+  // o bien ha visto la inserción o bien ya está contado como dormido, por lo
+  // que la señal no se pierde
+  if(fragmento->consumidoresEsperando > 0){
+    desperto = 1;
+
+    // Se despierta al consumidor
+    pthread_cond_signal(&fragmento->condNoVacia);
+  }
+
+  // Se libera el mutex común a productores y consumidores
+  pthread_mutex_unlock(&fragmento->mutexDespertar);
+
+  return desperto;
+}
+
+int terminarFragmento(Fragmento* fragmento){
+  if(!terminarProductor(&fragmento->buffer)){
+    return 0;
+  }
+
+  if(usarFutex){
+    notificarTodos(&fragmento->eventoNoVacia);
+  } else {
+    // El cierre se realiza antes de bloquear el mutexDespertar, con el que los
+    // consumidores comprueban si el buffer está cerrado antes de dormir. Así,
+    // o bien el consumidor ve el cierre o bien ya está dormido y recibe la
+    // señal
+    pthread_mutex_lock(&fragmento->mutexDespertar);
+    pthread_cond_broadcast(&fragmento->condNoVacia);
+    pthread_mutex_unlock(&fragmento->mutexDespertar);
+  }
 
+  return 1;
+}
+
+int robar(HiloConsumidor* hilo, int* items, Fragmento** origen,
+          int* elementos, int* desperto){
+  Fragmento* fragmento;
+  int propio = hilo->fragmento - fragmentos;
+  int i, n;
+
+  for(i = 1; i < numFragmentos; i++){
+    fragmento = &fragmentos[(propio + i) % numFragmentos];
+
+    // Se descartan sin bloquearse los fragmentos vacíos y aquellos cuya región
+    // crítica de consumidores está ocupada, ya que en ese caso uno de sus
+    // consumidores está sacando items o esperando a que los haya. Sin la
+    // región crítica no se puede utilizar 'colaVacia', que actualiza la copia
+    // de 'final' de los consumidores, por lo que se consultan los índices
+    // atómicos
+    if(numElementos(&fragmento->buffer) == 0 ||
+       pthread_mutex_trylock(&fragmento->mutexConsum) != 0){
+      continue;
     }
-    // Se libera el mutex
-    pthread_mutex_unlock(&mutexDespertar);
 
-    // Se inserta en el buffer, indicando el tiempo de producción que se tardará
-    insertarBufferTime(&buffer, item, hilo->tiempo);
-    imprimirCabeceraProduc(*hilo, tgreen);
-    printf("[%d / %d] He fabricado el valor: %d\n%s", i+1,
-            hilo->numProducciones, item, reset);
-    imprimirBuffer(buffer);
+    // Los items se sacan igual que en el fragmento propio. Si el fragmento
+    // queda cerrado y vacío, sus consumidores lo verán al volver a comprobarlo
+    n = sacarBufferN(&fragmento->buffer, items, hilo->lote);
+    if(n > 0){
+      *elementos = numElementos(&fragmento->buffer);
+      *desperto = despertarProductores(fragmento, n,
+                                       &hilo->fases[FASE_DESPERTAR]);
+      *origen = fragmento;
+    }
+    pthread_mutex_unlock(&fragmento->mutexConsum);
+
+    if(n > 0){
+      return n;
+    }
+  }
+
+  return 0;
+}
+
 
-    // Se bloquea el mutex utilizado para la comunicación entre consumidores y
-    // productores
-    pthread_mutex_lock(&mutexDespertar);
+void productor(HiloProductor* hilo){
+  int i, j;
+
+  // Items del lote actual, número de items del lote, items del lote ya
+  // insertados y items insertados en la última inserción
+  int items[MAX_LOTE];
+  int numItems, insertados, n;
+
+  // Información obtenida dentro de las regiones críticas que se registra una
+  // vez liberadas: veces que el productor se ha dormido, veces que ha
+  // despertado a los consumidores y elementos del buffer tras la inserción
+  int esperas, despertares, elementos;
+
+  // Instante de inicio de la fase que se está midiendo
+  uint64_t inicioFase;
+
+  // Con la opción -f, ticket de la espera en el evento
+  uint32_t ticket;
 
-    // En caso de que el número de elementos del buffer ahora sea 1, es porque
-    // la cola estaba vacía, por lo tanto se despierta al consumidor
-    if(numElementos(buffer) == 1){
-      imprimirCabeceraProduc(*hilo, tpurple);
-      printf("[!] Despertando al consumidor.\n%s", reset);
+  // Fragmento de la cola en el que se insertan las producciones
+  Fragmento* fragmento = hilo->fragmento;
 
-      // Se despierta al consumidor
-      pthread_cond_signal(&condDespertar);
+  // Se crea la cola de registro del hilo
+  hilo->registro = crearColaRegistro('P', hilo->id);
+  iniciarEsperaActiva(&hilo->espera, maximoEspera);
+
+  // Se informa al usuario del número del productor
+  registrar(hilo->registro, REGISTRO_EVENTOS, reset,
+            "[i] Soy el productor número %d\n", hilo->id, 0, 0, 0);
+
+  // Se crean las producciones indicadas en la información del hilo, en lotes
+  // de como mucho 'lote' items
+  for(i = 0; i < hilo->numProducciones; i += numItems){
+    // Se produce el lote de items antes de acceder a la región crítica, por lo
+    // que el tiempo de producción no bloquea al resto de hilos. El último lote
+    // puede ser menor si el número de producciones no es múltiplo del tamaño
+    // del lote
+    numItems = hilo->numProducciones - i;
+    if(numItems > hilo->lote){
+      numItems = hilo->lote;
     }
+    for(j = 0; j < numItems; j++){
+      inicioFase = iniciarFase();
+      items[j] = hilo->producir(hilo);
+      finalizarFase(&hilo->fases[FASE_TRABAJO], inicioFase);
+    }
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[*] Intentando acceder a la región crítica de productores\n",
+              0, 0, 0, 0);
 
-    // Se libera el mutex común a productores y consumidores
-    pthread_mutex_unlock(&mutexDespertar);
+    esperas = 0;
+    despertares = 0;
+    elementos = 0;
+
+    // Se intenta acceder a la región crítica del productor
+    inicioFase = iniciarFase();
+    pthread_mutex_lock(&fragmento->mutexProd);
+    finalizarFase(&hilo->fases[FASE_REGION], inicioFase);
+
+    // Se insertan todos los items del lote. Si el buffer se llena a mitad del
+    // lote, el productor se duerme con la parte ya insertada visible para los
+    // consumidores
+    for(insertados = 0; insertados < numItems; insertados += n){
+
+      // Antes de dormir se espera activamente a que un consumidor libere
+      // alguna posición. Como el productor tiene la región crítica de los
+      // productores, ningún otro productor puede llenar la cola mientras tanto
+      if(colaLlena(&fragmento->buffer)){
+        esperarActivamente(&hilo->espera, hayHueco, &fragmento->buffer);
+      }
+
+      if(usarFutex){
+        // Sin el mutexDespertar, la espera se prepara antes de volver a
+        // comprobar si la cola está llena. Así, o bien se ve la posición
+        // liberada por el consumidor o bien el consumidor ve que el productor
+        // está esperando y lo notifica
+        while(colaLlena(&fragmento->buffer)){
+          ticket = prepararEspera(&fragmento->eventoNoLlena);
+          if(colaLlena(&fragmento->buffer)){
+            esperas++;
+            inicioFase = iniciarFase();
+            esperarEvento(&fragmento->eventoNoLlena, ticket);
+            finalizarFase(&hilo->fases[FASE_CONDICION], inicioFase);
+          } else {
+            cancelarEspera(&fragmento->eventoNoLlena);
+          }
+        }
+      } else {
+        // Se bloquea la región crítica utilizada para los pthread_cond_wait
+        // y pthread_cond_signal y para las comprobaciones de colaLlena y
+        // colaVacia
+        inicioFase = iniciarFase();
+        pthread_mutex_lock(&fragmento->mutexDespertar);
+        finalizarFase(&hilo->fases[FASE_DESPERTAR], inicioFase);
+
+        // Se comprueba si la cola está llena, ya que en caso de que lo esté, será
+        // necesario dormir al productor esperando a que un consumidor lo
+        // despierte
+        while(colaLlena(&fragmento->buffer)){
+
+          // Se duerme el productor, dejando libre la región crítica asociada al
+          // mutexDespertar para que otro consumidor lo pueda despertar, pero no
+          // la región crítica asociada al productor, ya que no aporta nada que
+          // otro productor pueda entrar, debido a que se va a quedar bloqueado.
+          esperas++;
+          fragmento->productoresEsperando++;
+          inicioFase = iniciarFase();
+          pthread_cond_wait(&fragmento->condNoLlena,
+                            &fragmento->mutexDespertar);
+          finalizarFase(&hilo->fases[FASE_CONDICION], inicioFase);
+          fragmento->productoresEsperando--;
+
+        }
+        // Se libera el mutex
+        pthread_mutex_unlock(&fragmento->mutexDespertar);
+      }
+
+      // Se insertan en el buffer tantos items del lote como quepan
+      n = insertarBufferN(&fragmento->buffer, items + insertados,
+                          numItems - insertados);
+
+      elementos = numElementos(&fragmento->buffer);
+      if(despertarConsumidores(fragmento, n, &hilo->fases[FASE_DESPERTAR])){
+        despertares++;
+      }
+    }
 
     // Se libera la región crítica de los productores
-    pthread_mutex_unlock(&mutexProd);
+    pthread_mutex_unlock(&fragmento->mutexProd);
 
-    imprimirCabeceraProduc(*hilo, tcyan);
-    printf("[i] Región crítica de productores liberada\n%s", reset);
+    // Lo ocurrido dentro de las regiones críticas se registra una vez liberadas
+    if(esperas > 0){
+      registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                "[!] La cola estaba llena. Me he dormido %d veces\n", esperas,
+                0, 0, 0);
+    }
+    if(numItems == 1){
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[%d / %d] He fabricado el valor: %d\n", i+1,
+                hilo->numProducciones, items[0], 0);
+    } else {
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[%d / %d] He fabricado %d valores\n", i+numItems,
+                hilo->numProducciones, numItems, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tyellow,
+              "[i] Elementos en el buffer: %d / %d\n", elementos,
+              tamano(&fragmento->buffer), 0, 0);
+    if(despertares > 0){
+      registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+                "[!] Despertando al consumidor.\n", 0, 0, 0, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[i] Región crítica de productores liberada\n", 0, 0, 0, 0);
+
+    // Tras el último lote se cierra el fragmento sin realizar la espera post
+    // producción, de forma que los consumidores no la tengan que esperar
+    if(i + numItems >= hilo->numProducciones){
+      break;
+    }
 
     // Se realiza la post producción, en caso de que el tiempo indicado sea
     // negativo, se escoge un tiempo aleatorio entre 0 y 4
@@ -414,16 +1168,23 @@ void productor(HiloProductor* hilo){
       hilo->postProduccion = rand()%5;
     }
 
-    imprimirCabeceraProduc(*hilo, tpurple);
-    printf("[*] Realizando espera post producción de %d segundos\n%s",
-            hilo->postProduccion, reset);
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post producción de %d ms\n",
+              (int)(hilo->postProduccion * 1000), 0, 0, 0);
 
-    if(hilo->postProduccion > 0)
-      sleep(hilo->postProduccion);
+    dormir(hilo->postProduccion);
   }
 
-  imprimirCabeceraProduc(*hilo, tred);
-  printf("[!] He acabado de producir. Finalizando...\n%s", reset);
+  // Se indica que el productor ha terminado, cerrando el fragmento si era el
+  // último de sus productores
+  if(terminarFragmento(fragmento)){
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[!] Fragmento cerrado. Despertando a los consumidores.\n", 0, 0,
+              0, 0);
+  }
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+            "[!] He acabado de producir. Finalizando...\n", 0, 0, 0, 0);
 
   // El hilo finaliza correctamente
   pthread_exit(EXIT_SUCCESS);
@@ -432,79 +1193,169 @@ void productor(HiloProductor* hilo){
 void consumidor(HiloConsumidor* hilo){
   // Contador del número de consumiciones
   int i = 1;
-  int item;
 
-  // Bucle infinito hasta que el número de producciones llegue a 0
+  // Items sacados del buffer y número de items sacados
+  int items[MAX_LOTE];
+  int n, j;
+
+  // Información obtenida dentro de las regiones críticas que se registra una
+  // vez liberadas: veces que el consumidor se ha dormido, si ha despertado a
+  // los productores y elementos del buffer tras sacar los items
+  int esperas, desperto, elementos;
+
+  // Instante de inicio de la fase que se está midiendo
+  uint64_t inicioFase;
+
+  // Con la opción -f, ticket de la espera en el evento
+  uint32_t ticket;
+
+  // Fragmento del que se han sacado los items: el propio del consumidor o
+  // aquel del que los ha robado
+  Fragmento* fragmento;
+
+  // Se crea la cola de registro del hilo
+  hilo->registro = crearColaRegistro('C', hilo->id);
+  iniciarEsperaActiva(&hilo->espera, maximoEspera);
+
+  // Bucle infinito hasta que el fragmento propio esté cerrado y vacío
   while(1){
 
-    imprimirCabeceraConsum(*hilo, tcyan);
-    printf("[*] Intentando acceder a la región crítica de consumidores...\n%s",
-            reset);
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[*] Intentando acceder a la región crítica de consumidores...\n",
+              0, 0, 0, 0);
 
-    // Se intenta acceder a la región crítica del consumidor
-    pthread_mutex_lock(&mutexConsum);
+    esperas = 0;
+    desperto = 0;
 
-    // Se comprueba el número de producciones que aún no han sido consumidas. En
-    // caso de que sean 0 el consumidor finaliza su ejecución
-    if(obtenerProducciones(buffer) == 0){
-      imprimirCabeceraConsum(*hilo, tred);
-      printf("[!] No quedan producciones. Finalizando...\n%s", reset);
+    n = 0;
 
-      // Se libera la región crítica
-      pthread_mutex_unlock(&mutexConsum);
-      pthread_exit(EXIT_SUCCESS);
+    // Si el fragmento propio está vacío se intenta sacar items de los demás
+    // antes de dormir en él. Como en 'robar', la comprobación se realiza sin la
+    // región crítica, por lo que solo consulta los índices atómicos
+    if(numFragmentos > 1 && numElementos(&hilo->fragmento->buffer) == 0){
+      n = robar(hilo, items, &fragmento, &elementos, &desperto);
+      if(n > 0){
+        registrar(hilo->registro, REGISTRO_DETALLE, tyellow,
+                  "[i] Mi fragmento está vacío. He robado %d valores del "
+                  "fragmento %d\n", n, (int)(fragmento - fragmentos), 0, 0);
+      }
     }
 
-    // Se accede a la región crítica común a consumidores y productores para
-    // realizar la comprobación correspondiente a si la cola está vacía, debido
-    // a que se de este último caso, no habrá nada para producir y el consumidor
-    // deberá dormirse
-    pthread_mutex_lock(&mutexDespertar);
-    while(colaVacia(buffer)){
-      imprimirCabeceraConsum(*hilo, fpurple);
-      printf("[!] La cola está vacía. Durmiendo...%s\n", reset);
+    if(n == 0){
+      fragmento = hilo->fragmento;
 
-      // Se ejecuta el pthread_cond_wait para que el consumidor se bloquee
-      pthread_cond_wait(&condDespertar, &mutexDespertar);
-    }
-    pthread_mutex_unlock(&mutexDespertar);
+      // Se intenta acceder a la región crítica del consumidor
+      inicioFase = iniciarFase();
+      pthread_mutex_lock(&fragmento->mutexConsum);
+      finalizarFase(&hilo->fases[FASE_REGION], inicioFase);
 
-    // Se saca el item del buffer, indicando el tiempo que se desea que dure la
-    // operación
-    item = sacarBufferTime(&buffer, hilo->tiempo);
+      // Antes de dormir se espera activamente a que un productor inserte algún
+      // item
+      if(colaVacia(&fragmento->buffer)){
+        esperarActivamente(&hilo->espera, hayElementos, &fragmento->buffer);
+      }
 
-    // Se decrementa en 1 el número de producciones que quedan por consumir
-    incrementarProducciones(&buffer, -1);
+      if(usarFutex){
+        // Igual que en el productor, la espera se prepara antes de volver a
+        // comprobar si la cola está vacía. El consumidor no duerme si el
+        // fragmento está cerrado, ya que nadie volvería a notificarlo
+        while(colaVacia(&fragmento->buffer) &&
+              !bufferCerrado(&fragmento->buffer)){
+          ticket = prepararEspera(&fragmento->eventoNoVacia);
+          if(colaVacia(&fragmento->buffer) &&
+             !bufferCerrado(&fragmento->buffer)){
+            esperas++;
+            inicioFase = iniciarFase();
+            esperarEvento(&fragmento->eventoNoVacia, ticket);
+            finalizarFase(&hilo->fases[FASE_CONDICION], inicioFase);
+          } else {
+            cancelarEspera(&fragmento->eventoNoVacia);
+          }
+        }
+      } else {
+        // Se accede a la región crítica común a consumidores y productores
+        // para realizar la comprobación correspondiente a si la cola está
+        // vacía, debido a que se de este último caso, no habrá nada para
+        // producir y el consumidor deberá dormirse
+        inicioFase = iniciarFase();
+        pthread_mutex_lock(&fragmento->mutexDespertar);
+        finalizarFase(&hilo->fases[FASE_DESPERTAR], inicioFase);
+        while(colaVacia(&fragmento->buffer) &&
+              !bufferCerrado(&fragmento->buffer)){
+          // Se ejecuta el pthread_cond_wait para que el consumidor se bloquee
+          esperas++;
+          fragmento->consumidoresEsperando++;
+          inicioFase = iniciarFase();
+          pthread_cond_wait(&fragmento->condNoVacia,
+                            &fragmento->mutexDespertar);
+          finalizarFase(&hilo->fases[FASE_CONDICION], inicioFase);
+          fragmento->consumidoresEsperando--;
+        }
+        pthread_mutex_unlock(&fragmento->mutexDespertar);
+      }
 
-    imprimirCabeceraConsum(*hilo, tgreen);
-    printf("[Nª: %d] He consumido el valor: %d\n%s", i, item, reset);
+      // Si el fragmento está cerrado y vacío ya no se insertarán más items y el
+      // consumidor finaliza su ejecución, ya que los de los demás fragmentos
+      // los consumirán sus propios consumidores
+      if(bufferAgotado(&fragmento->buffer)){
+        // Se libera la región crítica
+        pthread_mutex_unlock(&fragmento->mutexConsum);
 
-    imprimirCabeceraConsum(*hilo, tyellow);
-    printf("[i] Quedan por consumidor %d elementos\n%s",
-            obtenerProducciones(buffer), reset);
+        registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+                  "[!] No quedan producciones. Finalizando...\n", 0, 0, 0, 0);
+        pthread_exit(EXIT_SUCCESS);
+      }
 
-    imprimirBuffer(buffer);
+      // Se sacan del buffer como mucho 'lote' items. Su consumición se realiza
+      // una vez liberada la región crítica
+      n = sacarBufferN(&fragmento->buffer, items, hilo->lote);
 
-    // Se vuelve a acceder a la región crítica común para comprobar que, en el
-    // caso de que la cola estuviese llena antes de sacar el elemento, se
-    // despierte al productor
-    pthread_mutex_lock(&mutexDespertar);
-    if(numElementos(buffer) == tamano(buffer) - 1){
-      imprimirCabeceraConsum(*hilo, tpurple);
-      printf("[!] Despertando al productor...\n%s", reset);
+      elementos = numElementos(&fragmento->buffer);
+      desperto = despertarProductores(fragmento, n,
+                                      &hilo->fases[FASE_DESPERTAR]);
 
-      // Se lanza la señal para despertar al productor
-      pthread_cond_signal(&condDespertar);
+      // Se libera la región crítica de los consumidores
+      pthread_mutex_unlock(&fragmento->mutexConsum);
     }
 
-    // Se libera la región crítica común
-    pthread_mutex_unlock(&mutexDespertar);
-
-    // Se libera la región crítica de los consumidores
-    pthread_mutex_unlock(&mutexConsum);
+    // Lo ocurrido dentro de las regiones críticas se registra una vez liberadas
+    if(esperas > 0){
+      registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                "[!] La cola estaba vacía. Me he dormido %d veces\n", esperas,
+                0, 0, 0);
+    }
+    if(n == 1){
+      registrar(hilo->registro, REGISTRO_DETALLE, tgreen,
+                "[Nª: %d] He sacado el valor: %d\n", i, items[0], 0, 0);
+    } else {
+      registrar(hilo->registro, REGISTRO_DETALLE, tgreen,
+                "[Nª: %d] He sacado %d valores\n", i, n, 0, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tyellow,
+              "[i] Elementos en el buffer: %d / %d\n", elementos,
+              tamano(&fragmento->buffer), 0, 0);
+    if(desperto){
+      registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+                "[!] Despertando al productor...\n", 0, 0, 0, 0);
+    }
+    registrar(hilo->registro, REGISTRO_DETALLE, tcyan,
+              "[i] Región crítica de consumidores liberada\n", 0, 0, 0, 0);
+
+    // Se consumen los items fuera de la región crítica, tardando el tiempo de
+    // consumición indicado
+    for(j = 0; j < n; j++){
+      inicioFase = iniciarFase();
+      hilo->consumir(hilo, items[j]);
+      finalizarFase(&hilo->fases[FASE_TRABAJO], inicioFase);
+    }
 
-    imprimirCabeceraConsum(*hilo, tcyan);
-    printf("[i] Región crítica de consumidores liberada\n%s", reset);
+    if(n == 1){
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[Nª: %d] He consumido el valor: %d\n", i, items[0], 0, 0);
+    } else {
+      registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+                "[Nª: %d] He consumido %d valores\n", i, n, 0, 0);
+    }
 
     // Se realiza una espera de post consumición antes de volver a pedir la
     // región crítica.
@@ -512,39 +1363,220 @@ void consumidor(HiloConsumidor* hilo){
       hilo->postConsumicion = rand()%5;
     }
 
-    imprimirCabeceraConsum(*hilo, tpurple);
-    printf("[*] Realizando espera post consumición de %d segundos\n%s",
-            hilo->postConsumicion, reset);
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post consumición de %d ms\n",
+              (int)(hilo->postConsumicion * 1000), 0, 0, 0);
 
-    if(hilo->postConsumicion > 0)
-      sleep(hilo->postConsumicion);
+    dormir(hilo->postConsumicion);
 
     // Se incrementa el número de consumiciones
-    i++;
+    i += n;
   }
 }
 
-int producir(){
+void productorSPSC(HiloProductor* hilo){
+  int i;
+  int item;
+  unsigned int intentos;
+  uint64_t inicioFase;
+
+  hilo->registro = crearColaRegistro('P', hilo->id);
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, reset,
+            "[i] Soy el productor número %d (buffer SPSC)\n", hilo->id, 0, 0,
+            0);
+
+  for(i = 0; i < hilo->numProducciones; i++){
+    // Se produce el item. Al no existir región crítica, el tiempo de
+    // producción no bloquea al consumidor
+    inicioFase = iniciarFase();
+    item = hilo->producir(hilo);
+    finalizarFase(&hilo->fases[FASE_TRABAJO], inicioFase);
+
+    // Mientras la cola esté llena se espera a que el consumidor saque algún
+    // elemento
+    intentos = 0;
+    while(!insertarBufferSPSC(&bufferSPSC, item)){
+      if(intentos == 0){
+        registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                  "[!] La cola está llena. Esperando...\n", 0, 0, 0, 0);
+      }
+      esperarSPSC(&intentos);
+    }
+
+    registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+              "[%d / %d] He fabricado el valor: %d (elementos: %d)\n", i+1,
+              hilo->numProducciones, item, numElementosSPSC(&bufferSPSC));
+
+    if(hilo->postProduccion < 0){
+      hilo->postProduccion = rand()%5;
+    }
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post producción de %d ms\n",
+              (int)(hilo->postProduccion * 1000), 0, 0, 0);
+
+    dormir(hilo->postProduccion);
+  }
+
+  // Al ser el único productor, cierra el buffer de su fragmento. El cierre se
+  // publica después de la última inserción en el buffer SPSC
+  terminarProductor(&hilo->fragmento->buffer);
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+            "[!] He acabado de producir. Finalizando...\n", 0, 0, 0, 0);
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void consumidorSPSC(HiloConsumidor* hilo){
+  int i;
+  int item;
+  int sacado, cerrado;
+  unsigned int intentos;
+  uint64_t inicioFase;
+
+  hilo->registro = crearColaRegistro('C', hilo->id);
+
+  for(i = 1; ; i++){
+    // Mientras la cola esté vacía se espera a que el productor inserte algún
+    // elemento o cierre el buffer de su fragmento. Tras ver el buffer cerrado
+    // se vuelve a intentar sacar, ya que el productor pudo insertar antes de
+    // cerrarlo: si la cola sigue vacía ya no llegarán más items
+    intentos = 0;
+    cerrado = 0;
+    while(!(sacado = sacarBufferSPSC(&bufferSPSC, &item)) && !cerrado){
+      cerrado = bufferCerrado(&hilo->fragmento->buffer);
+      if(!cerrado){
+        if(intentos == 0){
+          registrar(hilo->registro, REGISTRO_DETALLE, fpurple,
+                    "[!] La cola está vacía. Esperando...\n", 0, 0, 0, 0);
+        }
+        esperarSPSC(&intentos);
+      }
+    }
+    if(!sacado){
+      break;
+    }
+
+    // El item se consume fuera del buffer, sin bloquear al productor
+    inicioFase = iniciarFase();
+    hilo->consumir(hilo, item);
+    finalizarFase(&hilo->fases[FASE_TRABAJO], inicioFase);
+
+    registrar(hilo->registro, REGISTRO_EVENTOS, tgreen,
+              "[Nª: %d] He consumido el valor: %d\n", i, item, 0, 0);
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tyellow,
+              "[i] Elementos en el buffer: %d\n",
+              numElementosSPSC(&bufferSPSC), 0, 0, 0);
+
+    if(hilo->postConsumicion < 0){
+      hilo->postConsumicion = rand()%5;
+    }
+
+    registrar(hilo->registro, REGISTRO_DETALLE, tpurple,
+              "[*] Realizando espera post consumición de %d ms\n",
+              (int)(hilo->postConsumicion * 1000), 0, 0, 0);
+
+    dormir(hilo->postConsumicion);
+  }
+
+  registrar(hilo->registro, REGISTRO_EVENTOS, tred,
+            "[!] No quedan producciones. Finalizando...\n", 0, 0, 0, 0);
+
+  pthread_exit(EXIT_SUCCESS);
+}
+
+void esperarSPSC(unsigned int* intentos){
+  if(*intentos < INTENTOS_SPSC){
+    // Mientras el número de intentos sea bajo se cede la CPU, ya que es probable
+    // que el otro hilo cambie el estado del buffer en muy poco tiempo
+    sched_yield();
+    (*intentos)++;
+  } else {
+    usleep(ESPERA_SPSC);
+  }
+}
+
+uint64_t iniciarFase(){
+  return medir ? instanteMonotono() : 0;
+}
+
+void finalizarFase(Histograma* fase, uint64_t inicio){
+  if(medir){
+    registrarHistograma(fase, instanteMonotono() - inicio);
+  }
+}
+
+void imprimirFases(HiloProductor* productores, unsigned int numProductores,
+                   HiloConsumidor* consumidores, unsigned int numConsumidores){
+  Histograma total;
+  int i, j;
+
+  printf("[i] Duración de las fases de los productores (ns)\n");
+  for(j = 0; j < NUM_FASES; j++){
+    // Se combinan los histogramas de la fase de todos los productores
+    iniciarHistograma(&total);
+    for(i = 0; i < numProductores; i++){
+      combinarHistograma(&total, &productores[i].fases[j]);
+    }
+    imprimirHistograma(stdout, nombresFases[j], &total);
+  }
+
+  printf("[i] Duración de las fases de los consumidores (ns)\n");
+  for(j = 0; j < NUM_FASES; j++){
+    iniciarHistograma(&total);
+    for(i = 0; i < numConsumidores; i++){
+      combinarHistograma(&total, &consumidores[i].fases[j]);
+    }
+    imprimirHistograma(stdout, nombresFases[j], &total);
+  }
+}
+
+int producir(HiloProductor* hilo){
+  dormir(hilo->tiempo);
+
   return rand()%10;
 }
 
-void calcularHora(char* hora){
-  time_t t;
-  struct tm *tim;
+void consumir(HiloConsumidor* hilo, int item){
+  dormir(hilo->tiempo);
+}
+
+void preguntar(Configuracion* configuracion, const char* pregunta,
+               const char* clave){
+  char respuesta[64];
+
+  do{
+    printf("%s", pregunta);
+    fflush(stdout);
+    if(scanf("%63s", respuesta) != 1){
+      fprintf(stderr, "\n[!] No se ha indicado el parámetro '%s'\n", clave);
+      exit(EXIT_FAILURE);
+    }
+  } while(asignarConfiguracion(configuracion, clave, respuesta) != 0);
+}
+
+void dormir(double segundos){
+  struct timespec espera;
+
+  if(segundos <= 0){
+    return;
+  }
+
+  espera.tv_sec = (time_t) segundos;
+  espera.tv_nsec = (long)((segundos - espera.tv_sec) * 1e9);
 
-  t = time(NULL);
-  tim = localtime(&t);
-  strftime(hora, TAM_HORA, "%H:%M:%S", tim);
+  // Si una señal interrumpe la espera se continúa con el tiempo restante
+  while(nanosleep(&espera, &espera) == -1 && errno == EINTR);
 }
 
-void imprimirCabeceraProduc(HiloProductor hilo, char* color){
-  char hora[TAM_HORA];
-  calcularHora(hora);
-  printf("%s{P: %d}(%s) │ ", color, hilo.id, hora);
+int hayHueco(const void* buffer){
+  return numElementos((const Buffer*) buffer) < tamano((const Buffer*) buffer);
 }
 
-void imprimirCabeceraConsum(HiloConsumidor hilo, char* color){
-  char hora[TAM_HORA];
-  calcularHora(hora);
-  printf("%s{C: %d}(%s) │ ", color, hilo.id, hora);
+int hayElementos(const void* buffer){
+  return numElementos((const Buffer*) buffer) > 0 ||
+         bufferCerrado((const Buffer*) buffer);
 }
@@ -0,0 +1,169 @@
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*
+* -----------------------------DESCRIPCIÓN DEL TAD-----------------------------
+* El TAD Registro permite a los hilos informar de lo que están haciendo sin
+* escribir directamente por pantalla. Cada hilo dispone de su propia cola de
+* registro, sin mutexes, en la que escribe mensajes de tamaño fijo formados por
+* un formato de printf y sus argumentos enteros. Un hilo registrador dedicado
+* vacía periódicamente todas las colas, da formato a los mensajes y los escribe
+* en bloque en la salida indicada.
+*
+* Cuando hay muchas más tareas que hilos (por ejemplo, fibras ejecutadas por
+* unos pocos hilos trabajadores) cada tarea puede usar una cola compartida, que
+* no tiene anillo propio: sus mensajes se escriben en el anillo del hilo que
+* la esté ejecutando en ese momento, creado la primera vez que lo necesita.
+*
+* De esta forma el coste de dar formato a los mensajes, obtener la hora y
+* escribir en la salida (con su mutex interno) no recae sobre los hilos, y en
+* ningún caso se realiza dentro de sus regiones críticas.
+*/
+
+// Niveles de registro. Un mensaje se registra si su nivel es menor o igual que
+// el nivel indicado al iniciar el registro
+#define REGISTRO_DESACTIVADO 0
+#define REGISTRO_EVENTOS 1
+#define REGISTRO_DETALLE 2
+
+// Número máximo de argumentos enteros de un mensaje
+#define REGISTRO_MAX_ARGS 4
+
+// Número de mensajes que caben en la cola de cada hilo. Debe ser potencia de 2
+#define REGISTRO_TAM_COLA 1024
+
+/*
+* ------------------------------ESTRUCTURA DEL TAD------------------------------
+* Tipo de dato exportado: una estructura tipo ST_MENSAJE
+* Mensaje de tamaño fijo escrito por un hilo en su anillo de registro.
+* Campos:
+*		- instante: nanosegundos desde el 1 de enero de 1970 en el momento de
+*								registrar el mensaje
+*		- color: secuencia de escape con el color del mensaje
+*		- formato: formato de printf del mensaje. Debe ser una cadena constante,
+*							 ya que se utiliza después de que el hilo haya continuado
+*		- args: argumentos enteros del formato
+*		- tipo: carácter que identifica el tipo de hilo en la cabecera ('P' o 'C')
+*		- id: identificador del hilo en la cabecera
+*/
+typedef struct ST_MENSAJE{
+	uint64_t instante;
+	const char* color;
+	const char* formato;
+	int args[REGISTRO_MAX_ARGS];
+	char tipo;
+	int id;
+} Mensaje;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_ANILLOREGISTRO
+* Cola circular de mensajes con un único escritor (el hilo al que pertenece) y
+* un único lector (el hilo registrador).
+* Campos:
+*		- mensajes: mensajes del anillo
+*		- inicio: número de mensajes leídos por el registrador
+*		- final: número de mensajes escritos por el hilo
+*		- siguiente: siguiente anillo de la lista de anillos del registrador
+*/
+typedef struct ST_ANILLOREGISTRO{
+	Mensaje mensajes[REGISTRO_TAM_COLA];
+	_Atomic uint64_t inicio;
+	_Atomic uint64_t final;
+	struct ST_ANILLOREGISTRO* siguiente;
+} AnilloRegistro;
+
+/*
+* Tipo de dato exportado: una estructura tipo ST_COLAREGISTRO
+* Identificación con la que una tarea registra sus mensajes.
+* Campos:
+*		- tipo: carácter que identifica el tipo de hilo en la cabecera ('P' o 'C')
+*		- id: identificador del hilo en la cabecera
+*		- anillo: anillo propio de la cola, o NULL si es una cola compartida que
+*							escribe en el anillo del hilo que la ejecuta
+*		- siguiente: siguiente cola de la lista de colas del registro
+*/
+typedef struct ST_COLAREGISTRO{
+	char tipo;
+	int id;
+	AnilloRegistro* anillo;
+	struct ST_COLAREGISTRO* siguiente;
+} ColaRegistro;
+
+/*
+* ----------------------------FUNCIONES DEL TAD---------------------------------
+*/
+
+/*
+* Nombre: iniciarRegistro
+* Tipo: constructor
+* Función que establece el nivel de registro y, si no está desactivado, crea
+* el hilo registrador que escribirá los mensajes en la salida indicada.
+*
+* Precondición : nivel entre REGISTRO_DESACTIVADO y REGISTRO_DETALLE
+* Postcondición: los hilos pueden crear sus colas y registrar mensajes
+*/
+void iniciarRegistro(int nivel, FILE* salida);
+
+/*
+* Nombre: finalizarRegistro
+* Tipo: destructor
+* Función que espera a que el registrador escriba todos los mensajes
+* pendientes, lo finaliza y destruye las colas y los anillos de los hilos.
+*
+* Precondición : el registro debe haber sido iniciado con 'iniciarRegistro' y
+*								 los hilos que registran mensajes deben haber finalizado
+* Postcondición: se liberan todos los recursos del registro
+*/
+void finalizarRegistro();
+
+/*
+* Nombre: crearColaRegistro
+* Tipo: constructor
+* Función que crea la cola de registro de un hilo, con su propio anillo, y
+* añade el anillo a los que vacía el registrador. Se debe llamar desde el propio hilo, fuera de cualquier
+* región crítica.
+*
+* Precondición : el registro debe haber sido iniciado con 'iniciarRegistro'
+* Postcondición: se devuelve la cola del hilo, o NULL si el registro está
+*								 desactivado
+*/
+ColaRegistro* crearColaRegistro(char tipo, int id);
+
+/*
+* Nombre: crearColaRegistroCompartida
+* Tipo: constructor
+* Función que crea una cola de registro sin anillo propio para una tarea que
+* puede ejecutarse en distintos hilos. Cada mensaje se escribe en el anillo
+* del hilo que llama a 'registrar', por lo que la tarea no debe cambiar de
+* hilo durante la llamada.
+*
+* Precondición : el registro debe haber sido iniciado con 'iniciarRegistro'
+* Postcondición: se devuelve la cola de la tarea, o NULL si el registro está
+*								 desactivado
+*/
+ColaRegistro* crearColaRegistroCompartida(char tipo, int id);
+
+/*
+* Nombre: registrar
+* Tipo: modificador
+* Función que escribe un mensaje en el anillo de la cola (o, si es compartida,
+* en el del hilo que la llama) si su nivel está activado.
+* No utiliza mutexes: si el anillo está lleno el hilo cede la CPU hasta que el
+* registrador lo vacíe, por lo que nunca se debe llamar dentro de una región
+* crítica.
+*
+* Los argumentos no utilizados por el formato se ignoran.
+*
+* Precondición : cola creada con 'crearColaRegistro' o
+*								 'crearColaRegistroCompartida' (o NULL) y formato
+*								 constante
+* Postcondición: el mensaje queda pendiente de ser escrito por el registrador
+*/
+void registrar(ColaRegistro* cola, int nivel, const char* color,
+		const char* formato, int a, int b, int c, int d);
+
+#endif